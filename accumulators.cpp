@@ -0,0 +1,332 @@
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+#include <math.h>
+#include "accumulators.h"
+#include "calculate.h"
+
+#include <algorithm>
+
+namespace Calculate
+{
+    void MomentAccumulator::add(double x)
+    {
+        const double n1 = static_cast<double>(count);
+        count++;
+        const double n = static_cast<double>(count);
+
+        const double delta = x - mean;
+        const double deltaN = delta / n;
+        const double deltaN2 = deltaN * deltaN;
+        const double term1 = delta * deltaN * n1;
+
+        mean += deltaN;
+        m4 += term1 * deltaN2 * (n * n - 3 * n + 3) + 6 * deltaN2 * m2 - 4 * deltaN * m3;
+        m3 += term1 * deltaN * (n - 2) - 3 * deltaN * m2;
+        m2 += term1;
+
+        // Суммирование Ноймайера
+        const double t = sum + x;
+        sumCompensation += std::abs(sum) >= std::abs(x) ? (sum - t) + x : (x - t) + sum;
+        sum = t;
+
+        if (x > 0) logSum += std::log(x);
+        else allPositive = false;
+        if (x < std::numeric_limits<double>::epsilon()) reciprocalSafe = false;
+        else reciprocalSum += 1.0 / x;
+
+        min = std::min(min, x);
+        max = std::max(max, x);
+    }
+
+    void MomentAccumulator::merge(const MomentAccumulator& other)
+    {
+        if (other.count == 0) return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+
+        const double na = static_cast<double>(count);
+        const double nb = static_cast<double>(other.count);
+        const double n = na + nb;
+        const double delta = other.mean - mean;
+        const double delta2 = delta * delta;
+        const double delta3 = delta2 * delta;
+        const double delta4 = delta2 * delta2;
+
+        const double mergedM2 = m2 + other.m2 + delta2 * na * nb / n;
+        const double mergedM3 = m3 + other.m3 + delta3 * na * nb * (na - nb) / (n * n)
+                                + 3.0 * delta * (na * other.m2 - nb * m2) / n;
+        const double mergedM4 = m4 + other.m4 + delta4 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n)
+                                + 6.0 * delta2 * (na * na * other.m2 + nb * nb * m2) / (n * n)
+                                + 4.0 * delta * (na * other.m3 - nb * m3) / n;
+
+        mean += delta * nb / n;
+        m2 = mergedM2;
+        m3 = mergedM3;
+        m4 = mergedM4;
+        count += other.count;
+
+        for (double part : {other.sum, other.sumCompensation}) {
+            const double t = sum + part;
+            sumCompensation += std::abs(sum) >= std::abs(part) ? (sum - t) + part : (part - t) + sum;
+            sum = t;
+        }
+
+        logSum += other.logSum;
+        reciprocalSum += other.reciprocalSum;
+        allPositive = allPositive && other.allPositive;
+        reciprocalSafe = reciprocalSafe && other.reciprocalSafe;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    double MomentAccumulator::standardDeviation() const
+    {
+        if (count < 2 || m2 < 0.0)
+            return std::numeric_limits<double>::quiet_NaN();
+        return std::sqrt(m2 / static_cast<double>(count - 1));
+    }
+
+    double MomentAccumulator::skewness() const
+    {
+        const double stdDev = standardDeviation();
+        if (count < 3 || stdDev == 0 || std::isnan(stdDev))
+            return std::numeric_limits<double>::quiet_NaN();
+
+        const double n = static_cast<double>(count);
+        const double factor = n / ((n - 1) * (n - 2));
+        return factor * (m3 / std::pow(stdDev, 3));
+    }
+
+    double MomentAccumulator::kurtosis() const
+    {
+        const double stdDev = standardDeviation();
+        if (count < 4 || std::isnan(stdDev) || std::abs(stdDev) < std::numeric_limits<double>::epsilon())
+            return std::numeric_limits<double>::quiet_NaN();
+
+        const long double n = static_cast<long double>(count);
+        const long double stdDevPow4 = std::pow(static_cast<long double>(stdDev), 4.0L);
+        const long double term1 = (n * (n + 1.0L)) / ((n - 1.0L) * (n - 2.0L) * (n - 3.0L));
+        const long double term2 = m4 / stdDevPow4;
+        const long double term3 = (3.0L * (n - 1.0L) * (n - 1.0L)) / ((n - 2.0L) * (n - 3.0L));
+        const long double kurt = term1 * term2 - term3;
+        return std::isfinite(kurt) ? static_cast<double>(kurt) : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double MomentAccumulator::geometricMean() const
+    {
+        if (count == 0 || !allPositive)
+            return std::numeric_limits<double>::quiet_NaN();
+        const double result = std::exp(logSum / static_cast<double>(count));
+        return std::isfinite(result) ? result : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double MomentAccumulator::harmonicMean() const
+    {
+        if (count == 0 || !allPositive || !reciprocalSafe || !std::isfinite(reciprocalSum))
+            return std::numeric_limits<double>::quiet_NaN();
+        return static_cast<double>(count) / reciprocalSum;
+    }
+
+    double MomentAccumulator::rootMeanSquare() const
+    {
+        if (count == 0)
+            return std::numeric_limits<double>::quiet_NaN();
+        return std::sqrt(mean * mean + m2 / static_cast<double>(count));
+    }
+
+    void QuantileSketch::add(double x)
+    {
+        if (m_levels.empty()) m_levels.emplace_back();
+        m_levels[0].push_back(x);
+        m_count++;
+        if (m_levels[0].size() >= static_cast<size_t>(m_capacity)) compact(0);
+    }
+
+    void QuantileSketch::compact(size_t level)
+    {
+        if (m_levels.size() <= level + 1) m_levels.emplace_back();
+        if (m_takeOdd.size() < m_levels.size()) m_takeOdd.resize(m_levels.size(), false);
+
+        std::vector<double>& items = m_levels[level];
+        std::sort(items.begin(), items.end());
+
+        // При нечётном количестве наибольшее значение остаётся на уровне, чтобы не терять вес
+        double kept = 0.0;
+        const bool keepLast = items.size() % 2 == 1;
+        if (keepLast) {
+            kept = items.back();
+            items.pop_back();
+        }
+
+        const size_t offset = m_takeOdd[level] ? 1 : 0;
+        m_takeOdd[level] = !m_takeOdd[level];
+        std::vector<double>& next = m_levels[level + 1];
+        for (size_t i = offset; i < items.size(); i += 2) {
+            next.push_back(items[i]);
+        }
+
+        items.clear();
+        if (keepLast) items.push_back(kept);
+
+        if (m_levels[level + 1].size() >= static_cast<size_t>(m_capacity)) compact(level + 1);
+    }
+
+    void QuantileSketch::restore(std::uint64_t count, std::vector<std::vector<double>> levels)
+    {
+        m_count = count;
+        m_levels = std::move(levels);
+        m_takeOdd.assign(m_levels.size(), false);
+    }
+
+    std::vector<QuantileSketch::WeightedValue> QuantileSketch::sortedView() const
+    {
+        std::vector<WeightedValue> view;
+        for (size_t level = 0; level < m_levels.size(); ++level) {
+            const std::uint64_t weight = std::uint64_t(1) << level;
+            for (double v : m_levels[level]) view.emplace_back(v, weight);
+        }
+        std::sort(view.begin(), view.end(), [](const WeightedValue& a, const WeightedValue& b) {
+            return a.first < b.first;
+        });
+        return view;
+    }
+
+    namespace
+    {
+        double totalWeight(const std::vector<QuantileSketch::WeightedValue>& view)
+        {
+            double total = 0.0;
+            for (const auto& [value, weight] : view) total += static_cast<double>(weight);
+            return total;
+        }
+
+        double normalCdf(double x, double mean, double stdDev)
+        {
+            return 0.5 * (1 + std::erf((x - mean) / (stdDev * M_SQRT2)));
+        }
+    }
+
+    double sketchQuantile(const std::vector<QuantileSketch::WeightedValue>& view, double q)
+    {
+        if (view.empty())
+            return std::numeric_limits<double>::quiet_NaN();
+
+        const double target = std::clamp(q, 0.0, 1.0) * totalWeight(view);
+        double cumulative = 0.0;
+        for (const auto& [value, weight] : view) {
+            cumulative += static_cast<double>(weight);
+            if (cumulative >= target) return value;
+        }
+        return view.back().first;
+    }
+
+    double sketchTrimmedMean(const std::vector<QuantileSketch::WeightedValue>& view, double trimFraction)
+    {
+        if (view.empty() || trimFraction < 0 || trimFraction >= 0.5)
+            return std::numeric_limits<double>::quiet_NaN();
+
+        const double total = totalWeight(view);
+        const double lower = total * trimFraction;
+        const double upper = total - lower;
+
+        double cumulative = 0.0, sum = 0.0, used = 0.0;
+        for (const auto& [value, weight] : view) {
+            const double overlap = std::min(cumulative + weight, upper) - std::max(cumulative, lower);
+            if (overlap > 0) {
+                sum += value * overlap;
+                used += overlap;
+            }
+            cumulative += static_cast<double>(weight);
+        }
+        return used > 0 ? sum / used : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double sketchMedianAbsoluteDeviation(const std::vector<QuantileSketch::WeightedValue>& view)
+    {
+        const double median = sketchQuantile(view, 0.5);
+        if (std::isnan(median))
+            return median;
+
+        std::vector<QuantileSketch::WeightedValue> deviations;
+        deviations.reserve(view.size());
+        for (const auto& [value, weight] : view) deviations.emplace_back(std::abs(value - median), weight);
+        std::sort(deviations.begin(), deviations.end());
+        return sketchQuantile(deviations, 0.5);
+    }
+
+    double sketchDensity(const std::vector<QuantileSketch::WeightedValue>& view, double point)
+    {
+        if (view.empty() || KDE_BANDWIDTH < KDE_EPSILON)
+            return std::numeric_limits<double>::quiet_NaN();
+
+        const double h = KDE_BANDWIDTH;
+        double sum = 0.0;
+        for (const auto& [value, weight] : view) {
+            const double u = (point - value) / h;
+            sum += weight * std::exp(-0.5 * u * u) / std::sqrt(2 * M_PI);
+        }
+        return sum / (totalWeight(view) * h);
+    }
+
+    double sketchChiSquareTest(const std::vector<QuantileSketch::WeightedValue>& view, double mean, double stdDev)
+    {
+        const double total = totalWeight(view);
+        if (total < MIN_SAMPLE_SIZE || !(stdDev >= std::numeric_limits<double>::epsilon()))
+            return std::numeric_limits<double>::quiet_NaN();
+
+        const std::vector<double> edges = chiSquareBinEdges(mean, stdDev);
+        std::vector<double> observed(edges.size() - 1, 0.0);
+        for (const auto& [value, weight] : view) {
+            auto it = std::upper_bound(edges.begin(), edges.end(), value);
+            const int bin = std::clamp(static_cast<int>(std::distance(edges.begin(), it)) - 1,
+                                       0, static_cast<int>(observed.size()) - 1);
+            observed[bin] += static_cast<double>(weight);
+        }
+        return chiSquareFromBins(observed, edges, mean, stdDev, total);
+    }
+
+    double sketchKolmogorovSmirnovTest(const std::vector<QuantileSketch::WeightedValue>& view, double mean, double stdDev)
+    {
+        const double n = totalWeight(view);
+        if (n < KS_MIN_SAMPLE_SIZE || !(stdDev >= std::numeric_limits<double>::epsilon()))
+            return std::numeric_limits<double>::quiet_NaN();
+
+        double D = 0.0;
+        double cumulative = 0.0;
+        for (size_t i = 0; i < view.size(); ++i) {
+            const double before = cumulative;
+            cumulative += static_cast<double>(view[i].second);
+
+            D = std::max(D, std::abs(cumulative / n - normalCdf(view[i].first, mean, stdDev)));
+            if (i > 0) {
+                D = std::max(D, std::abs(before / n - normalCdf(view[i - 1].first, mean, stdDev)));
+            }
+        }
+        return D;
+    }
+
+    void SeriesSummary::add(double x)
+    {
+        moments.add(x);
+        sketch.add(x);
+
+        if (m_exactOverflow) return;
+        if (m_exact.size() < static_cast<size_t>(MAX_SAMPLE_SIZE)) {
+            m_exact.push_back(x);
+        } else {
+            m_exactOverflow = true;
+            std::vector<double>().swap(m_exact);
+        }
+    }
+
+    void SeriesSummary::clear()
+    {
+        moments = MomentAccumulator();
+        sketch = QuantileSketch(sketch.capacity());
+        m_exact.clear();
+        m_exactOverflow = false;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef ACCUMULATORS_H
+#define ACCUMULATORS_H
+
+#include "globals.h"
+
+#include <cstdint>
+#include <limits>
+#include <cmath>
+#include <vector>
+#include <utility>
+
+namespace Calculate
+{
+    // Однопроходное накопление моментов (формулы Пебэя), совместимое с getMean,
+    // getStandardDeviation, skewness и kurtosis; поддерживает слияние частичных результатов.
+    struct MomentAccumulator
+    {
+        std::uint64_t count = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+        double m3 = 0.0;
+        double m4 = 0.0;
+        double sum = 0.0;
+        double sumCompensation = 0.0;    // Компенсация Ноймайера для суммы
+        double logSum = 0.0;             // Для геометрического среднего
+        double reciprocalSum = 0.0;      // Для гармонического среднего
+        bool allPositive = true;         // Все значения > 0
+        bool reciprocalSafe = true;      // Нет значений ближе к нулю, чем epsilon
+        double min = std::numeric_limits<double>::infinity();
+        double max = -std::numeric_limits<double>::infinity();
+
+        void add(double x);
+        void merge(const MomentAccumulator& other);
+
+        double total() const { return sum + sumCompensation; }
+        double standardDeviation() const;
+        double skewness() const;
+        double kurtosis() const;
+        double geometricMean() const;
+        double harmonicMean() const;
+        double rootMeanSquare() const;
+    };
+
+    // Квантильный скетч в духе KLL: уровни по k значений, уровень h хранит значения с весом 2^h.
+    // Пока значений не больше k, скетч точен; память растёт как k * log2(n / k).
+    class QuantileSketch
+    {
+    public:
+        using WeightedValue = std::pair<double, std::uint64_t>;
+
+        explicit QuantileSketch(int capacity = sketchCapacity) : m_capacity(capacity) {}
+
+        void add(double x);
+        std::uint64_t count() const { return m_count; }
+        int capacity() const { return m_capacity; }
+        const std::vector<std::vector<double>>& levels() const { return m_levels; }
+        void restore(std::uint64_t count, std::vector<std::vector<double>> levels);
+
+        // Отсортированные значения с весами; строится один раз на серию запросов
+        std::vector<WeightedValue> sortedView() const;
+
+    private:
+        void compact(size_t level);
+
+        int m_capacity;
+        std::uint64_t m_count = 0;
+        std::vector<std::vector<double>> m_levels;
+        std::vector<bool> m_takeOdd; // Чередование смещения при сжатии уровня
+    };
+
+    // Приближённые метрики по отсортированному виду скетча
+    double sketchQuantile(const std::vector<QuantileSketch::WeightedValue>& view, double q);
+    double sketchTrimmedMean(const std::vector<QuantileSketch::WeightedValue>& view, double trimFraction);
+    double sketchMedianAbsoluteDeviation(const std::vector<QuantileSketch::WeightedValue>& view);
+    double sketchDensity(const std::vector<QuantileSketch::WeightedValue>& view, double point);
+    double sketchChiSquareTest(const std::vector<QuantileSketch::WeightedValue>& view, double mean, double stdDev);
+    double sketchKolmogorovSmirnovTest(const std::vector<QuantileSketch::WeightedValue>& view, double mean, double stdDev);
+
+    // Сводка ряда ограниченного размера: моменты, скетч и точная копия значений,
+    // пока их не больше MAX_SAMPLE_SIZE (тогда все метрики считаются точно).
+    class SeriesSummary
+    {
+    public:
+        void add(double x);
+        void clear();
+        bool isExact() const { return !m_exactOverflow; }
+        const std::vector<double>& exactValues() const { return m_exact; }
+
+        MomentAccumulator moments;
+        QuantileSketch sketch;
+
+    private:
+        std::vector<double> m_exact;
+        bool m_exactOverflow = false;
+    };
+}
+
+#endif // ACCUMULATORS_H
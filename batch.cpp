@@ -0,0 +1,412 @@
+#include "batch.h"
+#include "summary.h"
+#include "export.h"
+#include "workspace.h"
+#include "compression.h"
+#include "plotWidget.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QImage>
+#include <QPainter>
+#include <QSvgGenerator>
+#include <QTextStream>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace Batch
+{
+    namespace
+    {
+        // Минимумы и максимумы ряда по группам соседних столбцов. Когда столбцов больше, чем групп,
+        // группы сливаются попарно: память на ряд ограничена шириной графика, а не длиной ряда.
+        class ColumnBins
+        {
+        public:
+            explicit ColumnBins(int capacity = 2) : m_capacity(qMax(capacity, 2)) {}
+
+            void add(int column, double value)
+            {
+                while (column / m_columnsPerBin >= m_capacity) halve();
+
+                const size_t index = static_cast<size_t>(column / m_columnsPerBin);
+                if (index >= m_bins.size()) m_bins.resize(index + 1);
+                merge(m_bins[index], {value, value, column, column, true});
+                m_lastColumn = qMax(m_lastColumn, column);
+            }
+
+            int lastColumn() const { return m_lastColumn; }
+
+            // По две точки на группу (минимум и максимум) в порядке столбцов
+            QList<QPointF> points() const
+            {
+                QList<QPointF> result;
+                for (const Bin& bin : m_bins) {
+                    if (!bin.used) continue;
+                    const bool minFirst = bin.minColumn <= bin.maxColumn;
+                    result.append(minFirst ? QPointF(bin.minColumn, bin.min) : QPointF(bin.maxColumn, bin.max));
+                    if (bin.minColumn != bin.maxColumn) {
+                        result.append(minFirst ? QPointF(bin.maxColumn, bin.max) : QPointF(bin.minColumn, bin.min));
+                    }
+                }
+                return result;
+            }
+
+            bool bounds(double& minY, double& maxY) const
+            {
+                bool found = false;
+                for (const Bin& bin : m_bins) {
+                    if (!bin.used) continue;
+                    minY = std::min(minY, bin.min);
+                    maxY = std::max(maxY, bin.max);
+                    found = true;
+                }
+                return found;
+            }
+
+        private:
+            struct Bin {
+                double min = 0.0;
+                double max = 0.0;
+                int minColumn = 0;
+                int maxColumn = 0;
+                bool used = false;
+            };
+
+            static void merge(Bin& target, const Bin& source)
+            {
+                if (!source.used) return;
+                if (!target.used) {
+                    target = source;
+                    return;
+                }
+                if (source.min < target.min) {
+                    target.min = source.min;
+                    target.minColumn = source.minColumn;
+                }
+                if (source.max > target.max) {
+                    target.max = source.max;
+                    target.maxColumn = source.maxColumn;
+                }
+            }
+
+            void halve()
+            {
+                std::vector<Bin> merged((m_bins.size() + 1) / 2);
+                for (size_t i = 0; i < m_bins.size(); ++i) {
+                    merge(merged[i / 2], m_bins[i]);
+                }
+                m_bins.swap(merged);
+                m_columnsPerBin *= 2;
+            }
+
+            int m_capacity;
+            int m_columnsPerBin = 1;
+            int m_lastColumn = -1;
+            std::vector<Bin> m_bins;
+        };
+
+        struct FileData {
+            QList<ColumnBins> series;
+            Summary::Result summary;
+            QString xAxisTitle = "Ось X";
+            QString yAxisTitle = "Ось Y";
+        };
+
+        bool readText(const QString& path, int columns, FileData& data, QString* error)
+        {
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly)) {
+                *error = "Не удалось открыть файл.";
+                return false;
+            }
+
+            const Compression::Codec codec = Compression::detectCodec(&file);
+            if (!Compression::isAvailable(codec)) {
+                *error = QString("Поддержка %1 не включена в сборку.").arg(Compression::codecName(codec));
+                return false;
+            }
+            const std::unique_ptr<QIODevice> decoder = Compression::createDecoder(codec, &file);
+            if (codec != Compression::Codec::None && !decoder) {
+                *error = "Не удалось открыть файл.";
+                return false;
+            }
+
+            // Значения строки копятся в группах столбцов, готовый ряд уходит в список вместе с метриками
+            ColumnBins current(columns);
+            Summary::StreamParser parser([&](const Calculate::SeriesSummary& summary) {
+                data.summary.seriesMetrics.append(Export::summaryMetrics(summary));
+                data.series.append(current);
+                current = ColumnBins(columns);
+            });
+            parser.setValueCallback([&current](int column, double value) { current.add(column, value); });
+            QIODevice& input = decoder ? *decoder : static_cast<QIODevice&>(file);
+            if (!Summary::feedParser(input, parser)) {
+                *error = "Ошибка чтения файла: " + input.errorString();
+                return false;
+            }
+
+            data.summary.seriesHeaders = parser.seriesHeaders();
+            if (!parser.invalidLines().isEmpty()) {
+                QStringList lines;
+                for (int line : parser.invalidLines()) lines << QString::number(line);
+                *error = "Найдены буквы в строках: " + lines.join(", ");
+                return false;
+            }
+            return true;
+        }
+
+        bool readWorkspace(const QString& path, int columns, FileData& data, QString* error)
+        {
+            Workspace::MappedWorkspace workspace;
+            if (!workspace.open(path, error)) return false;
+
+            Calculate::SeriesSummary summary;
+            for (int series = 0; series < workspace.seriesCount(); ++series) {
+                ColumnBins bins(columns);
+                summary.clear();
+                const double* values = workspace.values(series);
+                for (int col = 0; col < workspace.columnCount(); ++col) {
+                    if (!workspace.isValid(series, col)) continue;
+                    bins.add(col, values[col]);
+                    summary.add(values[col]);
+                }
+                data.series.append(bins);
+                data.summary.seriesMetrics.append(Export::summaryMetrics(summary));
+            }
+            data.summary.seriesHeaders = workspace.seriesHeaders();
+            data.xAxisTitle = workspace.xAxisTitle();
+            data.yAxisTitle = workspace.yAxisTitle();
+            return true;
+        }
+
+        void paintChart(QPainter& painter, const QRect& bounds, const FileData& data)
+        {
+            painter.fillRect(bounds, Qt::white);
+            const QRect area = PlotPainter::plotArea(bounds);
+
+            // Границы с запасом 10%, как у осей основного окна
+            PlotPainter::Range range;
+            double minY = std::numeric_limits<double>::max();
+            double maxY = std::numeric_limits<double>::lowest();
+            int lastColumn = -1;
+            for (const ColumnBins& bins : data.series) {
+                bins.bounds(minY, maxY);
+                lastColumn = qMax(lastColumn, bins.lastColumn());
+            }
+            if (lastColumn >= 0) {
+                const double xPadding = lastColumn * 0.1;
+                const double yPadding = (maxY - minY) * 0.1;
+                const PlotPainter::AxisScale xScale = PlotPainter::niceScale(-xPadding, lastColumn + xPadding);
+                const PlotPainter::AxisScale yScale = PlotPainter::niceScale(minY - yPadding, maxY + yPadding);
+                range = {xScale.min, xScale.max, yScale.min, yScale.max};
+            }
+
+            PlotPainter::drawAxes(painter, area, range, data.xAxisTitle, data.yAxisTitle);
+
+            QList<QPair<QString, QColor>> legend;
+            painter.save();
+            painter.setClipRect(area);
+            for (int i = 0; i < data.series.size(); ++i) {
+                const QList<QPointF> points = data.series[i].points();
+                if (points.isEmpty()) continue;
+
+                QPolygonF polyline;
+                polyline.reserve(points.size());
+                for (const QPointF& point : points) {
+                    polyline.append(range.toPixel(point, area));
+                }
+                PlotPainter::drawPolyline(painter, polyline, PlotPainter::seriesPen(i), area.width());
+                legend.append({data.summary.seriesHeaders.value(i, QString("Ряд %1").arg(i + 1)),
+                               PlotPainter::seriesColor(i)});
+            }
+            painter.restore();
+            PlotPainter::drawLegend(painter, area, legend);
+        }
+
+        bool renderChart(const QString& path, const Options& options, const FileData& data)
+        {
+            const QRect bounds(QPoint(0, 0), options.size);
+
+            if (options.format == "svg") {
+                QSvgGenerator generator;
+                generator.setFileName(path);
+                generator.setSize(options.size);
+                generator.setViewBox(bounds);
+                generator.setTitle(QFileInfo(path).completeBaseName());
+
+                QPainter painter;
+                if (!painter.begin(&generator)) return false;
+                paintChart(painter, bounds, data);
+                return painter.end();
+            }
+
+            QImage image(options.size, QImage::Format_ARGB32_Premultiplied);
+            QPainter painter(&image);
+            paintChart(painter, bounds, data);
+            painter.end();
+            return image.save(path, "PNG");
+        }
+
+        // Из папки берутся только файлы данных, как в диалоге импорта, и не берутся отчёты прошлых
+        // запусков из папки результатов: иначе повторный запуск с -o . разбирал бы свои же результаты
+        QStringList collectFiles(const QStringList& inputs, const QString& outputDir)
+        {
+            static const QStringList dataFilters = {"*.csv", "*.txt", "*.glws", "*.gz", "*.zst"};
+            const QString outputPath = QFileInfo(outputDir).canonicalFilePath();
+
+            QStringList files;
+            for (const QString& input : inputs) {
+                const QFileInfo info(input);
+                if (info.isDir()) {
+                    const bool isOutputDir = info.canonicalFilePath() == outputPath;
+                    for (const QFileInfo& entry : QDir(input).entryInfoList(dataFilters, QDir::Files, QDir::Name)) {
+                        if (isOutputDir && entry.fileName().endsWith("_report.txt")) continue;
+                        files << entry.filePath();
+                    }
+                } else {
+                    files << input;
+                }
+            }
+            return files;
+        }
+
+        // Имя графика и отчёта без папки и расширения
+        QString outputName(const QString& path)
+        {
+            return QFileInfo(path).completeBaseName();
+        }
+
+        struct Outcome {
+            QString path;
+            QString error;
+            bool ok = false;
+        };
+    }
+
+    bool isRequested(int argc, char* argv[])
+    {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--batch") == 0) return true;
+        }
+        return false;
+    }
+
+    bool parseArguments(const QStringList& arguments, Options& options, QString* error)
+    {
+        QCommandLineParser parser;
+        const QCommandLineOption batchOption("batch", "Пакетный режим без окон.");
+        const QCommandLineOption outputOption({"o", "output"}, "Папка для графиков и отчётов.", "папка", ".");
+        const QCommandLineOption formatOption("format", "Формат графика: png или svg.", "формат", "png");
+        const QCommandLineOption widthOption("width", "Ширина графика в пикселях.", "пиксели", "1600");
+        const QCommandLineOption heightOption("height", "Высота графика в пикселях.", "пиксели", "900");
+        parser.addOptions({batchOption, outputOption, formatOption, widthOption, heightOption});
+        parser.addPositionalArgument("входы", "Файлы данных или папки с ними.", "входы...");
+
+        if (!parser.parse(arguments)) {
+            *error = parser.errorText();
+            return false;
+        }
+
+        options.inputs = parser.positionalArguments();
+        options.outputDir = parser.value(outputOption);
+        options.format = parser.value(formatOption).toLower();
+        bool widthOk = false;
+        bool heightOk = false;
+        options.size = QSize(parser.value(widthOption).toInt(&widthOk), parser.value(heightOption).toInt(&heightOk));
+
+        if (options.inputs.isEmpty()) {
+            *error = "Не указаны входные файлы.";
+        } else if (options.format != "png" && options.format != "svg") {
+            *error = "Формат графика должен быть png или svg.";
+        } else if (!widthOk || !heightOk || options.size.width() < 200 || options.size.height() < 150) {
+            *error = "Размер графика должен быть не меньше 200×150.";
+        }
+        return error->isEmpty();
+    }
+
+    bool processFile(const QString& path, const Options& options, QString* error)
+    {
+        // Групп столбцов столько, сколько пикселей по ширине: больше график всё равно не покажет
+        const int columns = PlotPainter::plotArea(QRect(QPoint(0, 0), options.size)).width();
+
+        FileData data;
+        const bool ok = Workspace::isWorkspaceFile(path) ? readWorkspace(path, columns, data, error)
+                                                         : readText(path, columns, data, error);
+        if (!ok) return false;
+        if (data.series.isEmpty()) {
+            *error = "Файл пуст.";
+            return false;
+        }
+
+        const QString baseName = QDir(options.outputDir).filePath(outputName(path));
+        if (!renderChart(baseName + "." + options.format, options, data)) {
+            *error = "Не удалось записать график.";
+            return false;
+        }
+        if (!Export::writeFileContent(baseName + "_report.txt", data.summary.joinedMetrics(), {},
+                                      data.summary.seriesHeaders)) {
+            *error = "Не удалось записать отчёт.";
+            return false;
+        }
+        return true;
+    }
+
+    int run(const QStringList& arguments)
+    {
+        QTextStream err(stderr);
+        QTextStream out(stdout);
+
+        Options options;
+        QString error;
+        if (!parseArguments(arguments, options, &error)) {
+            err << error << Qt::endl;
+            return 2;
+        }
+        if (!QDir().mkpath(options.outputDir)) {
+            err << "Не удалось создать папку " << options.outputDir << Qt::endl;
+            return 2;
+        }
+
+        const QStringList files = collectFiles(options.inputs, options.outputDir);
+
+        // Одноимённые файлы из разных папок или с разными расширениями записали бы результаты
+        // друг поверх друга; регистр не учитывается ради нечувствительных к нему файловых систем
+        QHash<QString, QStringList> owners;
+        for (const QString& path : files) {
+            owners[outputName(path).toLower()].append(path);
+        }
+
+        // Каждый файл целиком обрабатывается в своём потоке пула
+        const QList<Outcome> outcomes = QtConcurrent::blockingMapped<QList<Outcome>>(
+            files, [&options, &owners](const QString& path) {
+                Outcome outcome;
+                outcome.path = path;
+                const QStringList sameName = owners.value(outputName(path).toLower());
+                if (sameName.size() > 1) {
+                    outcome.error = "Имя результата совпадает у файлов " + sameName.join(", ");
+                } else {
+                    outcome.ok = processFile(path, options, &outcome.error);
+                }
+                return outcome;
+            });
+
+        int failed = 0;
+        for (const Outcome& outcome : outcomes) {
+            if (outcome.ok) {
+                out << "OK " << outcome.path << Qt::endl;
+            } else {
+                err << "Ошибка " << outcome.path << ": " << outcome.error << Qt::endl;
+                ++failed;
+            }
+        }
+        return failed == 0 ? 0 : 1;
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <QString>
+#include <QStringList>
+#include <QSize>
+
+// Пакетный режим без окон: для каждого входного файла строится график (PNG или SVG)
+// и отчёт с метриками рядов. MainWindow и таблица не создаются, файлы обрабатываются параллельно.
+//
+//   StatisticsVisualizer --batch [-o папка] [--format png|svg] [--width N] [--height N] входы...
+namespace Batch
+{
+    struct Options {
+        QStringList inputs;       // Файлы данных и папки с ними
+        QString outputDir = ".";
+        QString format = "png";   // png или svg
+        QSize size = QSize(1600, 900);
+    };
+
+    bool isRequested(int argc, char* argv[]); // Есть ли --batch среди аргументов
+    bool parseArguments(const QStringList& arguments, Options& options, QString* error);
+    bool processFile(const QString& path, const Options& options, QString* error);
+    int run(const QStringList& arguments);    // Код завершения процесса
+}
+
+#endif // BATCH_H
@@ -0,0 +1,452 @@
+// Микробенчмарки функций Calculate: каждая функция на рядах от 10 до 10^8 значений
+// и на нескольких распределениях. Результат — JSON для сравнения ядер между выпусками.
+//
+//   statbench -o bench.json
+//   statbench --max-size 1000000 --filter Median --distributions normal,nan
+
+#include "calculate.h"
+#include "histogram.h"
+#include "globals.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTextStream>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define STATBENCH_HAS_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define STATBENCH_HAS_TSC 1
+#endif
+
+namespace
+{
+    constexpr qsizetype categoryLimit = 1000000; // Категориальные функции разбирают QString: дальше упираются в память
+
+    struct Options {
+        QString output = "-";
+        qsizetype minSize = 10;
+        qsizetype maxSize = 100000000;
+        int warmups = 2;
+        int repetitions = 11;
+        double budgetMs = 2000.0;  // Время на один случай; дольше одного прогона — бо́льшие размеры пропускаются
+        QString filter;
+        QStringList distributions;
+    };
+
+    std::uint64_t readCycles()
+    {
+#ifdef STATBENCH_HAS_TSC
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    // Результат не выбрасывается компилятором вместе с вызовом
+    volatile double sink = 0.0;
+
+    // Ряд одного распределения и размера; производные данные строятся вне замера и только если нужны
+    class Dataset
+    {
+    public:
+        explicit Dataset(std::vector<double> values) : m_values(std::move(values))
+        {
+            m_mean = Calculate::getMean(m_values);
+            m_stdDev = Calculate::getStandardDeviation(m_values, m_mean);
+        }
+
+        const std::vector<double>& values() const { return m_values; }
+        qsizetype size() const { return static_cast<qsizetype>(m_values.size()); }
+        double mean() const { return m_mean; }
+        double stdDev() const { return m_stdDev; }
+
+        // Как Metrics::Inputs: только конечные значения, с NaN порядок не определён
+        const std::vector<double>& sorted()
+        {
+            if (m_sorted.empty()) {
+                m_sorted = Calculate::sortedFinite(m_values);
+            }
+            return m_sorted;
+        }
+
+        const std::vector<double>& weights()
+        {
+            if (m_weights.empty()) {
+                m_weights.resize(m_values.size());
+                for (size_t i = 0; i < m_weights.size(); ++i) m_weights[i] = 1.0 + static_cast<double>(i % 7);
+            }
+            return m_weights;
+        }
+
+        const std::vector<QString>& categories()
+        {
+            if (m_categories.empty()) {
+                m_categories.reserve(m_values.size());
+                for (double value : m_values) m_categories.push_back(QString::number(value, 'g', 6));
+            }
+            return m_categories;
+        }
+
+        const std::map<double, int>& frequencies()
+        {
+            if (m_frequencies.empty()) {
+                for (double value : m_values) {
+                    if (std::isfinite(value)) ++m_frequencies[value];
+                }
+            }
+            return m_frequencies;
+        }
+
+        const std::vector<double>& binEdges()
+        {
+            if (m_binEdges.empty()) m_binEdges = Calculate::chiSquareBinEdges(m_mean, m_stdDev);
+            return m_binEdges;
+        }
+
+        const std::vector<double>& observed()
+        {
+            if (m_observed.empty()) {
+                const std::vector<std::uint64_t> counts = Histogram::count(m_values, binEdges());
+                m_observed.assign(counts.begin(), counts.end());
+            }
+            return m_observed;
+        }
+
+    private:
+        std::vector<double> m_values;
+        double m_mean = 0.0;
+        double m_stdDev = 0.0;
+        std::vector<double> m_sorted;
+        std::vector<double> m_weights;
+        std::vector<QString> m_categories;
+        std::map<double, int> m_frequencies;
+        std::vector<double> m_binEdges;
+        std::vector<double> m_observed;
+    };
+
+    struct Distribution {
+        QString name;
+        std::function<double(std::mt19937_64&)> next;
+    };
+
+    QList<Distribution> distributions()
+    {
+        return {
+            {"uniform", [](std::mt19937_64& rng) { return std::uniform_real_distribution<double>(0.0, 1000.0)(rng); }},
+            {"normal", [](std::mt19937_64& rng) { return std::normal_distribution<double>(100.0, 15.0)(rng); }},
+            // Коши: редкие огромные выбросы
+            {"heavy-tailed", [](std::mt19937_64& rng) { return std::cauchy_distribution<double>(0.0, 1.0)(rng); }},
+            {"integer", [](std::mt19937_64& rng) {
+                 return static_cast<double>(std::uniform_int_distribution<int>(1, 1000)(rng));
+             }},
+            {"duplicates", [](std::mt19937_64& rng) {
+                 return static_cast<double>(std::uniform_int_distribution<int>(0, 9)(rng)) * 2.5;
+             }},
+            // Каждое десятое значение — NaN
+            {"nan", [](std::mt19937_64& rng) {
+                 if (std::uniform_int_distribution<int>(0, 9)(rng) == 0) return std::numeric_limits<double>::quiet_NaN();
+                 return std::normal_distribution<double>(0.0, 1.0)(rng);
+             }},
+        };
+    }
+
+    std::vector<double> generate(const Distribution& distribution, qsizetype size)
+    {
+        // Одно зерно на распределение и размер: прогоны между выпусками сравнимы
+        std::mt19937_64 rng(std::hash<std::string>()(distribution.name.toStdString()) ^ static_cast<std::uint64_t>(size));
+        std::vector<double> values(static_cast<size_t>(size));
+        for (double& value : values) value = distribution.next(rng);
+        return values;
+    }
+
+    struct Kernel {
+        QString name;
+        qsizetype maxSize;                    // 0 — без ограничения; дальше функция не считает или не помещается в память
+        bool sized;                           // false — время не зависит от длины ряда, замер только на первом размере
+        std::function<double(Dataset&)> run;
+        std::function<void(Dataset&)> prepare; // Производные данные до замера
+    };
+
+    QList<Kernel> kernels()
+    {
+        using namespace Calculate;
+        auto none = [](Dataset&) {};
+        auto sorted = [](Dataset& d) { d.sorted(); };
+        auto categories = [](Dataset& d) { d.categories(); };
+        return {
+            {"getSum", 0, true, [](Dataset& d) { return getSum(d.values()); }, none},
+            {"getMean", 0, true, [](Dataset& d) { return getMean(d.values()); }, none},
+            {"getMedian", 0, true, [](Dataset& d) { return getMedian(d.values()); }, none},
+            {"getMode", 0, true, [](Dataset& d) { return getMode(d.values()); }, none},
+            {"getStandardDeviation", 0, true, [](Dataset& d) { return getStandardDeviation(d.values(), d.mean()); }, none},
+            {"geometricMean", 0, true, [](Dataset& d) { return geometricMean(d.values()); }, none},
+            {"harmonicMean", 0, true, [](Dataset& d) { return harmonicMean(d.values()); }, none},
+            {"weightedMean", 0, true, [](Dataset& d) { return weightedMean(d.values(), d.weights()); },
+             [](Dataset& d) { d.weights(); }},
+            {"rootMeanSquare", 0, true, [](Dataset& d) { return rootMeanSquare(d.values()); }, none},
+            {"skewness", 0, true, [](Dataset& d) { return skewness(d.values(), d.mean(), d.stdDev()); }, none},
+            {"kurtosis", 0, true, [](Dataset& d) { return kurtosis(d.values(), d.mean(), d.stdDev()); }, none},
+            {"trimmedMean", 0, true, [](Dataset& d) { return trimmedMean(d.values(), trimmedMeanPercentage); }, none},
+            {"medianAbsoluteDeviation", 0, true, [](Dataset& d) { return medianAbsoluteDeviation(d.values()); }, none},
+            {"robustStandardDeviation", 0, true, [](Dataset& d) { return robustStandardDeviation(d.values()); }, none},
+            {"modalFrequency", categoryLimit, true, [](Dataset& d) { return modalFrequency(d.categories()); }, categories},
+            {"simpsonDiversityIndex", categoryLimit, true, [](Dataset& d) { return simpsonDiversityIndex(d.categories()); }, categories},
+            {"uniqueValueRatio", categoryLimit, true, [](Dataset& d) { return uniqueValueRatio(d.categories()); }, categories},
+            {"entropy", categoryLimit, true, [](Dataset& d) { return entropy(d.categories()); }, categories},
+            {"shapiroWilkTest", MAX_SAMPLE_SIZE, true, [](Dataset& d) { return shapiroWilkTest(d.values()); }, none},
+            {"calculateDensity", 0, true, [](Dataset& d) { return calculateDensity(d.values(), d.mean()); }, none},
+            {"chiSquareTest", 0, true, [](Dataset& d) { return chiSquareTest(d.values()); }, none},
+            {"chiSquareTest(mean, stdDev)", 0, true, [](Dataset& d) { return chiSquareTest(d.values(), d.mean(), d.stdDev()); }, none},
+            {"chiSquareBinEdges", 0, false, [](Dataset& d) { return chiSquareBinEdges(d.mean(), d.stdDev()).back(); }, none},
+            {"chiSquareFromBins", 0, false, [](Dataset& d) {
+                 return chiSquareFromBins(d.observed(), d.binEdges(), d.mean(), d.stdDev(), static_cast<double>(d.size()));
+             }, [](Dataset& d) { d.observed(); }},
+            {"kolmogorovSmirnovTest", 0, true, [](Dataset& d) { return kolmogorovSmirnovTest(d.values()); }, none},
+            {"sortedMedian", 0, true, [](Dataset& d) { return sortedMedian(d.sorted()); }, sorted},
+            {"sortedTrimmedMean", 0, true, [](Dataset& d) { return sortedTrimmedMean(d.sorted(), trimmedMeanPercentage); }, sorted},
+            {"sortedMedianAbsoluteDeviation", 0, true, [](Dataset& d) { return sortedMedianAbsoluteDeviation(d.sorted()); }, sorted},
+            {"sortedShapiroWilkTest", MAX_SAMPLE_SIZE, true, [](Dataset& d) { return sortedShapiroWilkTest(d.sorted()); }, sorted},
+            {"sortedKolmogorovSmirnovTest", 0, true, [](Dataset& d) {
+                 return sortedKolmogorovSmirnovTest(d.sorted(), d.mean(), d.stdDev());
+             }, sorted},
+            {"frequencyMode", 0, true, [](Dataset& d) { return frequencyMode(d.frequencies()); },
+             [](Dataset& d) { d.frequencies(); }},
+        };
+    }
+
+    double percentile(std::vector<double> samples, double p)
+    {
+        std::sort(samples.begin(), samples.end());
+        const size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+        return samples[rank == 0 ? 0 : rank - 1];
+    }
+
+    double median(std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        const size_t mid = samples.size() / 2;
+        return samples.size() % 2 ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2.0;
+    }
+
+    // Прогревы, затем повторы; повторов меньше, если они не укладываются в бюджет, но не меньше трёх
+    QJsonObject measure(const Kernel& kernel, Dataset& data, const Options& options, double& medianNs)
+    {
+        using Clock = std::chrono::steady_clock;
+        auto once = [&](double& cycles) {
+            const std::uint64_t startCycles = readCycles();
+            const Clock::time_point start = Clock::now();
+            sink = sink + kernel.run(data);
+            const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            cycles = static_cast<double>(readCycles() - startCycles);
+            return ns;
+        };
+
+        double cycles = 0.0;
+        double warmupNs = 0.0;
+        for (int i = 0; i < qMax(1, options.warmups); ++i) {
+            warmupNs = once(cycles);
+        }
+        const double budgetNs = options.budgetMs * 1e6;
+        const int repetitions = qBound(3, static_cast<int>(budgetNs / qMax(warmupNs, 1.0)), qMax(3, options.repetitions));
+
+        std::vector<double> times;
+        std::vector<double> cycleCounts;
+        for (int i = 0; i < repetitions; ++i) {
+            times.push_back(once(cycles));
+            cycleCounts.push_back(cycles);
+        }
+
+        medianNs = median(times);
+        const double elements = static_cast<double>(data.size());
+        QJsonObject result;
+        result["status"] = "ok";
+        result["repetitions"] = repetitions;
+        result["minNs"] = *std::min_element(times.begin(), times.end());
+        result["medianNs"] = medianNs;
+        result["p95Ns"] = percentile(times, 0.95);
+        result["nsPerElement"] = kernel.sized ? QJsonValue(medianNs / elements) : QJsonValue();
+#ifdef STATBENCH_HAS_TSC
+        result["cyclesPerElement"] = kernel.sized ? QJsonValue(median(cycleCounts) / elements) : QJsonValue();
+#else
+        result["cyclesPerElement"] = QJsonValue();
+#endif
+        return result;
+    }
+
+    bool parseArguments(const QStringList& arguments, Options& options, QString* error)
+    {
+        QCommandLineParser parser;
+        parser.setApplicationDescription("Микробенчмарки функций Calculate.");
+        parser.addHelpOption();
+        const QCommandLineOption outputOption({"o", "output"}, "Файл JSON с результатами, - для stdout.", "файл", "-");
+        const QCommandLineOption minSizeOption("min-size", "Наименьший размер ряда.", "значений", "10");
+        const QCommandLineOption maxSizeOption("max-size", "Наибольший размер ряда.", "значений", "100000000");
+        const QCommandLineOption warmupsOption("warmups", "Прогревочных прогонов.", "число", "2");
+        const QCommandLineOption repetitionsOption("repetitions", "Замеряемых прогонов.", "число", "11");
+        const QCommandLineOption budgetOption("budget-ms", "Время на один случай, мс.", "мс", "2000");
+        const QCommandLineOption filterOption("filter", "Только функции, в названии которых есть строка.", "строка");
+        const QCommandLineOption distributionsOption("distributions", "Распределения через запятую.", "список");
+        parser.addOptions({outputOption, minSizeOption, maxSizeOption, warmupsOption, repetitionsOption,
+                           budgetOption, filterOption, distributionsOption});
+
+        if (!parser.parse(arguments)) {
+            *error = parser.errorText();
+            return false;
+        }
+        if (parser.isSet("help")) parser.showHelp(0);
+
+        bool ok[5] = {};
+        options.output = parser.value(outputOption);
+        options.minSize = parser.value(minSizeOption).toLongLong(&ok[0]);
+        options.maxSize = parser.value(maxSizeOption).toLongLong(&ok[1]);
+        options.warmups = parser.value(warmupsOption).toInt(&ok[2]);
+        options.repetitions = parser.value(repetitionsOption).toInt(&ok[3]);
+        options.budgetMs = parser.value(budgetOption).toDouble(&ok[4]);
+        options.filter = parser.value(filterOption);
+        if (parser.isSet(distributionsOption)) {
+            options.distributions = parser.value(distributionsOption).split(',', Qt::SkipEmptyParts);
+        }
+
+        if (std::find(std::begin(ok), std::end(ok), false) != std::end(ok)) {
+            *error = "Числовые параметры заданы неверно.";
+        } else if (options.minSize < 1 || options.maxSize < options.minSize) {
+            *error = "Размеры должны удовлетворять 1 ≤ min-size ≤ max-size.";
+        } else if (options.warmups < 0 || options.repetitions < 1 || options.budgetMs <= 0) {
+            *error = "Нужен хотя бы один повтор и положительный бюджет времени.";
+        }
+        return error->isEmpty();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream err(stderr);
+
+    Options options;
+    QString error;
+    if (!parseArguments(app.arguments(), options, &error)) {
+        err << error << Qt::endl;
+        return 2;
+    }
+
+    QList<Distribution> selected;
+    for (const Distribution& distribution : distributions()) {
+        if (options.distributions.isEmpty() || options.distributions.contains(distribution.name)) selected.append(distribution);
+    }
+    QList<Kernel> selectedKernels;
+    for (const Kernel& kernel : kernels()) {
+        if (options.filter.isEmpty() || kernel.name.contains(options.filter, Qt::CaseInsensitive)) selectedKernels.append(kernel);
+    }
+    if (selected.isEmpty() || selectedKernels.isEmpty()) {
+        err << "Ни одно распределение или функция не подходят под фильтр." << Qt::endl;
+        return 2;
+    }
+
+    QJsonArray results;
+    for (const Distribution& distribution : selected) {
+        // Функция, чей прогон превысил бюджет, на бо́льших размерах этого распределения не запускается
+        QList<QString> overBudget;
+        bool first = true;
+        for (qsizetype size = options.minSize; size <= options.maxSize; size = size > options.maxSize / 10 ? options.maxSize + 1 : size * 10) {
+            err << distribution.name << ", " << size << " значений" << Qt::endl;
+            std::unique_ptr<Dataset> data;
+            try {
+                data = std::make_unique<Dataset>(generate(distribution, size));
+            } catch (const std::bad_alloc&) {
+                err << "  Недостаточно памяти, бо́льшие размеры пропущены" << Qt::endl;
+                break;
+            }
+
+            for (const Kernel& kernel : selectedKernels) {
+                if (!kernel.sized && !first) continue;
+
+                QJsonObject result;
+                result["kernel"] = kernel.name;
+                result["distribution"] = distribution.name;
+                result["size"] = static_cast<double>(size);
+
+                double medianNs = 0.0;
+                if (kernel.maxSize > 0 && size > kernel.maxSize) {
+                    result["status"] = "skipped";
+                    result["reason"] = QString("функция ограничена %1 значениями").arg(kernel.maxSize);
+                } else if (overBudget.contains(kernel.name)) {
+                    result["status"] = "skipped";
+                    result["reason"] = "на меньшем размере прогон дольше бюджета";
+                } else {
+                    try {
+                        kernel.prepare(*data);
+                        const QJsonObject measured = measure(kernel, *data, options, medianNs);
+                        for (auto it = measured.begin(); it != measured.end(); ++it) result[it.key()] = it.value();
+                        if (medianNs > options.budgetMs * 1e6) overBudget.append(kernel.name);
+                    } catch (const std::exception& e) {
+                        result["status"] = "error";
+                        result["reason"] = QString::fromLocal8Bit(e.what());
+                    }
+                }
+                results.append(result);
+            }
+            first = false;
+        }
+    }
+
+    QJsonObject report;
+    report["tool"] = "statbench";
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["cpu"] = QSysInfo::currentCpuArchitecture();
+    report["os"] = QSysInfo::prettyProductName();
+#if defined(__clang__)
+    report["compiler"] = QString("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    report["compiler"] = QString("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+    report["compiler"] = QString("msvc %1").arg(_MSC_VER);
+#endif
+#ifdef NDEBUG
+    report["build"] = "release";
+#else
+    report["build"] = "debug";
+#endif
+#ifdef STATBENCH_HAS_TSC
+    report["cycleCounter"] = "rdtsc"; // Такты опорной частоты TSC, а не ядра
+#else
+    report["cycleCounter"] = QJsonValue();
+#endif
+    report["warmups"] = options.warmups;
+    report["repetitions"] = options.repetitions;
+    report["budgetMs"] = options.budgetMs;
+    report["results"] = results;
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (options.output == "-") {
+        QTextStream(stdout) << json;
+        return 0;
+    }
+    QFile file(options.output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+        err << "Не удалось записать " << options.output << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,291 @@
+// Задержки интерфейса: окно строится без дисплея, таблица заполняется синтетическими рядами,
+// затем повторяются действия пользователя. Для каждого действия — перцентили полного времени
+// от начала действия до обработки всех событий (панель и график перерисованы) и отдельно
+// updateStatistics, plotData и updateUI. Результат — JSON.
+//
+//   uibench --rows 20 --columns 5000 -o ui.json
+//   uibench --renderer fast --iterations 200
+
+#include "mainwindow.h"
+#include "latency.h"
+#include "seriesListModel.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QListView>
+#include <QTest>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Options {
+        QString output = "-";
+        int rows = 20;
+        int columns = 1000;
+        int iterations = 50;
+        int pasteSize = 10;   // Сторона вставляемого квадрата ячеек
+        int renderer = 0;     // Индекс выбора графика: QtCharts или быстрая отрисовка
+    };
+
+    // Окно обрабатывает всё, что накопилось: отложенные пересчёты, прореживание и перерисовку
+    void settle()
+    {
+        for (int pass = 0; pass < 3; ++pass) {
+            QCoreApplication::sendPostedEvents();
+            QCoreApplication::processEvents(QEventLoop::AllEvents);
+        }
+    }
+
+    QJsonObject percentiles(std::vector<qint64> nsecs)
+    {
+        QJsonObject result;
+        result["count"] = static_cast<int>(nsecs.size());
+        if (nsecs.empty()) return result;
+
+        std::sort(nsecs.begin(), nsecs.end());
+        auto at = [&](double p) {
+            const size_t rank = static_cast<size_t>(std::ceil(p * nsecs.size()));
+            return nsecs[rank == 0 ? 0 : rank - 1] / 1e6;
+        };
+        result["p50Ms"] = at(0.50);
+        result["p90Ms"] = at(0.90);
+        result["p95Ms"] = at(0.95);
+        result["p99Ms"] = at(0.99);
+        result["maxMs"] = nsecs.back() / 1e6;
+        return result;
+    }
+
+    QPushButton* findButton(QWidget* window, const QString& toolTip)
+    {
+        for (QPushButton* button : window->findChildren<QPushButton*>()) {
+            if (button->toolTip() == toolTip) return button;
+        }
+        return nullptr;
+    }
+
+    QAction* findAction(QWidget* widget, const QString& text)
+    {
+        for (QAction* action : widget->actions()) {
+            if (action->text() == text) return action;
+        }
+        return nullptr;
+    }
+
+    QString tabSeparated(int rows, int columns, std::mt19937_64& rng)
+    {
+        std::normal_distribution<double> value(100.0, 15.0);
+        QString text;
+        text.reserve(static_cast<qsizetype>(rows) * columns * 8);
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                if (column > 0) text += '\t';
+                text += QString::number(value(rng), 'f', 2);
+            }
+            text += '\n';
+        }
+        return text;
+    }
+
+    bool parseArguments(const QStringList& arguments, Options& options, QString* error)
+    {
+        QCommandLineParser parser;
+        parser.setApplicationDescription("Задержки интерфейса от действия до обновления панели и графика.");
+        parser.addHelpOption();
+        const QCommandLineOption outputOption({"o", "output"}, "Файл JSON с результатами, - для stdout.", "файл", "-");
+        const QCommandLineOption rowsOption("rows", "Рядов в синтетической таблице.", "число", "20");
+        const QCommandLineOption columnsOption("columns", "Столбцов в синтетической таблице.", "число", "1000");
+        const QCommandLineOption iterationsOption("iterations", "Повторов каждого действия.", "число", "50");
+        const QCommandLineOption pasteOption("paste-size", "Сторона вставляемого блока ячеек.", "число", "10");
+        const QCommandLineOption rendererOption("renderer", "График: charts или fast.", "вид", "charts");
+        parser.addOptions({outputOption, rowsOption, columnsOption, iterationsOption, pasteOption, rendererOption});
+
+        if (!parser.parse(arguments)) {
+            *error = parser.errorText();
+            return false;
+        }
+        if (parser.isSet("help")) parser.showHelp(0);
+
+        bool ok[4] = {};
+        options.output = parser.value(outputOption);
+        options.rows = parser.value(rowsOption).toInt(&ok[0]);
+        options.columns = parser.value(columnsOption).toInt(&ok[1]);
+        options.iterations = parser.value(iterationsOption).toInt(&ok[2]);
+        options.pasteSize = parser.value(pasteOption).toInt(&ok[3]);
+        const QString renderer = parser.value(rendererOption);
+        options.renderer = renderer == "fast" ? 1 : 0;
+
+        if (std::find(std::begin(ok), std::end(ok), false) != std::end(ok)) {
+            *error = "Числовые параметры заданы неверно.";
+        } else if (options.rows < 2 || options.columns < 1 || options.iterations < 1 || options.pasteSize < 1) {
+            *error = "Нужно не меньше двух рядов, одного столбца и одного повтора.";
+        } else if (renderer != "charts" && renderer != "fast") {
+            *error = "График должен быть charts или fast.";
+        }
+        return error->isEmpty();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QTextStream err(stderr);
+
+    Options options;
+    QString error;
+    if (!parseArguments(app.arguments(), options, &error)) {
+        err << error << Qt::endl;
+        return 2;
+    }
+
+    MainWindow window;
+    window.setWindowState(Qt::WindowNoState);
+    window.resize(1600, 900);
+    window.show();
+    settle();
+
+    QTableWidget* table = window.findChild<QTableWidget*>();
+    QComboBox* rowCombo = window.findChild<QComboBox*>("rowSelectionCombo");
+    QComboBox* rendererCombo = window.findChild<QComboBox*>("rendererCombo");
+    QListView* seriesList = window.findChild<QListView*>("seriesSettingsList");
+    QPushButton* addRowButton = findButton(&window, "Добавить ряд");
+    QPushButton* deleteRowButton = findButton(&window, "Удалить ряд");
+    QAction* pasteAction = table ? findAction(table, "Вставить") : nullptr;
+    if (!table || !rowCombo || !rendererCombo || !seriesList || !addRowButton || !deleteRowButton || !pasteAction) {
+        err << "Не найдены элементы окна: изменилась вёрстка MainWindow." << Qt::endl;
+        return 1;
+    }
+    rendererCombo->setCurrentIndex(options.renderer);
+
+    std::mt19937_64 rng(42);
+    auto randomInt = [&rng](int bound) { return std::uniform_int_distribution<int>(0, bound - 1)(rng); };
+    QJsonArray scenarios;
+
+    // Действие повторяется iterations раз; время каждого повтора — до конца settle()
+    auto run = [&](const QString& name, int iterations, const std::function<void(int)>& action) {
+        err << name << "..." << Qt::endl;
+        settle();
+        Latency::takeSamples();
+        Latency::setEnabled(true);
+
+        std::vector<qint64> totals;
+        QElapsedTimer timer;
+        for (int i = 0; i < iterations; ++i) {
+            timer.start();
+            action(i);
+            settle();
+            totals.push_back(timer.nsecsElapsed());
+        }
+
+        Latency::setEnabled(false);
+        QJsonObject stages;
+        const QMap<QString, QList<qint64>> samples = Latency::takeSamples();
+        for (auto it = samples.cbegin(); it != samples.cend(); ++it) {
+            stages[it.key()] = percentiles(std::vector<qint64>(it.value().begin(), it.value().end()));
+        }
+
+        QJsonObject scenario;
+        scenario["name"] = name;
+        scenario["total"] = percentiles(totals);
+        scenario["stages"] = stages;
+        scenarios.append(scenario);
+
+        const QJsonObject total = scenario["total"].toObject();
+        err << "  p50 " << total["p50Ms"].toDouble() << " мс, p95 " << total["p95Ms"].toDouble() << " мс" << Qt::endl;
+    };
+
+    auto paste = [&](const QString& text, int row, int column) {
+        QApplication::clipboard()->setText(text);
+        table->setCurrentCell(row, column);
+        table->clearSelection();
+        pasteAction->trigger();
+    };
+
+    // Загрузка таблицы одной вставкой, как из электронной таблицы. Размер задаётся заранее:
+    // вставка только расширяет таблицу, а начальных столбцов может быть больше, чем в опциях
+    table->setRowCount(options.rows);
+    table->setColumnCount(options.columns);
+    run("load", 1, [&](int) {
+        paste(tabSeparated(options.rows, options.columns, rng), 0, 0);
+    });
+    if (table->rowCount() != options.rows || table->columnCount() != options.columns) {
+        err << "После загрузки таблица " << table->rowCount() << " x " << table->columnCount()
+            << " вместо " << options.rows << " x " << options.columns << "." << Qt::endl;
+        return 1;
+    }
+
+    // Ввод числа в ячейку: редактор, нажатия клавиш и Enter
+    run("typing", options.iterations, [&](int) {
+        const QModelIndex index = table->model()->index(randomInt(table->rowCount()), randomInt(table->columnCount()));
+        table->setCurrentIndex(index);
+        table->edit(index);
+        QLineEdit* editor = nullptr;
+        for (QLineEdit* candidate : table->viewport()->findChildren<QLineEdit*>()) {
+            if (candidate->isVisible()) editor = candidate;
+        }
+        if (!editor) return;
+        editor->selectAll();
+        QTest::keyClicks(editor, QString::number(randomInt(100000) / 100.0, 'f', 2));
+        QTest::keyClick(editor, Qt::Key_Return);
+    });
+
+    run("paste", options.iterations, [&](int) {
+        const int size = qMin(options.pasteSize, qMin(table->rowCount(), table->columnCount()));
+        paste(tabSeparated(size, size, rng), randomInt(table->rowCount() - size + 1), randomInt(table->columnCount() - size + 1));
+    });
+
+    run("insertRow", options.iterations, [&](int) { addRowButton->click(); });
+    run("deleteRow", options.iterations, [&](int) { deleteRowButton->click(); });
+
+    run("comboSwitch", options.iterations, [&](int i) {
+        rowCombo->setCurrentIndex((rowCombo->currentIndex() + 1 + i) % rowCombo->count());
+    });
+
+    run("markerToggle", options.iterations, [&](int i) {
+        QAbstractItemModel* model = seriesList->model();
+        const QModelIndex index = model->index(i % model->rowCount(), 0);
+        const int role = i % 2 ? SeriesListModel::ShowMaxRole : SeriesListModel::ShowMinRole;
+        model->setData(index, !index.data(role).toBool(), role);
+    });
+
+    QJsonObject report;
+    report["tool"] = "uibench";
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["platform"] = QGuiApplication::platformName();
+    report["rows"] = options.rows;
+    report["columns"] = options.columns;
+    report["iterations"] = options.iterations;
+    report["renderer"] = rendererCombo->currentText();
+#ifdef NDEBUG
+    report["build"] = "release";
+#else
+    report["build"] = "debug";
+#endif
+    report["scenarios"] = scenarios;
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (options.output == "-") {
+        QTextStream(stdout) << json;
+        return 0;
+    }
+    QFile file(options.output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+        err << "Не удалось записать " << options.output << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "bufferedWriter.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+BufferedWriter::BufferedWriter(QIODevice* device, qsizetype capacity)
+    : m_device(device), m_buffer(static_cast<size_t>(qMax<qsizetype>(capacity, 64)))
+{
+}
+
+BufferedWriter::~BufferedWriter()
+{
+    flush();
+}
+
+void BufferedWriter::write(const char* data, qsizetype size)
+{
+    const qsizetype capacity = static_cast<qsizetype>(m_buffer.size());
+    if (m_size + size > capacity) {
+        flushBuffer();
+        // Крупный блок идёт на устройство напрямую, минуя копирование в буфер
+        if (size >= capacity) {
+            if (m_ok && m_device->write(data, size) != size) m_ok = false;
+            return;
+        }
+    }
+    std::memcpy(m_buffer.data() + m_size, data, static_cast<size_t>(size));
+    m_size += size;
+}
+
+void BufferedWriter::write(QStringView text)
+{
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        if (text[i].unicode() >= 0x80) {
+            write(QByteArrayView(text.mid(i).toUtf8()));
+            return;
+        }
+        put(static_cast<char>(text[i].unicode()));
+    }
+}
+
+void BufferedWriter::writeNumber(double value, int precision)
+{
+    if (std::isnan(value)) {
+        write("nan", 3);
+        return;
+    }
+
+    // Самое длинное представление double с фиксированной точностью укладывается в 350 символов
+    constexpr qsizetype maxLength = 350;
+    if (m_size + maxLength > static_cast<qsizetype>(m_buffer.size())) flushBuffer();
+
+    char* first = m_buffer.data() + m_size;
+    char* last = m_buffer.data() + qMin<qsizetype>(m_size + maxLength, static_cast<qsizetype>(m_buffer.size()));
+    const std::to_chars_result result = precision < 0
+        ? std::to_chars(first, last, value)
+        : std::to_chars(first, last, value, std::chars_format::fixed, precision);
+    if (result.ec == std::errc()) {
+        m_size += result.ptr - first;
+    } else {
+        m_ok = false;
+    }
+}
+
+bool BufferedWriter::flush()
+{
+    flushBuffer();
+    return m_ok;
+}
+
+void BufferedWriter::flushBuffer()
+{
+    if (m_size == 0) return;
+    if (m_ok && m_device->write(m_buffer.data(), m_size) != m_size) m_ok = false;
+    m_size = 0;
+}
@@ -0,0 +1,45 @@
+#ifndef BUFFEREDWRITER_H
+#define BUFFEREDWRITER_H
+
+#include <QIODevice>
+#include <QByteArrayView>
+#include <QStringView>
+
+#include <vector>
+
+#include "globals.h"
+
+// Буферизованная запись в QIODevice: текст и числа складываются в большой переиспользуемый
+// буфер и уходят на устройство редкими крупными вызовами write.
+class BufferedWriter
+{
+public:
+    explicit BufferedWriter(QIODevice* device, qsizetype capacity = exportBufferBytes);
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    void put(char c)
+    {
+        if (m_size == static_cast<qsizetype>(m_buffer.size())) flushBuffer();
+        m_buffer[m_size++] = c;
+    }
+    void write(const char* data, qsizetype size);
+    void write(QByteArrayView bytes) { write(bytes.data(), bytes.size()); }
+    void write(QStringView text);                        // В UTF-8, ASCII копируется без преобразований
+    void writeNumber(double value, int precision = -1);  // to_chars; -1 — кратчайшее точное представление
+
+    bool flush();
+    bool ok() const { return m_ok; }
+
+private:
+    void flushBuffer();
+
+    QIODevice* m_device;
+    std::vector<char> m_buffer;
+    qsizetype m_size = 0;
+    bool m_ok = true;
+};
+
+#endif // BUFFEREDWRITER_H
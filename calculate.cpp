@@ -3,6 +3,7 @@
 #endif
 #include <math.h>
 #include "calculate.h"
+#include "histogram.h"
 
 namespace Calculate
 {
@@ -11,38 +12,6 @@ namespace Calculate
         return (weights.size() == values.size()) && !weights.isEmpty();
     }
 
-    std::vector<double> getWeights(const QTableWidget *table, int weightColumn = 1)
-    {
-        std::vector<double> weights;
-        if (!table || weightColumn >= table->columnCount() || weightColumn < 0)
-            return weights;
-
-        for (int row = 0; row < table->rowCount(); ++row)
-        {
-            QTableWidgetItem *item = table->item(row, weightColumn);
-            if (item && !item->text().isEmpty())
-            {
-                bool ok;
-                double weight = item->text().toDouble(&ok);
-                if (ok && weight >= 0 && std::isfinite(weight))
-                {
-                    weights.push_back(weight);
-                }
-                else
-                {
-                    qWarning() << "Invalid weight found in row" << row << "column" << weightColumn;
-                    return std::vector<double>();
-                }
-            }
-            else
-            {
-                qWarning() << "Empty weight cell found in row" << row << "column" << weightColumn;
-                return std::vector<double>();
-            }
-        }
-        return weights;
-    }
-
     double getSum(const std::vector<double> &values)
     {
         long double sum = std::accumulate(values.begin(), values.end(), 0.0L);
@@ -68,16 +37,25 @@ namespace Calculate
         if (values.empty())
             return std::numeric_limits<double>::quiet_NaN();
 
+        return sortedMedian(sortedFinite(values));
+    }
+
+    std::vector<double> sortedFinite(const std::vector<double> &values)
+    {
         std::vector<double> sorted = values;
         sorted.erase(std::remove_if(sorted.begin(), sorted.end(), [](double d)
                                     { return !std::isfinite(d); }),
                      sorted.end());
 
+        std::sort(sorted.begin(), sorted.end());
+        return sorted;
+    }
+
+    double sortedMedian(const std::vector<double> &sorted)
+    {
         if (sorted.empty())
             return std::numeric_limits<double>::quiet_NaN();
 
-        std::sort(sorted.begin(), sorted.end());
-
         const int size = sorted.size();
         const int mid = size / 2;
 
@@ -107,7 +85,11 @@ namespace Calculate
                 frequencyMap[value]++;
             }
         }
+        return frequencyMode(frequencyMap);
+    }
 
+    double frequencyMode(const std::map<double, int> &frequencyMap)
+    {
         if (frequencyMap.empty())
             return std::numeric_limits<double>::quiet_NaN();
 
@@ -237,19 +219,13 @@ namespace Calculate
 
     double weightedMean(const std::vector<double> &values, const std::vector<double> &weights)
     {
-        qDebug() << "=== weightedMean calculation ===";
-        qDebug() << "Values:" << values;
-        qDebug() << "Weights:" << weights;
-
         if (values.size() != weights.size())
         {
-            qDebug() << "Error: Values and weights size mismatch";
             return std::numeric_limits<double>::quiet_NaN();
         }
 
         if (values.empty() || weights.empty())
         {
-            qDebug() << "Error: Empty input data";
             return std::numeric_limits<double>::quiet_NaN();
         }
 
@@ -262,53 +238,12 @@ namespace Calculate
 
         if (sumWeights <= 0)
         {
-            qDebug() << "Error: Sum of weights is zero";
             return std::numeric_limits<double>::quiet_NaN();
         }
 
         return sumProducts / sumWeights;
     }
 
-    std::vector<double> findWeights(const QTableWidget *table)
-    {
-        const int colCount = table->columnCount();
-
-        for (int col = 0; col < colCount; ++col)
-        {
-            std::vector<double> candidateWeights;
-            bool validColumn = true;
-
-            for (int row = 0; row < table->rowCount(); ++row)
-            {
-                QTableWidgetItem *item = table->item(row, col);
-                if (!item || item->text().isEmpty())
-                {
-                    validColumn = false;
-                    break;
-                }
-
-                bool ok;
-                const double value = item->text().toDouble(&ok);
-                if (!ok || value < 0)
-                {
-                    validColumn = false;
-                    break;
-                }
-
-                candidateWeights.push_back(value);
-            }
-
-            if (validColumn && !candidateWeights.empty())
-            {
-                qDebug() << "Found weights in column" << col;
-                return candidateWeights;
-            }
-        }
-
-        qDebug() << "No valid weights column found. Using uniform weights.";
-        return std::vector<double>(table->rowCount(), 1.0);
-    }
-
     double rootMeanSquare(const std::vector<double> &values)
     {
         if (values.empty())
@@ -384,8 +319,13 @@ namespace Calculate
         if (values.empty() || trimFraction < 0 || trimFraction >= 0.5)
             return std::numeric_limits<double>::quiet_NaN();
 
-        std::vector<double> sorted = values;
-        std::sort(sorted.begin(), sorted.end());
+        return sortedTrimmedMean(sortedFinite(values), trimFraction);
+    }
+
+    double sortedTrimmedMean(const std::vector<double> &sorted, double trimFraction)
+    {
+        if (sorted.empty() || trimFraction < 0 || trimFraction >= 0.5)
+            return std::numeric_limits<double>::quiet_NaN();
 
         const int removeCount = static_cast<int>(sorted.size() * trimFraction);
         const int start = removeCount;
@@ -408,17 +348,29 @@ namespace Calculate
         if (values.empty())
             return std::numeric_limits<double>::quiet_NaN();
 
-        std::vector<double> sorted = values;
-        std::sort(sorted.begin(), sorted.end());
-        const double median = getMedian(sorted);
+        return sortedMedianAbsoluteDeviation(sortedFinite(values));
+    }
 
+    double sortedMedianAbsoluteDeviation(const std::vector<double> &sorted)
+    {
+        const double median = sortedMedian(sorted);
+        if (std::isnan(median))
+            return std::numeric_limits<double>::quiet_NaN();
+
+        // Отклонения слева и справа от медианы уже упорядочены: слияние вместо повторной сортировки
+        const size_t split = std::lower_bound(sorted.begin(), sorted.end(), median) - sorted.begin();
         std::vector<double> deviations;
-        for (double value : values)
+        deviations.reserve(sorted.size());
+        size_t left = split;
+        size_t right = split;
+        while (left > 0 || right < sorted.size())
         {
-            deviations.push_back(std::abs(value - median));
+            const bool takeLeft = right == sorted.size()
+                                  || (left > 0 && median - sorted[left - 1] <= sorted[right] - median);
+            deviations.push_back(takeLeft ? median - sorted[--left] : sorted[right++] - median);
         }
 
-        return getMedian(deviations);
+        return sortedMedian(deviations);
     }
 
     double robustStandardDeviation(const std::vector<double> &values)
@@ -544,16 +496,22 @@ namespace Calculate
         if (n < MIN_SAMPLE_SIZE || n > MAX_SAMPLE_SIZE)
             return std::numeric_limits<double>::quiet_NaN();
 
+        // Сортируем выборку; размер после отбрасывания NaN проверяет sortedShapiroWilkTest
+        return sortedShapiroWilkTest(sortedFinite(data));
+    }
+
+    double sortedShapiroWilkTest(const std::vector<double> &sorted)
+    {
+        const int n = sorted.size();
+        if (n < MIN_SAMPLE_SIZE || n > MAX_SAMPLE_SIZE)
+            return std::numeric_limits<double>::quiet_NaN();
+
         // 1. Получаем коэффициенты Шапиро-Уилка для данного n
         const std::vector<double>& a = getShapiroWilkCoefficients(n);
         if (a.empty() || a.size() != n/2)
             return std::numeric_limits<double>::quiet_NaN();
 
-        // 2. Сортируем выборку
-        std::vector<double> sorted = data;
-        std::sort(sorted.begin(), sorted.end());
-
-        // 3. Вычисляем сумму квадратов отклонений
+        // 2. Вычисляем сумму квадратов отклонений
         const double mean = getMean(sorted);
         double ssq = std::accumulate(sorted.begin(), sorted.end(), 0.0,
                                      [mean](double acc, double x) { return acc + (x - mean)*(x - mean); });
@@ -561,7 +519,7 @@ namespace Calculate
         if (ssq < std::numeric_limits<double>::epsilon())
             return 1.0; // Все значения одинаковые
 
-        // 4. Вычисляем числитель W-статистики
+        // 3. Вычисляем числитель W-статистики
         double numerator = 0.0;
         for (size_t i = 0; i < a.size(); ++i) {
             const int j = n - 1 - i;
@@ -569,10 +527,10 @@ namespace Calculate
         }
         numerator *= numerator;
 
-        // 5. Рассчитываем W-статистику
+        // 4. Рассчитываем W-статистику
         const double W = numerator / ssq;
 
-        // 6. Сравнение с критическим значением
+        // 5. Сравнение с критическим значением
         return (W >= SW_CRITICAL_VALUE) ? 1.0 : 0.0;
     }
 
@@ -620,55 +578,34 @@ namespace Calculate
     }
 
 
-    double chiSquareTest(const std::vector<double> &data) {
-        if (data.size() < MIN_SAMPLE_SIZE)
-            return std::numeric_limits<double>::quiet_NaN();
-
-        // 1. Оценка параметров распределения
-        const double mu = getMean(data);
-        const double sigma = getStandardDeviation(data, mu);
-
-        // Проверка edge-case: все данные одинаковые
-        if (sigma < std::numeric_limits<double>::epsilon()) {
-            return std::numeric_limits<double>::quiet_NaN();
-        }
-
-        // 2. Создание бинов через квантили
+    std::vector<double> chiSquareBinEdges(double mu, double sigma) {
+        // Бины через квантили нормального распределения
         const int target_bins = CHI2_BINS;
         std::vector<double> bin_edges(target_bins + 1);
-
-        try {
-            for (int i = 0; i <= target_bins; ++i) {
-                const double p = static_cast<double>(i)/target_bins;
-                bin_edges[i] = mu + sigma * std::sqrt(2.0) * erf_inv(2*p - 1);
-            }
-        } catch (...) {
-            return std::numeric_limits<double>::quiet_NaN();
+        for (int i = 0; i <= target_bins; ++i) {
+            const double p = static_cast<double>(i)/target_bins;
+            bin_edges[i] = mu + sigma * std::sqrt(2.0) * erf_inv(2*p - 1);
         }
+        return bin_edges;
+    }
 
-        // 3. Подсчет наблюдаемых частот
-        std::vector<int> observed(target_bins, 0);
-        for (double v : data) {
-            auto it = std::upper_bound(bin_edges.begin(), bin_edges.end(), v);
-            int bin = std::distance(bin_edges.begin(), it) - 1;
-            bin = std::clamp(bin, 0, target_bins-1);
-            observed[bin]++;
-        }
+    double chiSquareFromBins(const std::vector<double> &observed, const std::vector<double> &bin_edges,
+                             double mu, double sigma, double total) {
+        const int target_bins = observed.size();
 
-        // 4. Расчет ожидаемых частот
+        // 1. Расчет ожидаемых частот
         std::vector<double> expected(target_bins);
-        const double total = data.size();
         for (int i = 0; i < target_bins; ++i) {
             double p_low = 0.5 * (1 + std::erf((bin_edges[i] - mu)/(sigma * M_SQRT2)));
             double p_high = 0.5 * (1 + std::erf((bin_edges[i+1] - mu)/(sigma * M_SQRT2)));
             expected[i] = total * (p_high - p_low);
         }
 
-        // 5. Объединение бинов с малыми ожиданиями
-        std::vector<int> obs_merged;
+        // 2. Объединение бинов с малыми ожиданиями
+        std::vector<double> obs_merged;
         std::vector<double> exp_merged;
         double curr_exp = 0.0;
-        int curr_obs = 0;
+        double curr_obs = 0.0;
 
         for (int i = 0; i < target_bins; ++i) {
             curr_exp += expected[i];
@@ -678,7 +615,7 @@ namespace Calculate
                 exp_merged.push_back(curr_exp);
                 obs_merged.push_back(curr_obs);
                 curr_exp = 0.0;
-                curr_obs = 0;
+                curr_obs = 0.0;
             }
         }
 
@@ -686,7 +623,7 @@ namespace Calculate
         if (exp_merged.size() < 3)
             return std::numeric_limits<double>::quiet_NaN();
 
-        // 6. Расчет χ² статистики
+        // 3. Расчет χ² статистики
         double chi2 = 0.0;
         for (size_t i = 0; i < exp_merged.size(); ++i) {
             if (exp_merged[i] < 1e-5) continue;
@@ -696,6 +633,34 @@ namespace Calculate
         return chi2;
     }
 
+    double chiSquareTest(const std::vector<double> &data) {
+        if (data.size() < MIN_SAMPLE_SIZE)
+            return std::numeric_limits<double>::quiet_NaN();
+
+        // 1. Оценка параметров распределения
+        const double mu = getMean(data);
+        return chiSquareTest(data, mu, getStandardDeviation(data, mu));
+    }
+
+    double chiSquareTest(const std::vector<double> &data, double mu, double sigma) {
+        if (data.size() < MIN_SAMPLE_SIZE)
+            return std::numeric_limits<double>::quiet_NaN();
+
+        // Проверка edge-case: все данные одинаковые
+        if (sigma < std::numeric_limits<double>::epsilon()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        // 2. Создание бинов через квантили
+        const std::vector<double> bin_edges = chiSquareBinEdges(mu, sigma);
+
+        // 3. Подсчет наблюдаемых частот
+        const std::vector<std::uint64_t> counts = Histogram::count(data, bin_edges);
+        const std::vector<double> observed(counts.begin(), counts.end());
+
+        return chiSquareFromBins(observed, bin_edges, mu, sigma, data.size());
+    }
+
     double calculateMean(const std::vector<double>& data) {
         return std::accumulate(data.begin(), data.end(), 0.0) / data.size();
     }
@@ -710,9 +675,7 @@ namespace Calculate
     }
 
     double kolmogorovSmirnovTest(const std::vector<double> &data) {
-        const int MIN_SAMPLE_SIZE = 30;  // Минимальный размер выборки
-
-        if (data.size() < MIN_SAMPLE_SIZE)
+        if (data.size() < KS_MIN_SAMPLE_SIZE)
             return std::numeric_limits<double>::quiet_NaN();
 
         // 1. Рассчитываем параметры распределения
@@ -724,9 +687,13 @@ namespace Calculate
             return std::numeric_limits<double>::quiet_NaN();
         }
 
-        // 2. Сортируем данные
-        std::vector<double> sorted = data;
-        std::sort(sorted.begin(), sorted.end());
+        // 2. Сортируем данные; с NaN среднее и отклонение не определены, и тест вернёт NaN
+        return sortedKolmogorovSmirnovTest(sortedFinite(data), mu, sigma);
+    }
+
+    double sortedKolmogorovSmirnovTest(const std::vector<double> &sorted, double mu, double sigma) {
+        if (sorted.size() < KS_MIN_SAMPLE_SIZE || !(sigma >= std::numeric_limits<double>::epsilon()))
+            return std::numeric_limits<double>::quiet_NaN();
 
         // 3. Вычисляем статистику D
         double D = 0.0;
@@ -1,10 +1,10 @@
 #ifndef CALCULATIONS_H
 #define CALCULATIONS_H
 
-#include <QTableWidgetItem>
 #include <QString>
 #include <QHash>
 #include <QSet>
+#include <QVector>
 #include <QtDebug>
 
 #include "calculate.h"
@@ -15,14 +15,14 @@
 #include <cmath>
 #include <algorithm>
 #include <numeric>
+#include <stdexcept>
 #include <unordered_set>
 #include <map>
 #include <vector>
 
+// Числовые функции ряда. Входит в библиотеку statcore: без виджетов, только QtCore
 namespace Calculate
 {
-    std::vector<double> getWeights(const QTableWidget* table, int weightColumn);
-    std::vector<double> findWeights(const QTableWidget* table); // Автоматический поиск столбца с весами
     double getSum(const std::vector<double>& values);
     double getMean(const std::vector<double>& values);
     double getMedian(const std::vector<double>& values);
@@ -44,7 +44,20 @@ namespace Calculate
     double shapiroWilkTest(const std::vector<double>& data);
     double calculateDensity(const std::vector<double>& data, double point);
     double chiSquareTest(const std::vector<double>& data);
+    std::vector<double> chiSquareBinEdges(double mean, double stdDev);
+    double chiSquareFromBins(const std::vector<double>& observed, const std::vector<double>& binEdges,
+                             double mean, double stdDev, double total);
     double kolmogorovSmirnovTest(const std::vector<double>& data);
+    double chiSquareTest(const std::vector<double>& data, double mean, double stdDev);
+
+    // Варианты для уже отсортированных значений: сортировка делается один раз на все метрики ряда
+    std::vector<double> sortedFinite(const std::vector<double>& values); // Без NaN и бесконечностей: с ними порядок не определён
+    double sortedMedian(const std::vector<double>& sorted);
+    double sortedTrimmedMean(const std::vector<double>& sorted, double trimFraction);
+    double sortedMedianAbsoluteDeviation(const std::vector<double>& sorted);
+    double sortedShapiroWilkTest(const std::vector<double>& sorted);
+    double sortedKolmogorovSmirnovTest(const std::vector<double>& sorted, double mean, double stdDev);
+    double frequencyMode(const std::map<double, int>& frequencies);
 }
 
 #endif // CALCULATIONS_H
@@ -0,0 +1,157 @@
+#include "clipboard.h"
+#include "fastParse.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QSignalBlocker>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace Clipboard
+{
+    namespace {
+        struct Cell {
+            int row;
+            int column;
+            QString text; // Пустой текст очищает ячейку
+        };
+
+        // Ячейка из электронной таблицы: пробелы по краям отбрасываются, "1,5" читается как 1.5
+        bool parseCell(const char* first, const char* last, QString& text)
+        {
+            while (first != last && (*first == ' ' || *first == '\r')) ++first;
+            while (last != first && (last[-1] == ' ' || last[-1] == '\r')) --last;
+
+            text.clear();
+            if (first == last || FastParse::isGap(first, last)) return true;
+
+            double value;
+            if (FastParse::toCellValue(first, last, value)) {
+                text = QString::fromLatin1(first, last - first);
+                return true;
+            }
+
+            const char* comma = std::find(first, last, ',');
+            if (comma == last || std::find(comma + 1, last, ',') != last || std::find(first, last, '.') != last) return false;
+            std::string copy(first, last);
+            copy[comma - first] = '.';
+            if (!FastParse::toCellValue(copy.data(), copy.data() + copy.size(), value)) return false;
+            text = QString::fromLatin1(copy.data(), static_cast<qsizetype>(copy.size()));
+            return true;
+        }
+
+        void writeCell(QTableWidget* table, int row, int column, const QString& text)
+        {
+            if (text.isEmpty()) {
+                delete table->takeItem(row, column);
+            } else if (QTableWidgetItem* item = table->item(row, column)) {
+                item->setText(text);
+            } else {
+                table->setItem(row, column, new QTableWidgetItem(text));
+            }
+        }
+
+        // Таблица растёт до нужного размера со всеми сигналами, сами ячейки пишутся без них
+        Result writeCells(QTableWidget* table, const std::vector<Cell>& cells, int skippedCells)
+        {
+            Result result;
+            result.skippedCells = skippedCells;
+            if (cells.empty()) return result;
+
+            int rows = table->rowCount();
+            int columns = table->columnCount();
+            for (const Cell& cell : cells) {
+                rows = qMax(rows, cell.row + 1);
+                columns = qMax(columns, cell.column + 1);
+            }
+            if (columns > table->columnCount()) table->setColumnCount(columns);
+            if (rows > table->rowCount()) table->setRowCount(rows);
+
+            std::vector<bool> touched(rows, false);
+            {
+                const QSignalBlocker blocker(table->model());
+                for (const Cell& cell : cells) {
+                    writeCell(table, cell.row, cell.column, cell.text);
+                    touched[cell.row] = true;
+                }
+            }
+            table->viewport()->update();
+
+            for (int row = 0; row < rows; ++row) {
+                if (touched[row]) result.rows.append(row);
+            }
+            return result;
+        }
+    }
+
+    Result pasteText(QTableWidget* table, const QByteArray& text, int row, int column)
+    {
+        std::vector<Cell> cells;
+        int skipped = 0;
+        const bool tabular = text.contains('\t');
+
+        const char* data = text.constData();
+        const char* end = data + text.size();
+        for (const char* line = data; line < end; ++row) {
+            const char* lineEnd = std::find(line, end, '\n');
+
+            if (tabular) {
+                int col = column;
+                for (const char* cellStart = line; ; ++col) {
+                    const char* cellEnd = std::find(cellStart, lineEnd, '\t');
+                    QString cellText;
+                    if (parseCell(cellStart, cellEnd, cellText)) {
+                        cells.push_back({row, col, cellText});
+                    } else {
+                        ++skipped;
+                    }
+                    if (cellEnd == lineEnd) break;
+                    cellStart = cellEnd + 1;
+                }
+            } else {
+                FastParse::forEachToken(line, lineEnd, [&](int index, const char* first, const char* last) {
+                    double value;
+                    if (FastParse::isGap(first, last)) {
+                        cells.push_back({row, column + index, QString()});
+                    } else if (FastParse::toCellValue(first, last, value)) {
+                        cells.push_back({row, column + index, QString::fromLatin1(first, last - first)});
+                    } else {
+                        ++skipped;
+                    }
+                });
+            }
+            line = lineEnd + 1;
+        }
+        return writeCells(table, cells, skipped);
+    }
+
+    Result paste(QTableWidget* table)
+    {
+        int row = qMax(0, table->currentRow());
+        int column = qMax(0, table->currentColumn());
+        const QList<QTableWidgetSelectionRange> ranges = table->selectedRanges();
+        if (!ranges.isEmpty()) {
+            row = ranges.first().topRow();
+            column = ranges.first().leftColumn();
+        }
+        return pasteText(table, QApplication::clipboard()->text().toUtf8(), row, column);
+    }
+
+    Result fillSelection(QTableWidget* table)
+    {
+        const QTableWidgetItem* current = table->currentItem();
+        const QString text = current ? current->text() : QString();
+
+        std::vector<Cell> cells;
+        for (const QTableWidgetSelectionRange& range : table->selectedRanges()) {
+            for (int row = range.topRow(); row <= range.bottomRow(); ++row) {
+                for (int column = range.leftColumn(); column <= range.rightColumn(); ++column) {
+                    cells.push_back({row, column, text});
+                }
+            }
+        }
+        return writeCells(table, cells, 0);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef CLIPBOARD_H
+#define CLIPBOARD_H
+
+#include <QTableWidget>
+#include <QByteArray>
+#include <QList>
+
+// Массовая запись в таблицу: вставка блока из буфера обмена и заполнение выделения.
+// Ячейки пишутся без сигналов модели; вызывающий перечитывает только возвращённые ряды
+// и пересчитывает статистику один раз.
+namespace Clipboard
+{
+    struct Result {
+        QList<int> rows;      // Ряды с изменёнными ячейками, по возрастанию
+        int skippedCells = 0; // Токены, не разобранные как число: ячейки сохранили прежнее содержимое
+    };
+
+    // Блок текста с левым верхним углом в (row, column). Строки — ряды; внутри строки ячейки
+    // разделяются табуляцией (как при копировании из электронных таблиц, пустые ячейки сохраняются)
+    // или, если табуляций нет, теми же разделителями, что при импорте
+    Result pasteText(QTableWidget* table, const QByteArray& text, int row, int column);
+    Result paste(QTableWidget* table); // Из системного буфера обмена в текущую ячейку
+
+    // Все выделенные ячейки получают значение текущей ячейки
+    Result fillSelection(QTableWidget* table);
+}
+
+#endif // CLIPBOARD_H
@@ -0,0 +1,337 @@
+#include "compression.h"
+
+#include <QFileDevice>
+#include <QFileInfo>
+
+#include <limits>
+
+namespace Compression
+{
+    Codec detectCodec(QIODevice* source)
+    {
+        const QByteArray head = source->peek(4);
+        if (head.size() >= 2 && uchar(head[0]) == 0x1f && uchar(head[1]) == 0x8b)
+            return Codec::Gzip;
+        if (head.size() >= 4 && head == QByteArray("\x28\xb5\x2f\xfd", 4))
+            return Codec::Zstd;
+        return Codec::None;
+    }
+
+    Codec codecForFileName(const QString& fileName)
+    {
+        const QString suffix = QFileInfo(fileName).suffix().toLower();
+        if (suffix == "gz") return Codec::Gzip;
+        if (suffix == "zst") return Codec::Zstd;
+        return Codec::None;
+    }
+
+    bool isAvailable(Codec codec)
+    {
+#ifdef STATVIS_WITH_ZSTD
+        Q_UNUSED(codec);
+        return true;
+#else
+        return codec != Codec::Zstd;
+#endif
+    }
+
+    QString codecName(Codec codec)
+    {
+        switch (codec) {
+        case Codec::Gzip: return "gzip";
+        case Codec::Zstd: return "zstd";
+        default: return QString();
+        }
+    }
+
+    std::unique_ptr<QIODevice> createDecoder(Codec codec, QIODevice* source)
+    {
+        std::unique_ptr<QIODevice> decoder;
+        if (codec == Codec::Gzip) decoder = std::make_unique<GzipDevice>(source);
+#ifdef STATVIS_WITH_ZSTD
+        if (codec == Codec::Zstd) decoder = std::make_unique<ZstdDevice>(source);
+#endif
+        if (decoder && !decoder->open(QIODevice::ReadOnly)) decoder.reset();
+        return decoder;
+    }
+
+    std::unique_ptr<QIODevice> createEncoder(Codec codec, QIODevice* sink)
+    {
+        std::unique_ptr<QIODevice> encoder;
+        if (codec == Codec::Gzip) encoder = std::make_unique<GzipDevice>(sink);
+#ifdef STATVIS_WITH_ZSTD
+        if (codec == Codec::Zstd) encoder = std::make_unique<ZstdDevice>(sink);
+#endif
+        if (encoder && !encoder->open(QIODevice::WriteOnly)) encoder.reset();
+        return encoder;
+    }
+
+    bool hasReadError(const QIODevice& device)
+    {
+        if (const auto* gzip = qobject_cast<const GzipDevice*>(&device)) return gzip->hasError();
+#ifdef STATVIS_WITH_ZSTD
+        if (const auto* zstd = qobject_cast<const ZstdDevice*>(&device)) return zstd->hasError();
+#endif
+        if (const auto* file = qobject_cast<const QFileDevice*>(&device)) return file->error() != QFileDevice::NoError;
+        return false;
+    }
+
+    // ---------------------------------------------------------------- gzip
+
+    GzipDevice::GzipDevice(QIODevice* device, int level)
+        : m_device(device), m_level(level)
+    {
+    }
+
+    GzipDevice::~GzipDevice()
+    {
+        if (isOpen()) close();
+    }
+
+    bool GzipDevice::open(OpenMode mode)
+    {
+        const bool reading = mode.testFlag(QIODevice::ReadOnly);
+        const bool writing = mode.testFlag(QIODevice::WriteOnly);
+        if (reading == writing || !m_device || !m_device->isOpen()) return false;
+
+        m_stream = z_stream{};
+        // 15 + 32: автоопределение gzip/zlib при чтении, 15 + 16: заголовок gzip при записи
+        const int rc = reading ? inflateInit2(&m_stream, 15 + 32)
+                               : deflateInit2(&m_stream, m_level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+        if (rc != Z_OK) {
+            setErrorString("Не удалось инициализировать zlib");
+            return false;
+        }
+
+        m_buffer.resize(chunkSize);
+        m_initialized = true;
+        m_sourceDrained = false;
+        m_memberOpen = false;
+        m_finished = false;
+        m_failed = false;
+        return QIODevice::open(mode);
+    }
+
+    void GzipDevice::close()
+    {
+        if (m_initialized) {
+            if (openMode().testFlag(QIODevice::WriteOnly)) {
+                int rc;
+                do {
+                    rc = deflateChunk(Z_FINISH);
+                } while (rc == Z_OK || rc == Z_BUF_ERROR);
+                deflateEnd(&m_stream);
+            } else {
+                inflateEnd(&m_stream);
+            }
+            m_initialized = false;
+        }
+        QIODevice::close();
+    }
+
+    bool GzipDevice::atEnd() const
+    {
+        return (m_finished || m_failed) && QIODevice::bytesAvailable() == 0;
+    }
+
+    qint64 GzipDevice::fail(const QString& message)
+    {
+        setErrorString(message);
+        m_failed = true;
+        return -1;
+    }
+
+    qint64 GzipDevice::readData(char* data, qint64 maxSize)
+    {
+        if (m_failed) return -1;
+        if (m_finished) return 0;
+
+        m_stream.next_out = reinterpret_cast<Bytef*>(data);
+        m_stream.avail_out = static_cast<uInt>(qMin<qint64>(maxSize, std::numeric_limits<uInt>::max()));
+
+        while (m_stream.avail_out > 0) {
+            if (m_stream.avail_in == 0 && !m_sourceDrained) {
+                const qint64 n = m_device->read(m_buffer.data(), m_buffer.size());
+                if (n < 0) return fail(m_device->errorString());
+                m_sourceDrained = n == 0;
+                m_stream.next_in = reinterpret_cast<Bytef*>(m_buffer.data());
+                m_stream.avail_in = static_cast<uInt>(n);
+            }
+
+            const uInt before = m_stream.avail_out;
+            const uInt inputBefore = m_stream.avail_in;
+            const int rc = inflate(&m_stream, Z_NO_FLUSH);
+            if (rc == Z_STREAM_END) {
+                // Файл может состоять из нескольких gzip-блоков подряд
+                inflateReset(&m_stream);
+                m_memberOpen = false;
+            } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+                return fail(m_stream.msg ? QString::fromLatin1(m_stream.msg) : "Повреждённые gzip-данные");
+            } else if (m_stream.avail_in != inputBefore || m_stream.avail_out != before) {
+                m_memberOpen = true;
+            }
+
+            if (m_sourceDrained && m_stream.avail_in == 0 && m_stream.avail_out == before) {
+                if (m_memberOpen) return fail("Файл gzip обрывается посреди сжатых данных");
+                m_finished = true;
+                break;
+            }
+        }
+        return qMin<qint64>(maxSize, std::numeric_limits<uInt>::max()) - m_stream.avail_out;
+    }
+
+    int GzipDevice::deflateChunk(int flush)
+    {
+        m_stream.next_out = reinterpret_cast<Bytef*>(m_buffer.data());
+        m_stream.avail_out = static_cast<uInt>(m_buffer.size());
+
+        const int rc = deflate(&m_stream, flush);
+        if (rc == Z_STREAM_ERROR) return rc;
+
+        const qint64 produced = m_buffer.size() - m_stream.avail_out;
+        if (produced > 0 && m_device->write(m_buffer.constData(), produced) != produced) {
+            setErrorString(m_device->errorString());
+            return Z_ERRNO;
+        }
+        return rc;
+    }
+
+    qint64 GzipDevice::writeData(const char* data, qint64 size)
+    {
+        qint64 written = 0;
+        while (written < size) {
+            const uInt portion = static_cast<uInt>(qMin<qint64>(size - written, std::numeric_limits<uInt>::max()));
+            m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + written));
+            m_stream.avail_in = portion;
+            while (m_stream.avail_in > 0) {
+                const int rc = deflateChunk(Z_NO_FLUSH);
+                if (rc != Z_OK && rc != Z_BUF_ERROR) return -1;
+            }
+            written += portion;
+        }
+        return size;
+    }
+
+    // ---------------------------------------------------------------- zstd
+
+#ifdef STATVIS_WITH_ZSTD
+    ZstdDevice::ZstdDevice(QIODevice* device, int level)
+        : m_device(device), m_level(level)
+    {
+    }
+
+    ZstdDevice::~ZstdDevice()
+    {
+        if (isOpen()) close();
+    }
+
+    bool ZstdDevice::open(OpenMode mode)
+    {
+        const bool reading = mode.testFlag(QIODevice::ReadOnly);
+        const bool writing = mode.testFlag(QIODevice::WriteOnly);
+        if (reading == writing || !m_device || !m_device->isOpen()) return false;
+
+        if (reading) {
+            m_dstream = ZSTD_createDStream();
+            if (!m_dstream || ZSTD_isError(ZSTD_initDStream(m_dstream))) return false;
+            m_buffer.resize(static_cast<int>(ZSTD_DStreamInSize()));
+        } else {
+            m_cstream = ZSTD_createCStream();
+            if (!m_cstream || ZSTD_isError(ZSTD_CCtx_setParameter(m_cstream, ZSTD_c_compressionLevel, m_level)))
+                return false;
+            m_buffer.resize(static_cast<int>(ZSTD_CStreamOutSize()));
+        }
+
+        m_input = ZSTD_inBuffer{nullptr, 0, 0};
+        m_sourceDrained = false;
+        m_frameOpen = false;
+        m_finished = false;
+        m_failed = false;
+        return QIODevice::open(mode);
+    }
+
+    void ZstdDevice::close()
+    {
+        if (m_cstream) {
+            size_t remaining;
+            do {
+                ZSTD_inBuffer empty{nullptr, 0, 0};
+                ZSTD_outBuffer output{m_buffer.data(), static_cast<size_t>(m_buffer.size()), 0};
+                remaining = ZSTD_compressStream2(m_cstream, &output, &empty, ZSTD_e_end);
+                if (ZSTD_isError(remaining) || !flushOutput(output)) break;
+            } while (remaining != 0);
+            ZSTD_freeCStream(m_cstream);
+            m_cstream = nullptr;
+        }
+        if (m_dstream) {
+            ZSTD_freeDStream(m_dstream);
+            m_dstream = nullptr;
+        }
+        QIODevice::close();
+    }
+
+    bool ZstdDevice::atEnd() const
+    {
+        return (m_finished || m_failed) && QIODevice::bytesAvailable() == 0;
+    }
+
+    qint64 ZstdDevice::fail(const QString& message)
+    {
+        setErrorString(message);
+        m_failed = true;
+        return -1;
+    }
+
+    qint64 ZstdDevice::readData(char* data, qint64 maxSize)
+    {
+        if (m_failed) return -1;
+        if (m_finished) return 0;
+
+        ZSTD_outBuffer output{data, static_cast<size_t>(maxSize), 0};
+        while (output.pos < output.size) {
+            if (m_input.pos == m_input.size && !m_sourceDrained) {
+                const qint64 n = m_device->read(m_buffer.data(), m_buffer.size());
+                if (n < 0) return fail(m_device->errorString());
+                m_sourceDrained = n == 0;
+                m_input = ZSTD_inBuffer{m_buffer.constData(), static_cast<size_t>(n), 0};
+            }
+
+            const size_t before = output.pos;
+            const size_t inputBefore = m_input.pos;
+            const size_t rc = ZSTD_decompressStream(m_dstream, &output, &m_input);
+            if (ZSTD_isError(rc)) return fail(QString::fromLatin1(ZSTD_getErrorName(rc)));
+            // 0 — кадр декодирован и выдан целиком
+            if (rc == 0) m_frameOpen = false;
+            else if (m_input.pos != inputBefore || output.pos != before) m_frameOpen = true;
+
+            if (m_sourceDrained && m_input.pos == m_input.size && output.pos == before) {
+                if (m_frameOpen) return fail("Файл zstd обрывается посреди сжатых данных");
+                m_finished = true;
+                break;
+            }
+        }
+        return static_cast<qint64>(output.pos);
+    }
+
+    bool ZstdDevice::flushOutput(ZSTD_outBuffer& output)
+    {
+        const qint64 produced = static_cast<qint64>(output.pos);
+        if (produced > 0 && m_device->write(m_buffer.constData(), produced) != produced) {
+            setErrorString(m_device->errorString());
+            return false;
+        }
+        return true;
+    }
+
+    qint64 ZstdDevice::writeData(const char* data, qint64 size)
+    {
+        ZSTD_inBuffer input{data, static_cast<size_t>(size), 0};
+        while (input.pos < input.size) {
+            ZSTD_outBuffer output{m_buffer.data(), static_cast<size_t>(m_buffer.size()), 0};
+            const size_t rc = ZSTD_compressStream2(m_cstream, &output, &input, ZSTD_e_continue);
+            if (ZSTD_isError(rc) || !flushOutput(output)) return -1;
+        }
+        return size;
+    }
+#endif
+}
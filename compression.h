@@ -0,0 +1,106 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <QIODevice>
+#include <QString>
+#include <QByteArray>
+
+#include <memory>
+
+#include <zlib.h>
+
+#ifdef STATVIS_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+// Потоковое сжатие и распаковка поверх произвольного QIODevice.
+// Кодеки не владеют исходным устройством и работают блоками, поэтому
+// распакованные данные никогда не хранятся целиком ни в памяти, ни на диске.
+namespace Compression
+{
+    enum class Codec { None, Gzip, Zstd };
+
+    constexpr int chunkSize = 256 * 1024;
+
+    Codec detectCodec(QIODevice* source);             // По сигнатуре, без чтения из устройства
+    Codec codecForFileName(const QString& fileName);  // По расширению .gz / .zst
+    bool isAvailable(Codec codec);
+    QString codecName(Codec codec);
+
+    // nullptr для Codec::None: тогда данные читаются/пишутся напрямую
+    std::unique_ptr<QIODevice> createDecoder(Codec codec, QIODevice* source);
+    std::unique_ptr<QIODevice> createEncoder(Codec codec, QIODevice* sink);
+
+    // Чтение прервано ошибкой: повреждённые или оборванные сжатые данные либо ошибка файла.
+    // Текст ошибки — device.errorString()
+    bool hasReadError(const QIODevice& device);
+
+    class GzipDevice : public QIODevice
+    {
+        Q_OBJECT
+    public:
+        explicit GzipDevice(QIODevice* device, int level = Z_DEFAULT_COMPRESSION);
+        ~GzipDevice() override;
+
+        bool open(OpenMode mode) override;
+        void close() override;
+        bool isSequential() const override { return true; }
+        bool atEnd() const override;
+        bool hasError() const { return m_failed; }
+
+    protected:
+        qint64 readData(char* data, qint64 maxSize) override;
+        qint64 writeData(const char* data, qint64 size) override;
+
+    private:
+        int deflateChunk(int flush);
+        qint64 fail(const QString& message);
+
+        QIODevice* m_device;
+        int m_level;
+        z_stream m_stream{};
+        QByteArray m_buffer;
+        bool m_initialized = false;
+        bool m_sourceDrained = false;
+        bool m_memberOpen = false; // Начатый gzip-блок ещё не дочитан до конца
+        bool m_finished = false;
+        bool m_failed = false;     // Ошибка запоминается: дальнейшее чтение сразу возвращает -1
+    };
+
+#ifdef STATVIS_WITH_ZSTD
+    class ZstdDevice : public QIODevice
+    {
+        Q_OBJECT
+    public:
+        explicit ZstdDevice(QIODevice* device, int level = 3);
+        ~ZstdDevice() override;
+
+        bool open(OpenMode mode) override;
+        void close() override;
+        bool isSequential() const override { return true; }
+        bool atEnd() const override;
+        bool hasError() const { return m_failed; }
+
+    protected:
+        qint64 readData(char* data, qint64 maxSize) override;
+        qint64 writeData(const char* data, qint64 size) override;
+
+    private:
+        bool flushOutput(ZSTD_outBuffer& output);
+        qint64 fail(const QString& message);
+
+        QIODevice* m_device;
+        int m_level;
+        ZSTD_DStream* m_dstream = nullptr;
+        ZSTD_CStream* m_cstream = nullptr;
+        QByteArray m_buffer;
+        ZSTD_inBuffer m_input{nullptr, 0, 0};
+        bool m_sourceDrained = false;
+        bool m_frameOpen = false; // Начатый кадр zstd ещё не дочитан до конца
+        bool m_finished = false;
+        bool m_failed = false;
+    };
+#endif
+}
+
+#endif // COMPRESSION_H
@@ -0,0 +1,175 @@
+#include "decimation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Decimation
+{
+    void MinMaxPyramid::mergeInto(const QList<QPointF>& points, Bucket& target, const Bucket& source)
+    {
+        if (points[source.minIndex].y() < points[target.minIndex].y()) target.minIndex = source.minIndex;
+        if (points[source.maxIndex].y() > points[target.maxIndex].y()) target.maxIndex = source.maxIndex;
+    }
+
+    void MinMaxPyramid::build(const QList<QPointF>& points)
+    {
+        clear();
+        append(points, 0);
+    }
+
+    void MinMaxPyramid::append(const QList<QPointF>& points, qsizetype from)
+    {
+        if (from >= points.size()) return;
+        if (m_levels.empty()) m_levels.emplace_back();
+
+        std::vector<Bucket>& base = m_levels[0];
+        for (qsizetype i = from; i < points.size(); ++i) {
+            const size_t bucket = static_cast<size_t>(i / decimationBucketPoints);
+            if (bucket == base.size()) {
+                base.push_back({i, i});
+            } else {
+                mergeInto(points, base[bucket], {i, i});
+            }
+        }
+
+        // Верхние уровни пересчитываются из двух дочерних блоков, начиная с первого затронутого
+        size_t dirty = static_cast<size_t>(from / decimationBucketPoints);
+        for (size_t level = 1; level < m_levels.size() || m_levels[level - 1].size() > 1; ++level) {
+            if (level == m_levels.size()) m_levels.emplace_back();
+            const std::vector<Bucket>& children = m_levels[level - 1];
+            std::vector<Bucket>& parents = m_levels[level];
+
+            dirty /= 2;
+            parents.resize((children.size() + 1) / 2);
+            for (size_t p = dirty; p < parents.size(); ++p) {
+                parents[p] = children[2 * p];
+                if (2 * p + 1 < children.size()) mergeInto(points, parents[p], children[2 * p + 1]);
+            }
+        }
+    }
+
+    void MinMaxPyramid::extremes(const QList<QPointF>& points, qsizetype first, qsizetype last,
+                                 qsizetype& minIndex, qsizetype& maxIndex) const
+    {
+        minIndex = maxIndex = first;
+        auto consider = [&](qsizetype index) {
+            if (points[index].y() < points[minIndex].y()) minIndex = index;
+            if (points[index].y() > points[maxIndex].y()) maxIndex = index;
+        };
+
+        const qsizetype base = decimationBucketPoints;
+        qsizetype i = first;
+        while (i < last) {
+            // Края диапазона, не покрытые целым блоком, просматриваются поточечно
+            if (m_levels.empty() || i % base != 0 || i + base > last
+                || static_cast<size_t>(i / base) >= m_levels[0].size()) {
+                consider(i++);
+                continue;
+            }
+
+            // Самый крупный выровненный блок, целиком лежащий в диапазоне
+            size_t level = 0;
+            while (level + 1 < m_levels.size()) {
+                const qsizetype size = base << (level + 1);
+                if (i % size != 0 || i + size > last) break;
+                ++level;
+            }
+            const Bucket& bucket = m_levels[level][static_cast<size_t>(i / (base << level))];
+            consider(bucket.minIndex);
+            consider(bucket.maxIndex);
+            i += base << level;
+        }
+    }
+
+    QList<QPointF> lttb(const QPointF* points, qsizetype count, int threshold)
+    {
+        if (threshold >= count || threshold < 3) return QList<QPointF>(points, points + count);
+
+        QList<QPointF> sampled;
+        sampled.reserve(threshold);
+        sampled.append(points[0]);
+
+        // Первая и последняя точки сохраняются, остальные делятся на threshold - 2 корзины
+        const double every = static_cast<double>(count - 2) / (threshold - 2);
+        qsizetype anchor = 0;
+        for (int i = 0; i < threshold - 2; ++i) {
+            // Средняя точка следующей корзины — третья вершина треугольника
+            const qsizetype avgStart = static_cast<qsizetype>((i + 1) * every) + 1;
+            const qsizetype avgEnd = qMin(static_cast<qsizetype>((i + 2) * every) + 1, count);
+            double avgX = 0.0;
+            double avgY = 0.0;
+            for (qsizetype j = avgStart; j < avgEnd; ++j) {
+                avgX += points[j].x();
+                avgY += points[j].y();
+            }
+            const double avgCount = static_cast<double>(qMax<qsizetype>(avgEnd - avgStart, 1));
+            avgX /= avgCount;
+            avgY /= avgCount;
+
+            const qsizetype rangeStart = static_cast<qsizetype>(i * every) + 1;
+            const qsizetype rangeEnd = static_cast<qsizetype>((i + 1) * every) + 1;
+            const QPointF& a = points[anchor];
+            double maxArea = -1.0;
+            qsizetype chosen = rangeStart;
+            for (qsizetype j = rangeStart; j < rangeEnd; ++j) {
+                const double area = std::abs((a.x() - avgX) * (points[j].y() - a.y())
+                                             - (a.x() - points[j].x()) * (avgY - a.y()));
+                if (area > maxArea) {
+                    maxArea = area;
+                    chosen = j;
+                }
+            }
+            sampled.append(points[chosen]);
+            anchor = chosen;
+        }
+
+        sampled.append(points[count - 1]);
+        return sampled;
+    }
+
+    QList<QPointF> decimate(const QList<QPointF>& points, const MinMaxPyramid& pyramid,
+                            double xMin, double xMax, int columns)
+    {
+        columns = qMax(columns, 1);
+        const qsizetype budget = 2 * static_cast<qsizetype>(columns);
+        if (points.size() <= budget) return points;
+
+        // Видимый участок и по одной точке за краями, чтобы линия доходила до границ графика
+        auto lessX = [](const QPointF& point, double x) { return point.x() < x; };
+        qsizetype first = std::lower_bound(points.cbegin(), points.cend(), xMin, lessX) - points.cbegin();
+        qsizetype last = std::upper_bound(points.cbegin(), points.cend(), xMax,
+                                          [](double x, const QPointF& point) { return x < point.x(); })
+                         - points.cbegin();
+        first = qMax<qsizetype>(first - 1, 0);
+        last = qMin(last + 1, points.size());
+
+        const qsizetype count = last - first;
+        if (count <= budget) return points.mid(first, count);
+        if (count <= budget * decimationLttbFactor) {
+            return lttb(points.constData() + first, count, static_cast<int>(budget));
+        }
+
+        // Минимум и максимум на каждый столбец пикселей, в порядке X
+        QList<QPointF> result;
+        result.reserve(budget);
+        const double x0 = points[first].x();
+        const double width = points[last - 1].x() - x0;
+        qsizetype begin = first;
+        for (int column = 0; column < columns && begin < last; ++column) {
+            qsizetype end = last;
+            if (column + 1 < columns && width > 0.0) {
+                const double boundary = x0 + width * (column + 1) / columns;
+                end = std::lower_bound(points.cbegin() + begin, points.cbegin() + last, boundary, lessX)
+                      - points.cbegin();
+            }
+            if (end == begin) continue;
+
+            qsizetype minIndex, maxIndex;
+            pyramid.extremes(points, begin, end, minIndex, maxIndex);
+            result.append(points[qMin(minIndex, maxIndex)]);
+            if (minIndex != maxIndex) result.append(points[qMax(minIndex, maxIndex)]);
+            begin = end;
+        }
+        return result;
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef DECIMATION_H
+#define DECIMATION_H
+
+#include <QList>
+#include <QPointF>
+
+#include <vector>
+
+#include "globals.h"
+
+// Прореживание длинных рядов перед передачей графику: на столбец пикселей приходится
+// не больше двух точек (минимум и максимум), поэтому пики не теряются.
+namespace Decimation
+{
+    // Пирамида индексов минимумов и максимумов: уровень k хранит экстремумы блоков
+    // по decimationBucketPoints * 2^k точек. Поддерживает дописывание точек в конец.
+    class MinMaxPyramid
+    {
+    public:
+        void clear() { m_levels.clear(); }
+        void build(const QList<QPointF>& points);
+        void append(const QList<QPointF>& points, qsizetype from); // Точки с индекса from только что дописаны
+
+        // Индексы минимума и максимума среди точек [first, last)
+        void extremes(const QList<QPointF>& points, qsizetype first, qsizetype last,
+                      qsizetype& minIndex, qsizetype& maxIndex) const;
+
+    private:
+        struct Bucket {
+            qsizetype minIndex;
+            qsizetype maxIndex;
+        };
+
+        static void mergeInto(const QList<QPointF>& points, Bucket& target, const Bucket& source);
+
+        std::vector<std::vector<Bucket>> m_levels;
+    };
+
+    // Largest-Triangle-Three-Buckets: threshold точек, сохраняющих форму ряда
+    QList<QPointF> lttb(const QPointF* points, qsizetype count, int threshold);
+
+    // Точки для графика шириной columns пикселей при видимом диапазоне [xMin, xMax].
+    // Точки ряда упорядочены по X; короткий ряд возвращается без изменений.
+    QList<QPointF> decimate(const QList<QPointF>& points, const MinMaxPyramid& pyramid,
+                            double xMin, double xMax, int columns);
+}
+
+#endif // DECIMATION_H
@@ -57,7 +57,12 @@ namespace Draw {
         Draw::setSizePolicyExpanding(table);
         table->setItemDelegate(new NumericDelegate(table));
         table->verticalHeader()->setVisible(false);
-        table->resizeColumnsToContents();
+
+        // Столбцы пустой таблицы по ширине заголовка: то же, что resizeColumnsToContents, без обхода всех столбцов
+        QHeaderView *header = table->horizontalHeader();
+        const int padding = 16;
+        const int width = table->fontMetrics().horizontalAdvance(QString::number(initialColCount)) + padding;
+        header->setDefaultSectionSize(qMax(header->minimumSectionSize(), width));
         return table;
     }
 
@@ -142,18 +147,46 @@ namespace Draw {
         return label;
     }
 
-    // Создание секции с заголовком
-    QWidget *createStatSection(QWidget *parent, const QString &title)
+    // Создание секции с заголовком; щелчок по заголовку сворачивает строки секции.
+    // populate добавляет строки: сразу для развёрнутой секции, для свёрнутой — при первом раскрытии
+    QWidget *createStatSection(QWidget *parent, const QString &title, bool expanded,
+                               const std::function<void(QVBoxLayout *)> &populate)
     {
         QWidget *section = new QWidget(parent);
         QVBoxLayout *layout = new QVBoxLayout(section); // Создаем layout сразу
 
-        QLabel *header = new QLabel(title, section);
-        header->setStyleSheet("font-weight: 600; font-size: 20px; color: #ddd;");
+        QToolButton *header = new QToolButton(section);
+        header->setObjectName("sectionHeader");
+        header->setText(title);
+        header->setCheckable(true);
+        header->setChecked(expanded);
+        header->setArrowType(expanded ? Qt::DownArrow : Qt::RightArrow);
+        header->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
 
         layout->addWidget(header);
         layout->addWidget(createSeparator(true));
 
+        auto pendingRows = std::make_shared<std::function<void(QVBoxLayout *)>>(populate);
+        auto ensureRows = [pendingRows, layout]() {
+            if (!*pendingRows) return;
+            const auto rows = std::exchange(*pendingRows, {});
+            rows(layout);
+        };
+
+        QObject::connect(header, &QToolButton::toggled, section, [header, layout, ensureRows](bool expanded) {
+            if (expanded) ensureRows();
+            header->setArrowType(expanded ? Qt::DownArrow : Qt::RightArrow);
+            for (int i = 1; i < layout->count(); ++i) {
+                if (QWidget *widget = layout->itemAt(i)->widget()) widget->setVisible(expanded);
+            }
+        });
+
+        if (expanded) {
+            ensureRows();
+        } else {
+            layout->itemAt(1)->widget()->setVisible(false); // Разделитель
+        }
+
         return section; // Виджет УЖЕ имеет layout
     }
 
@@ -180,7 +213,8 @@ namespace Draw {
         }
     }
 
-    QGroupBox* createChartSettingsPanel(QWidget* parent, QLineEdit** xAxisEdit, QLineEdit** yAxisEdit) {
+    QGroupBox* createChartSettingsPanel(QWidget* parent, QLineEdit** xAxisEdit, QLineEdit** yAxisEdit,
+                                        QComboBox** rendererCombo) {
         QGroupBox* settingsGroup = new QGroupBox("Настройки визуализации", parent);
         QFormLayout* formLayout = new QFormLayout(settingsGroup);
 
@@ -196,9 +230,18 @@ namespace Draw {
         yEdit->setPlaceholderText("Введите название вертикальной оси");
         formLayout->addRow("Ось Y:", yEdit);
 
+        // Способ отрисовки: QtCharts, быстрый график для больших данных или гистограмма выбранного ряда
+        QComboBox* renderer = new QComboBox(settingsGroup);
+        renderer->setObjectName("rendererCombo");
+        renderer->addItem("QtCharts");
+        renderer->addItem("Быстрая отрисовка");
+        renderer->addItem("Гистограмма");
+        formLayout->addRow("График:", renderer);
+
         // Возвращаем указатели через параметры
         *xAxisEdit = xEdit;
         *yAxisEdit = yEdit;
+        *rendererCombo = renderer;
 
         settingsGroup->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
         return settingsGroup;
@@ -212,6 +255,14 @@ namespace Draw {
         return axis;
     }
 
+    void applyAxisScale(QValueAxis* axis, const PlotPainter::AxisScale& scale) {
+        // Каждая смена диапазона, числа меток или формата заставляет QtCharts заново раскладывать подписи
+        if (axis->min() != scale.min || axis->max() != scale.max) axis->setRange(scale.min, scale.max);
+        if (axis->tickCount() != scale.ticks) axis->setTickCount(scale.ticks);
+        const QString format = QString("%.%1f").arg(scale.decimals);
+        if (axis->labelFormat() != format) axis->setLabelFormat(format);
+    }
+
     QScatterSeries* setupScatterSeries(float size = 12.0, QColor pointColor = Qt::blue, QColor borderColor = Qt::white) {
         QScatterSeries* scatterSeries = new QScatterSeries();
         scatterSeries->setMarkerShape(QScatterSeries::MarkerShapeCircle);
@@ -225,16 +276,30 @@ namespace Draw {
         QWidget* container = new QWidget(parent);
         QVBoxLayout* layout = new QVBoxLayout(container);
 
-        // Создаем и добавляем ChartView
-        QChartView* chartView = new QChartView(new QChart(), container);
+        // ChartView и быстрый график делят одно место, показывается выбранный
+        QStackedWidget* stack = new QStackedWidget(container);
+        QChartView* chartView = new QChartView(new QChart(), stack);
         chartView->setRenderHint(QPainter::Antialiasing);
         chartView->chart()->setTitle("Точечный график");
         chartView->chart()->setBackgroundBrush(Qt::white);
 
-        layout->addWidget(chartView);
+        // Гистограмма добавляется в стек при первом выборе, см. createHistogramView
+        stack->addWidget(chartView);
+        stack->addWidget(new PlotWidget(stack));
+        layout->addWidget(stack);
         return container;
     }
 
+    QChartView* createHistogramView(QWidget* parent) {
+        QChartView* histogramView = new QChartView(new QChart(), parent);
+        histogramView->setObjectName("histogramView");
+        histogramView->setRenderHint(QPainter::Antialiasing);
+        histogramView->chart()->setTitle("Гистограмма");
+        histogramView->chart()->setBackgroundBrush(Qt::white);
+        histogramView->chart()->legend()->hide();
+        return histogramView;
+    }
+
     QSplitter* addSplitter(QWidget* parent, QWidget* w1, QWidget* w2, int stretch1 = 1, int stretch2 = 1) {
         QSplitter* splitter = new QSplitter(Qt::Horizontal, parent);
         splitter->setHandleWidth(10);
@@ -265,7 +330,7 @@ namespace Draw {
     }
 
     QWidget*setupGraphSection(QWidget* parent, QLineEdit** xAxisEdit,
-        QLineEdit** yAxisEdit, QWidget** seriesContent)
+        QLineEdit** yAxisEdit, QListView** seriesView, QComboBox** rendererCombo)
     {
         QWidget* widget = new QWidget(parent);
         widget->setObjectName("graphSection");
@@ -278,8 +343,8 @@ namespace Draw {
         QVBoxLayout* settingsLayout = new QVBoxLayout(settingsContainer);
 
         // Добавляем панели настроек осей и серий
-        settingsLayout->addWidget(createChartSettingsPanel(settingsContainer, xAxisEdit, yAxisEdit));
-        settingsLayout->addWidget(createSeriesSettingsPanel(settingsContainer, seriesContent));
+        settingsLayout->addWidget(createChartSettingsPanel(settingsContainer, xAxisEdit, yAxisEdit, rendererCombo));
+        settingsLayout->addWidget(createSeriesSettingsPanel(settingsContainer, seriesView));
 
         // Создаем разделитель
         QSplitter* splitter = addSplitter(widget, settingsContainer, createChartWidget(widget), 1, 2);
@@ -289,7 +354,7 @@ namespace Draw {
     }
 
     // Создание панели для названий рядов
-    QWidget* createSeriesSettingsPanel(QWidget* parent, QWidget** contentWidget) {
+    QWidget* createSeriesSettingsPanel(QWidget* parent, QListView** seriesView) {
         QWidget* group = new QWidget(parent); // Заменяем QGroupBox на обычный виджет
         QVBoxLayout* groupLayout = new QVBoxLayout(group);
         group->setObjectName("seriesSettingsPanel");
@@ -298,48 +363,20 @@ namespace Draw {
         header->setObjectName("settingsHeader");
         groupLayout->addWidget(header);
 
-        QScrollArea* scrollArea = new QScrollArea(group);
-        scrollArea->setWidgetResizable(true);
-
-        QWidget* container = new QWidget;
-        QVBoxLayout* layout = new QVBoxLayout(container);
-        layout->setAlignment(Qt::AlignTop);
-        layout->setSpacing(6);
-
-        scrollArea->setWidget(container);
-        groupLayout->addWidget(scrollArea);
-
-        *contentWidget = container;
+        // Строки рисует делегат, поэтому стоимость панели не растёт с числом рядов
+        QListView* view = new QListView(group);
+        view->setObjectName("seriesSettingsList");
+        view->setUniformItemSizes(true);
+        view->setSpacing(3);
+        view->setSelectionMode(QAbstractItemView::SingleSelection);
+        view->setEditTriggers(QAbstractItemView::CurrentChanged | QAbstractItemView::DoubleClicked |
+                              QAbstractItemView::SelectedClicked | QAbstractItemView::EditKeyPressed);
+        groupLayout->addWidget(view);
+
+        *seriesView = view;
         return group;
     }
 
-    // Создание строки с полем ввода для конкретного ряда
-    QWidget* createSeriesNameRow(QWidget* parent, int seriesIndex, QLineEdit** edit, QPushButton** minBtn, QPushButton** maxBtn) {
-        QWidget* row = new QWidget(parent);
-        QHBoxLayout* layout = new QHBoxLayout(row);
-        layout->setContentsMargins(0, 0, 0, 0);
-        layout->setSpacing(4);
-
-        // Добавляем кнопки
-        QPushButton* minButton = new QPushButton("MIN", row);
-        QPushButton* maxButton = new QPushButton("MAX", row);
-        minButton->setFixedSize(40, 24);
-        maxButton->setFixedSize(40, 24);
-
-        QLabel* label = new QLabel(QString("График %1:").arg(seriesIndex + 1), row);
-        QLineEdit* lineEdit = new QLineEdit(QString("График %1").arg(seriesIndex + 1), row);
-
-        layout->addWidget(minButton);
-        layout->addWidget(maxButton);
-        layout->addWidget(label);
-        layout->addWidget(lineEdit);
-
-        *edit = lineEdit;
-        *minBtn = minButton;
-        *maxBtn = maxButton;
-        return row;
-    }
-
     void createDataHeader(QWidget *statsPanel, QVBoxLayout *statsLayout)
     {
         QLabel *mainHeader = new QLabel("Анализ данных", statsPanel);
@@ -347,64 +384,26 @@ namespace Draw {
         statsLayout->addWidget(mainHeader);
     }
 
-    QWidget* createBasicDataSection(QWidget *parent, QLabel **elementCountLabel,
-                                                QLabel **sumLabel, QLabel **averageLabel)
-    {
-        QWidget *section = Draw::createStatSection(parent, "Основные метрики");
-        section->setObjectName("statSection");
-        QVBoxLayout *layout = qobject_cast<QVBoxLayout *>(section->layout());
-
-        *elementCountLabel = Draw::createAndRegisterStatRow(section, layout, "Количество элементов", "0", "elementCountLabel");
-        *sumLabel = Draw::createAndRegisterStatRow(section, layout, "Сумма", "0", "sumLabel");
-        *averageLabel = Draw::createAndRegisterStatRow(section, layout, "Среднее арифметическое", "—", "averageLabel");
-
-        return section;
-    }
-
-    QWidget* createMeansSection(QWidget *parent, QLabel **geometricMeanLabel, QLabel **harmonicMeanLabel, QLabel **rmsLabel, QLabel **trimmedMeanLabel)
-    {
-        QWidget *section = Draw::createStatSection(parent, "Средние");
-        QVBoxLayout *layout = qobject_cast<QVBoxLayout *>(section->layout());
-
-        *geometricMeanLabel = Draw::createAndRegisterStatRow(section, layout, "Геом. среднее", "—", "geometricMeanLabel");
-        *harmonicMeanLabel = Draw::createAndRegisterStatRow(section, layout, "Гарм. среднее", "—", "harmonicMeanLabel");
-        *rmsLabel = Draw::createAndRegisterStatRow(section, layout, "Квадр. среднее", "—", "rmsLabel");
-        *trimmedMeanLabel = Draw::createAndRegisterStatRow(section, layout, "Усеч. среднее", "—", "trimmedMeanLabel");
-
-        return section;
-    }
-
-    QWidget* createDistributionSection(QWidget *parent, QLabel **medianLabel, QLabel **modeLabel, QLabel **stdDevLabel,
-                                       QLabel **skewnessLabel, QLabel **kurtosisLabel, QLabel **madLabel,
-                                       QLabel **robustStdLabel, QLabel **shapiroWilkLabel, QLabel **densityLabel,
-                                       QLabel **chiSquareLabel, QLabel **kolmogorovLabel)
-    {
-        QWidget *section = Draw::createStatSection(parent, "Распределение");
-        QVBoxLayout *layout = qobject_cast<QVBoxLayout*>(section->layout());
-
-        *medianLabel = Draw::createAndRegisterStatRow(section, layout, "Медиана", "—", "medianLabel");
-        *modeLabel = Draw::createAndRegisterStatRow(section, layout, "Мода", "—", "modeLabel");
-        *stdDevLabel = Draw::createAndRegisterStatRow(section, layout, "Стандартное отклонение", "—", "stdDevLabel");
-        *skewnessLabel = Draw::createAndRegisterStatRow(section, layout, "Асимметрия", "—", "skewnessLabel");
-        *kurtosisLabel = Draw::createAndRegisterStatRow(section, layout, "Эксцесс", "—", "kurtosisLabel");
-        *madLabel = Draw::createAndRegisterStatRow(section, layout, "Медианное абсолютное отклонение", "—", "madLabel");
-        *robustStdLabel = Draw::createAndRegisterStatRow(section, layout, "Робастный стандартный разброс", "—", "robustStdLabel");
-        *shapiroWilkLabel = Draw::createAndRegisterStatRow(section, layout, "Шапиро-Уилк", "—", "shapiroWilkLabel");
-        *densityLabel = Draw::createAndRegisterStatRow(section, layout, "Плотность", "—", "densityLabel");
-        *chiSquareLabel = Draw::createAndRegisterStatRow(section, layout, "χ²-критерий", "—", "chiSquareLabel");
-        *kolmogorovLabel = Draw::createAndRegisterStatRow(section, layout, "Колмогоров-Смирнов", "—", "kolmogorovLabel");
-
-        return section;
-    }
-
-    QWidget* createExtremesSection(QWidget *parent, QLabel **minLabel, QLabel **maxLabel, QLabel **rangeLabel)
+    QWidget* createMetricSection(QWidget *parent, Metrics::Section sectionId, QVector<QLabel*> &labels,
+                                 bool collapsed, const std::function<void()> &onRowsCreated)
     {
-        QWidget *section = Draw::createStatSection(parent, "Экстремумы");
-        QVBoxLayout *layout = qobject_cast<QVBoxLayout*>(section->layout());
-
-        *minLabel = Draw::createAndRegisterStatRow(section, layout, "Минимум", "—", "minLabel");
-        *maxLabel = Draw::createAndRegisterStatRow(section, layout, "Максимум", "—", "maxLabel");
-        *rangeLabel = Draw::createAndRegisterStatRow(section, layout, "Размах", "—", "rangeLabel");
+        const QList<Metrics::Definition> &definitions = Metrics::registry();
+        labels.resize(definitions.size());
+
+        // Строки метрик секции в порядке реестра; у свёрнутой секции — при первом раскрытии
+        QWidget *section = Draw::createStatSection(parent, Metrics::sectionTitle(sectionId), !collapsed,
+            [&labels, sectionId, onRowsCreated](QVBoxLayout *layout) {
+                const QList<Metrics::Definition> &definitions = Metrics::registry();
+                for (int i = 0; i < definitions.size(); ++i) {
+                    const Metrics::Definition &definition = definitions[i];
+                    if (definition.section != sectionId) continue;
+                    const QString defaultValue = definition.format == Metrics::Format::Count ? "0" : "—";
+                    labels[i] = Draw::createAndRegisterStatRow(layout->parentWidget(), layout, definition.title,
+                                                               defaultValue, definition.objectName);
+                }
+                if (onRowsCreated) onRowsCreated();
+            });
+        if (sectionId == Metrics::Section::Basic) section->setObjectName("statSection");
 
         return section;
     }
@@ -436,4 +435,97 @@ namespace Draw {
 
         return container;
     }
+
+    QDialog* createSummaryDialog(QWidget* parent, const QStringList& seriesHeaders,
+                                 const QList<QList<QPair<QString, QString>>>& seriesMetrics, QPushButton** saveBtn) {
+        QDialog* dialog = new QDialog(parent);
+        dialog->setWindowTitle("Сводка по файлу");
+        dialog->setAttribute(Qt::WA_DeleteOnClose);
+        dialog->resize(800, 600);
+
+        QVBoxLayout* layout = new QVBoxLayout(dialog);
+        layout->addWidget(new QLabel(QString("Рядов: %1").arg(seriesMetrics.size()), dialog));
+
+        const int rows = seriesMetrics.isEmpty() ? 0 : seriesMetrics.first().size();
+        QTableWidget* table = new QTableWidget(rows, seriesMetrics.size(), dialog);
+        table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+        QStringList columnLabels;
+        for (int col = 0; col < seriesMetrics.size(); ++col) {
+            columnLabels << (col < seriesHeaders.size() ? seriesHeaders[col]
+                                                        : "Ряд " + QString::number(col + 1));
+            for (int row = 0; row < rows; ++row) {
+                table->setItem(row, col, new QTableWidgetItem(seriesMetrics[col][row].second));
+            }
+        }
+        QStringList rowLabels;
+        for (int row = 0; row < rows; ++row) {
+            rowLabels << seriesMetrics.first()[row].first;
+        }
+        table->setHorizontalHeaderLabels(columnLabels);
+        table->setVerticalHeaderLabels(rowLabels);
+        layout->addWidget(table, 1);
+
+        QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Close, dialog);
+        *saveBtn = buttons->addButton("Сохранить отчёт", QDialogButtonBox::ActionRole);
+        QObject::connect(buttons, &QDialogButtonBox::rejected, dialog, &QDialog::close);
+        layout->addWidget(buttons);
+
+        return dialog;
+    }
+
+    QDialog* createLazyViewer(QWidget* parent, const QString& title, QAbstractItemModel* model,
+                              QTableView** view, QLabel** statusLabel, QPushButton** metricsBtn) {
+        QDialog* dialog = new QDialog(parent);
+        dialog->setWindowTitle(title);
+        dialog->setAttribute(Qt::WA_DeleteOnClose);
+        dialog->resize(1000, 700);
+
+        QVBoxLayout* layout = new QVBoxLayout(dialog);
+
+        *view = new QTableView(dialog);
+        (*view)->setModel(model);
+        (*view)->setSelectionBehavior(QAbstractItemView::SelectRows);
+        (*view)->setSelectionMode(QAbstractItemView::SingleSelection);
+        // Фиксированные размеры секций: заголовки не опрашивают каждую строку модели
+        (*view)->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        (*view)->horizontalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        layout->addWidget(*view, 1);
+
+        QHBoxLayout* bottom = new QHBoxLayout();
+        *statusLabel = new QLabel("Индексация...", dialog);
+        *metricsBtn = new QPushButton("Метрики выбранного ряда", dialog);
+        bottom->addWidget(*statusLabel, 1);
+        bottom->addWidget(*metricsBtn);
+        layout->addLayout(bottom);
+
+        return dialog;
+    }
+
+    QDialog* createStatsMatrixDialog(QWidget* parent, QAbstractItemModel* model) {
+        QDialog* dialog = new QDialog(parent);
+        dialog->setWindowTitle("Метрики всех рядов");
+        dialog->setAttribute(Qt::WA_DeleteOnClose);
+        dialog->resize(1000, 600);
+
+        QVBoxLayout* layout = new QVBoxLayout(dialog);
+
+        QTableView* view = new QTableView(dialog);
+        view->setObjectName("statsMatrixView");
+        view->setModel(model);
+        view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        view->setSelectionBehavior(QAbstractItemView::SelectRows);
+        view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        view->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+        // Без индикатора сортировки строки идут в порядке рядов таблицы
+        view->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+        view->setSortingEnabled(true);
+        layout->addWidget(view, 1);
+
+        QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Close, dialog);
+        QObject::connect(buttons, &QDialogButtonBox::rejected, dialog, &QDialog::close);
+        layout->addWidget(buttons);
+
+        return dialog;
+    }
 }
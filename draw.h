@@ -5,6 +5,8 @@
 #include "export.h"
 #include "globals.h"
 #include "numericDelegate.h"
+#include "plotWidget.h"
+#include "metrics.h"
 
 #include <QHBoxLayout>
 #include <QSpinBox>
@@ -33,6 +35,16 @@
 #include <QLegendMarker>
 #include <QScrollBar>
 #include <QComboBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QTableView>
+#include <QStackedWidget>
+#include <QToolButton>
+#include <QListView>
+
+#include <functional>
+#include <memory>
+#include <utility>
 
 namespace Draw
 {
@@ -57,8 +69,7 @@ namespace Draw
         QObject::connect(button, &QPushButton::clicked,
                          button, std::forward<Func>(callback));
     }
-    QWidget* createSeriesSettingsPanel(QWidget* parent, QWidget** contentWidget);
-    QWidget* createSeriesNameRow(QWidget* parent, int seriesIndex, QLineEdit** edit, QPushButton** minBtn, QPushButton** maxBtn);
+    QWidget* createSeriesSettingsPanel(QWidget* parent, QListView** seriesView);
     void setSizePolicyExpanding(QWidget *w);
     void setSizePolicyFixed(QWidget *w);
     void setupTableActions();
@@ -72,21 +83,28 @@ namespace Draw
     QPushButton *createToolButton(const QString &tooltip, const QString &iconName);
     QWidget *createStatRow(QWidget *parent, const QString &title, const QString &value, const QString &objectName);
     QLabel *createAndRegisterStatRow(QWidget *parent, QLayout *layout, const QString &title, const QString &defaultValue, const QString &objectName);
-    QWidget *createStatSection(QWidget *parent, const QString &title);     // Создание секции с заголовком
+    QWidget *createStatSection(QWidget *parent, const QString &title, bool expanded = true,
+                               const std::function<void(QVBoxLayout *)> &populate = {}); // Создание секции с заголовком
     void addStatRows(QWidget *parent, QLayout *layout, const std::initializer_list<QPair<QString, QString>> &rows);
     void updateStatValue(QWidget *section, const QString &title, const QString &value);
-    QWidget* setupGraphSection(QWidget* parent, QLineEdit** xAxisEdit, QLineEdit** yAxisEdit, QWidget** seriesContent);
+    QChartView* createHistogramView(QWidget* parent); // Страница гистограммы, создаётся при первом выборе
+    QWidget* setupGraphSection(QWidget* parent, QLineEdit** xAxisEdit, QLineEdit** yAxisEdit, QListView** seriesView,
+                               QComboBox** rendererCombo);
     QValueAxis* setupAxis(QString name, int a, int b);
+    void applyAxisScale(QValueAxis* axis, const PlotPainter::AxisScale& scale); // Меняет только отличающиеся свойства
     QSplitter* addSplitter(QWidget* parent, QWidget* w1, QWidget* w2, int stretch1, int stretch2);
-    QWidget* createExtremesSection(QWidget *parent, QLabel **minLabel, QLabel **maxLabel, QLabel **rangeLabel);
-    QWidget* createDistributionSection(QWidget *parent, QLabel **medianLabel, QLabel **modeLabel, QLabel **stdDevLabel,
-                                       QLabel **skewnessLabel, QLabel **kurtosisLabel, QLabel **madLabel,
-                                       QLabel **robustStdLabel, QLabel **shapiroWilkLabel, QLabel **densityLabel,
-                                       QLabel **chiSquareLabel, QLabel **kolmogorovLabel);
-    QWidget* createMeansSection(QWidget *parent, QLabel **geometricMeanLabel, QLabel **harmonicMeanLabel, QLabel **rmsLabel, QLabel **trimmedMeanLabel);
-    QWidget* createBasicDataSection(QWidget *parent, QLabel **elementCountLabel, QLabel **sumLabel, QLabel **averageLabel);
+    QWidget* createMetricSection(QWidget *parent, Metrics::Section section, QVector<QLabel*> &labels,
+                                 bool collapsed = false, const std::function<void()> &onRowsCreated = {}); // Строки метрик секции из реестра
     QScrollArea *setupDataSectionScrollArea(QWidget *parent, QWidget *toScroll);
     QWidget* createRowSelectionWidget(QWidget* parent, QComboBox** comboBox, QLabel** label);
+    // Таблица "метрика × ряд" для сводки, посчитанной без загрузки данных
+    QDialog* createSummaryDialog(QWidget* parent, const QStringList& seriesHeaders,
+                                 const QList<QList<QPair<QString, QString>>>& seriesMetrics, QPushButton** saveBtn);
+    // Окно ленивого просмотра: таблица поверх модели, строка состояния и кнопка метрик выбранного ряда
+    QDialog* createLazyViewer(QWidget* parent, const QString& title, QAbstractItemModel* model,
+                              QTableView** view, QLabel** statusLabel, QPushButton** metricsBtn);
+    // Таблица "ряд × метрика" для всех рядов таблицы; щелчок по заголовку столбца сортирует
+    QDialog* createStatsMatrixDialog(QWidget* parent, QAbstractItemModel* model);
 };
 
 #endif // DRAW_H
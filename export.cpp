@@ -2,61 +2,92 @@
 
 namespace Export
 {
-    QList<QVector<double>> collectRowsData(QTableWidget *table)
+    TableMetrics calculateTableMetrics(QTableWidget *table)
     {
-        QList<QVector<double>> rowsData;
+        TableMetrics metrics{0, true};
+
         for (int row = 0; row < table->rowCount(); ++row)
         {
-            QVector<double> rowData;
+            int lastNonEmptyCol = -1;
             for (int col = 0; col < table->columnCount(); ++col)
             {
                 if (auto *item = table->item(row, col); item && !item->text().isEmpty())
                 {
-                    bool ok;
-                    double value = item->text().toDouble(&ok);
-                    if (ok) rowData.append(value);
+                    lastNonEmptyCol = col;
+                    metrics.allEmpty = false;
                 }
             }
-            if (!rowData.isEmpty()) rowsData.append(rowData);
+            metrics.maxNonEmptyCols = qMax(metrics.maxNonEmptyCols, lastNonEmptyCol + 1);
         }
-        return rowsData;
+        return metrics;
     }
 
-    TableMetrics calculateTableMetrics(QTableWidget *table)
+    // Блок рядов, снятый с таблицы в GUI-потоке для фонового форматирования.
+    // Все ячейки таблицы хранят текст: он копируется в файл так, как введён
+    struct RowBlock {
+        QVector<QVector<QString>> rows; // Пустая строка — пустая ячейка
+        qint64 firstRow = 0;            // Номер первого ряда блока среди записанных строк
+    };
+
+    // Текст блока и готовые части трейлера для рядов, в которых есть числа
+    struct FormattedBlock {
+        QByteArray text;
+        QByteArray records;          // Строки раздела StatsTrailer
+        QVector<QByteArray> metrics; // По индексу Metrics::registry(): значения рядов блока через ", "
+    };
+
+    // Общее состояние фонового экспорта
+    struct ExportState {
+        bool failed = false;
+        QString error; // Пусто — общая ошибка записи
+    };
+
+    bool isEmptyCell(const QString &text)
     {
-        TableMetrics metrics{0, true};
+        return QStringView(text).trimmed().isEmpty();
+    }
 
-        for (int row = 0; row < table->rowCount(); ++row)
+    int lastNonEmptyColumn(QTableWidget *table, int firstRow, int lastRow)
+    {
+        int last = -1;
+        for (int row = firstRow; row < qMin(lastRow, table->rowCount()); ++row)
         {
-            int lastNonEmptyCol = -1;
-            for (int col = 0; col < table->columnCount(); ++col)
+            for (int col = table->columnCount() - 1; col > last; --col)
             {
-                if (auto *item = table->item(row, col); item && !item->text().isEmpty())
+                if (auto *item = table->item(row, col); item && !isEmptyCell(item->text()))
                 {
-                    lastNonEmptyCol = col;
-                    metrics.allEmpty = false;
+                    last = col;
+                    break;
                 }
             }
-            metrics.maxNonEmptyCols = qMax(metrics.maxNonEmptyCols, lastNonEmptyCol + 1);
         }
-        return metrics;
+        return last;
     }
 
-    QStringList prepareTableRows(QTableWidget *table, int columns)
+    RowBlock snapshotRows(QTableWidget *table, int firstRow, int lastRow, int columns)
     {
-        QStringList rows;
-        for (int row = 0; row < table->rowCount(); ++row)
+        RowBlock block;
+        const int usedColumns = qMin(columns, table->columnCount());
+        for (int row = firstRow; row < qMin(lastRow, table->rowCount()); ++row)
         {
-            QStringList rowData;
-            for (int col = 0; col < columns; ++col)
+            QVector<QString> cells(columns);
+            bool hasValue = false;
+            for (int col = 0; col < usedColumns; ++col)
             {
-                auto *item = table->item(row, col);
-                rowData << (item && !item->text().isEmpty() ? item->text().trimmed() : "-");
+                if (auto *item = table->item(row, col))
+                {
+                    const QString text = item->text();
+                    if (!isEmptyCell(text))
+                    {
+                        cells[col] = text;
+                        hasValue = true;
+                    }
+                }
             }
-            if (!rowData.join("").remove("-").isEmpty())
-                rows << rowData.join(" ");
+            if (hasValue)
+                block.rows.append(std::move(cells));
         }
-        return rows;
+        return block;
     }
 
     QStringList getHeaderLabels(QTableWidget *table, int columns)
@@ -72,168 +103,407 @@ namespace Export
         return headers;
     }
 
-    bool writeFileContent(const QString &path,
-                          const QList<QPair<QString, QString>> &metrics,
-                          const QStringList &data,
-                          const QStringList &seriesHeaders)
+    bool writeExportFile(const QString &path, const std::function<bool(BufferedWriter &)> &writeBody)
     {
-        QFile file(path);
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        // Сжатие выбирается по расширению: .gz или .zst
+        const Compression::Codec codec = Compression::codecForFileName(path);
+        if (!Compression::isAvailable(codec))
+            return false;
+
+        // Запись идёт во временный файл, который заменяет целевой только после успешного commit
+        QSaveFile file(path);
+        const QIODevice::OpenMode mode = codec == Compression::Codec::None
+                                             ? QIODevice::WriteOnly | QIODevice::Text
+                                             : QIODevice::WriteOnly;
+        if (!file.open(mode))
+            return false;
+
+        const std::unique_ptr<QIODevice> encoder = Compression::createEncoder(codec, &file);
+        if (codec != Compression::Codec::None && !encoder)
+        {
+            file.cancelWriting();
+            return false;
+        }
+
+        bool completed = false;
+        {
+            BufferedWriter out(encoder ? encoder.get() : static_cast<QIODevice *>(&file));
+            completed = writeBody(out) && out.flush();
+        }
+        if (encoder) encoder->close();
+
+        if (!completed)
+        {
+            file.cancelWriting();
             return false;
+        }
+        return file.commit();
+    }
 
-        QTextStream out(&file);
-        out.setEncoding(QStringConverter::Utf8);
+    void writeSeriesHeaders(BufferedWriter &out, const QStringList &seriesHeaders)
+    {
+        out.write(QStringView(u"\n# Заголовки рядов\n"));
+        out.write(seriesHeaders.join(", "));
+        out.put('\n');
+    }
 
-        // Запись данных
-        for (const auto &row : data)
-            out << row << "\n";
-        out << "\n\n\n";
+    void writeTrailer(BufferedWriter &out, const QList<QPair<QString, QString>> &metrics, const QStringList &seriesHeaders)
+    {
+        out.write("\n\n\n", 3);
 
         // Запись метрик
         for (const auto &[name, value] : metrics)
-            out << name << ": " << value << "\n";
+        {
+            out.write(name);
+            out.write(": ", 2);
+            out.write(value);
+            out.put('\n');
+        }
+
+        writeSeriesHeaders(out, seriesHeaders);
+    }
+
+    bool writeFileContent(const QString &path,
+                          const QList<QPair<QString, QString>> &metrics,
+                          const RowsWriter &writeRows,
+                          const QStringList &seriesHeaders)
+    {
+        return writeExportFile(path, [&](BufferedWriter &out) {
+            if (writeRows)
+                writeRows(out);
+            writeTrailer(out, metrics, seriesHeaders);
+            return true;
+        });
+    }
+
+    // Фоновая часть: текст ячеек блока без изменений, метрики и статистики его рядов
+    FormattedBlock formatBlock(const RowBlock &block)
+    {
+        FormattedBlock result;
+        result.metrics.resize(Metrics::count());
+        QBuffer buffer(&result.text);
+        buffer.open(QIODevice::WriteOnly);
+        BufferedWriter out(&buffer, exportBufferBytes / 16);
+        QBuffer recordBuffer(&result.records);
+        recordBuffer.open(QIODevice::WriteOnly);
+        BufferedWriter records(&recordBuffer, exportBufferBytes / 16);
+
+        std::vector<double> values;
+        for (qsizetype row = 0; row < block.rows.size(); ++row)
+        {
+            const QVector<QString> &cells = block.rows[row];
+            values.clear();
+            for (int col = 0; col < cells.size(); ++col)
+            {
+                if (col > 0) out.put(' ');
+                const QString &text = cells[col];
+                if (text.isEmpty())
+                {
+                    out.put('-');
+                    continue;
+                }
+                out.write(QStringView(text).trimmed());
+                bool ok;
+                const double number = text.toDouble(&ok);
+                if (ok) values.push_back(number);
+            }
+            out.put('\n');
 
-        // Запись заголовков рядов
-        out << "\n# Заголовки рядов\n"
-            << seriesHeaders.join(", ") << "\n";
+            if (!values.empty())
+            {
+                // Метрики трейлера форматируются из уже посчитанных значений, без повторного расчёта
+                StatsTrailer::SeriesRecord record = StatsTrailer::makeRecord(values);
+                record.row = block.firstRow + row;
+                StatsTrailer::writeRecord(records, record);
+                for (int i = 0; i < result.metrics.size(); ++i)
+                {
+                    if (!result.metrics[i].isEmpty()) result.metrics[i] += ", ";
+                    result.metrics[i] += Metrics::formatExport(i, record.metrics[i]).toUtf8();
+                }
+            }
+        }
+        out.flush();
+        records.flush();
+        return result;
+    }
 
+    // Часть трейлера, растущая с числом рядов, копится во временном файле, а не в памяти
+    bool appendToSpool(QTemporaryFile &spool, const QByteArray &bytes, bool separate)
+    {
+        if (bytes.isEmpty()) return true;
+        if (separate && spool.pos() > 0 && spool.write(", ", 2) != 2) return false;
+        return spool.write(bytes) == bytes.size();
+    }
+
+    bool copySpool(QTemporaryFile &spool, BufferedWriter &out)
+    {
+        if (!spool.flush() || !spool.seek(0)) return false;
+        while (!spool.atEnd())
+        {
+            const QByteArray chunk = spool.read(exportBufferBytes);
+            if (chunk.isEmpty()) return false;
+            out.write(QByteArrayView(chunk));
+        }
         return true;
     }
 
-    QList<QPair<QString, std::function<QString(const QVector<double>&)>>> createMetricHandlers() {
-        const int precision = 2; // Единый формат для всех числовых значений
-        const QString na = "N/A"; // Обозначение для отсутствующих данных
+    // Выполняет function в GUI-потоке и ждёт её, проверяя отмену. Без BlockingQueuedConnection:
+    // окно может отменить экспорт и дождаться его в деструкторе, не попадая во взаимную блокировку.
+    // false — экспорт отменён; брошенный вызов уже не выполнится
+    bool callOnGuiThread(QObject *context, QPromise<void> &promise, const std::function<void()> &function)
+    {
+        struct Call {
+            QMutex mutex;
+            QSemaphore done;
+            bool abandoned = false;
+        };
+        auto call = std::make_shared<Call>();
+        QMetaObject::invokeMethod(context, [call, function]() {
+            QMutexLocker locker(&call->mutex);
+            if (!call->abandoned)
+                function();
+            call->done.release();
+        }, Qt::QueuedConnection);
 
-        auto safeCall = [na](auto func, const auto& data, auto... args) -> QString {
-            if(data.isEmpty()) return na;
-            try {
-                std::vector<double> vec(data.begin(), data.end());
-                return QString::number(func(vec, args...), 'f', precision);
-            } catch(...) {
-                return na;
+        while (!call->done.tryAcquire(1, 50))
+        {
+            if (promise.isCanceled())
+            {
+                QMutexLocker locker(&call->mutex);
+                call->abandoned = true;
+                return false;
             }
+        }
+        return true;
+    }
+
+    // Снимки блоков делаются в GUI-потоке короткими порциями, форматирование и метрики — параллельно,
+    // блоки пишутся в файл в исходном порядке
+    void runExport(QPromise<void> &promise, QTableWidget *table, const QString &fileName,
+                   const QStringList &seriesHeaders, std::shared_ptr<ExportState> state)
+    {
+        auto onGuiThread = [&](const std::function<void()> &function) {
+            return callOnGuiThread(table, promise, function);
         };
 
-        return {
-            {"Количество элементов", [na](const QVector<double>& data) {
-                 return data.isEmpty() ? na : QString::number(data.size());
-             }},
-            {"Сумма", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::getSum, data);
-             }},
-            {"Среднее арифметическое", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::getMean, data);
-             }},
-            {"Геометрическое среднее", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::geometricMean, data);
-             }},
-            {"Гармоническое среднее", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::harmonicMean, data);
-             }},
-            {"Квадратичное среднее", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::rootMeanSquare, data);
-             }},
-            {"Усечённое среднее", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::trimmedMean, data, trimmedMeanPercentage);
-             }},
-            {"Медиана", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::getMedian, data);
-             }},
-            {"Мода", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::getMode, data);
-             }},
-            {"Стандартное отклонение", [=](const QVector<double>& data) {
-                 std::vector<double> vec(data.begin(), data.end());
-                 const double mean = Calculate::getMean(vec);
-                 return safeCall(Calculate::getStandardDeviation, data, mean);
-             }},
-            {"Асимметрия", [=](const QVector<double>& data) {
-                 std::vector<double> vec(data.begin(), data.end());
-                 const double mean = Calculate::getMean(vec);
-                 const double stdDev = Calculate::getStandardDeviation(vec, mean);
-                 return safeCall(Calculate::skewness, data, mean, stdDev);
-             }},
-            {"Эксцесс", [=](const QVector<double>& data) {
-                 std::vector<double> vec(data.begin(), data.end());
-                 const double mean = Calculate::getMean(vec);
-                 const double stdDev = Calculate::getStandardDeviation(vec, mean);
-                 return safeCall(Calculate::kurtosis, data, mean, stdDev);
-             }},
-            {"Медианное абс. отклонение", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::medianAbsoluteDeviation, data);
-             }},
-            {"Робастное стан. отклонение", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::robustStandardDeviation, data);
-             }},
-            {"Тест Шапиро-Уилка", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::shapiroWilkTest, data);
-             }},
-            {"Плотность распределения", [=](const QVector<double>& data) {
-                 if(data.isEmpty()) return na;
-                 std::vector<double> vec(data.begin(), data.end());
-                 const double mean = Calculate::getMean(vec);
-                 return safeCall(Calculate::calculateDensity, data, mean);
-             }},
-            {"χ²-критерий", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::chiSquareTest, data);
-             }},
-            {"Критерий Колмогорова-Смирнова", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::kolmogorovSmirnovTest, data);
-             }},
-            {"Минимум", [=](const QVector<double>& data) {
-                 if(data.isEmpty()) return na;
-                 return QString::number(*std::min_element(data.begin(), data.end()), 'f', precision);
-             }},
-            {"Максимум", [=](const QVector<double>& data) {
-                 if(data.isEmpty()) return na;
-                 return QString::number(*std::max_element(data.begin(), data.end()), 'f', precision);
-             }},
-            {"Размах", [=](const QVector<double>& data) {
-                 if(data.isEmpty()) return na;
-                 const auto [min, max] = std::minmax_element(data.begin(), data.end());
-                 return QString::number(*max - *min, 'f', precision);
-             }}
+        int rowCount = 0;
+        if (!onGuiThread([&]() { rowCount = table->rowCount(); })) return;
+        const int totalRows = qMax(1, rowCount);
+        promise.setProgressRange(0, 1000);
+
+        // Первый проход: ширина данных, до которой ряды дополняются "-"
+        const int blocksPerStep = qMax(1, QThread::idealThreadCount());
+        const int stepRows = blocksPerStep * exportBlockRows;
+        int lastColumn = -1;
+        for (int first = 0; first < rowCount; first += stepRows)
+        {
+            if (!onGuiThread([&]() { lastColumn = qMax(lastColumn, lastNonEmptyColumn(table, first, first + stepRows)); }))
+                return;
+            promise.setProgressValue(static_cast<int>(100LL * first / totalRows));
+        }
+        const int columns = lastColumn + 1;
+
+        // Память экспорта не растёт с таблицей: записи рядов и строки метрик трейлера
+        // копятся во временных файлах и дописываются после данных
+        QTemporaryFile recordSpool;
+        std::vector<std::unique_ptr<QTemporaryFile>> metricSpools;
+        bool spoolsOpen = recordSpool.open();
+        for (int i = 0; i < Metrics::count(); ++i)
+        {
+            metricSpools.push_back(std::make_unique<QTemporaryFile>());
+            spoolsOpen = spoolsOpen && metricSpools.back()->open();
+        }
+        if (!spoolsOpen)
+        {
+            state->failed = true;
+            return;
+        }
+
+        StatsTrailer::Checksum checksum;
+        qint64 writtenRows = 0;
+        const bool written = writeExportFile(fileName, [&](BufferedWriter &out) {
+            for (int first = 0; first < rowCount; first += stepRows)
+            {
+                QList<RowBlock> blocks;
+                const bool taken = onGuiThread([&]() {
+                    for (int block = 0; block < blocksPerStep; ++block)
+                    {
+                        const int blockFirst = first + block * exportBlockRows;
+                        blocks.append(snapshotRows(table, blockFirst, blockFirst + exportBlockRows, columns));
+                    }
+                });
+                if (!taken) return false;
+                for (RowBlock &block : blocks)
+                {
+                    block.firstRow = writtenRows;
+                    writtenRows += block.rows.size();
+                }
+
+                const QList<FormattedBlock> formatted = QtConcurrent::blockingMapped<QList<FormattedBlock>>(
+                    blocks, [](const RowBlock &block) { return formatBlock(block); });
+                for (const FormattedBlock &block : formatted)
+                {
+                    out.write(QByteArrayView(block.text));
+                    checksum.update(block.text.constData(), block.text.size());
+                    if (!appendToSpool(recordSpool, block.records, false)) return false;
+                    for (int i = 0; i < block.metrics.size(); ++i)
+                    {
+                        if (!appendToSpool(*metricSpools[i], block.metrics[i], true)) return false;
+                    }
+                }
+                promise.setProgressValue(100 + static_cast<int>(900LL * qMin(first + stepRows, rowCount) / totalRows));
+            }
+
+            // Тот же трейлер, что у writeTrailer, но значения метрик берутся из временных файлов
+            out.write("\n\n\n", 3);
+            const QList<Metrics::Definition> &definitions = Metrics::registry();
+            for (int i = 0; i < definitions.size(); ++i)
+            {
+                out.write(definitions[i].name);
+                out.write(": ", 2);
+                if (!copySpool(*metricSpools[i], out)) return false;
+                out.put('\n');
+            }
+            writeSeriesHeaders(out, seriesHeaders);
+
+            checksum.update("\n\n\n", 3); // Разделитель входит в сумму так же, как его читает импорт
+            StatsTrailer::writeSectionStart(out);
+            if (!copySpool(recordSpool, out)) return false;
+            StatsTrailer::writeChecksum(out, checksum.value());
+            return !promise.isCanceled();
+        });
+
+        if (!written && !promise.isCanceled())
+            state->failed = true;
+    }
+
+    // Рабочее пространство: таблица снимается числами теми же порциями, файл пишется в рабочем потоке
+    void runWorkspaceExport(QPromise<void> &promise, QTableWidget *table, const QString &fileName,
+                            std::shared_ptr<ExportState> state)
+    {
+        auto onGuiThread = [&](const std::function<void()> &function) {
+            return callOnGuiThread(table, promise, function);
         };
+
+        Workspace::WorkspaceData data;
+        int rowCount = 0;
+        if (!onGuiThread([&]() {
+                rowCount = table->rowCount();
+                Workspace::collectTitles(table, data);
+            }))
+            return;
+        promise.setProgressRange(0, 1000);
+
+        const int stepRows = qMax(1, QThread::idealThreadCount()) * exportBlockRows;
+        for (int first = 0; first < rowCount; first += stepRows)
+        {
+            if (!onGuiThread([&]() { Workspace::collectRows(table, first, first + stepRows, data); }))
+                return;
+            promise.setProgressValue(static_cast<int>(900LL * qMin(first + stepRows, rowCount) / qMax(1, rowCount)));
+        }
+        if (promise.isCanceled()) return;
+
+        QString error;
+        if (!Workspace::save(fileName, data, &error))
+        {
+            state->failed = true;
+            state->error = error;
+        }
+        promise.setProgressValue(1000);
     }
 
-    QList<QPair<QString, QString>> calculateAllMetrics(const QList<QVector<double>>& rowsData) {
-        const auto handlers = createMetricHandlers();
-        QList<QPair<QString, QString>> metrics;
+    QFuture<void> exportInBackground(QTableWidget *table, const QString &fileName, const QStringList &seriesHeaders)
+    {
+        auto *progress = new QProgressDialog("Экспорт данных...", "Отмена", 0, 1000, table->window());
+        progress->setWindowModality(Qt::NonModal); // Окно остаётся доступным во время экспорта
+        progress->setMinimumDuration(500);
+        progress->setAutoReset(false);
+
+        auto *watcher = new QFutureWatcher<void>(table);
+        auto state = std::make_shared<ExportState>();
 
-        for (const auto& handler : handlers) {
-            QStringList values;
-            for (const auto& rowData : rowsData) {
-                values << handler.second(rowData);
+        // Снимки берутся порциями, поэтому на время экспорта все действия, меняющие таблицу, отключены
+        MainWindow *mainWindow = qobject_cast<MainWindow *>(table->window());
+        if (mainWindow)
+            mainWindow->setTableLocked(true);
+
+        QObject::connect(watcher, &QFutureWatcherBase::progressValueChanged, progress, &QProgressDialog::setValue);
+        QObject::connect(progress, &QProgressDialog::canceled, watcher, &QFutureWatcherBase::cancel);
+        QObject::connect(watcher, &QFutureWatcherBase::finished, table, [=]() {
+            if (mainWindow)
+                mainWindow->setTableLocked(false);
+            progress->close();
+            if (state->failed) {
+                QMessageBox::critical(table, "Ошибка", state->error.isEmpty() ? QString("Ошибка записи файла!") : state->error);
+            } else if (!watcher->isCanceled()) {
+                QMessageBox::information(table, "Успех", "Данные экспортированы!");
             }
-            metrics.append({handler.first, values.join(", ")});
+            progress->deleteLater();
+            watcher->deleteLater();
+        });
+
+        const bool workspace = QFileInfo(fileName).suffix() == Workspace::fileSuffix;
+        const QFuture<void> future = QtConcurrent::run([=](QPromise<void> &promise) {
+            if (workspace)
+                runWorkspaceExport(promise, table, fileName, state);
+            else
+                runExport(promise, table, fileName, seriesHeaders, state);
+        });
+        watcher->setFuture(future);
+        return future;
+    }
+
+    QList<QPair<QString, QString>> summaryMetrics(const Calculate::SeriesSummary& summary) {
+        // Пока ряд не длиннее MAX_SAMPLE_SIZE, метрики совпадают с таблицей до последнего знака;
+        // у длинного ряда моменты точные, порядковые статистики и критерии — по скетчу
+        const bool exact = summary.isExact();
+        const std::vector<double> values = exact ? Metrics::evaluate(summary.exactValues())
+                                                 : Metrics::evaluateSketch(summary);
+        const QList<Metrics::Definition>& definitions = Metrics::registry();
+        QList<QPair<QString, QString>> metrics;
+        for (int i = 0; i < definitions.size(); ++i) {
+            const bool available = exact ? !summary.exactValues().empty() : static_cast<bool>(definitions[i].sketch);
+            metrics.append({definitions[i].name, available ? Metrics::formatExport(i, values[i]) : QString("N/A")});
         }
         return metrics;
     }
 
-    bool processExportDialog(const QString& fileName,
-                             const QList<QPair<QString, QString>>& metrics,
-                             const QStringList& tableData,
-                             const QStringList& seriesHeaders) {
-        if (fileName.isEmpty()) return false;
-        return writeFileContent(fileName, metrics, tableData, seriesHeaders);
+    QString exportFilters() {
+        QStringList filters = {"Текстовый файл (*.txt)", "CSV (*.csv)", "Текстовый файл, gzip (*.txt.gz)"};
+        if (Compression::isAvailable(Compression::Codec::Zstd))
+            filters << "Текстовый файл, zstd (*.txt.zst)";
+        filters << "Рабочее пространство (*.glws)";
+        return filters.join(";;");
     }
 
-    void exportData(QTableWidget* table, const QList<QPair<QString, QString>>& /*metrics*/) {
+    bool hasNumericData(QTableWidget *table)
+    {
+        for (int row = 0; row < table->rowCount(); ++row)
+        {
+            for (int col = 0; col < table->columnCount(); ++col)
+            {
+                if (auto *item = table->item(row, col))
+                {
+                    bool ok;
+                    item->text().toDouble(&ok);
+                    if (ok) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    QFuture<void> exportData(QTableWidget* table) {
         if (!table) {
             QMessageBox::critical(nullptr, "Ошибка", "Таблица не инициализирована!");
-            return;
+            return {};
         }
 
-        const auto rowsData = collectRowsData(table);
-        if (rowsData.isEmpty()) {
+        if (!hasNumericData(table)) {
             QMessageBox::warning(nullptr, "Ошибка", "Нет данных для экспорта!");
-            return;
+            return {};
         }
 
-        const auto metrics = calculateAllMetrics(rowsData);
-        const TableMetrics tableMetrics = calculateTableMetrics(table);
-        const auto tableData = prepareTableRows(table, tableMetrics.maxNonEmptyCols);
-
         // Получаем заголовки рядов из MainWindow
         MainWindow* mainWindow = qobject_cast<MainWindow*>(table->window());
         QStringList seriesHeaders;
@@ -242,12 +512,9 @@ namespace Export
         }
 
         const QString fileName = QFileDialog::getSaveFileName(
-            nullptr, "Экспорт данных", "", "Текстовый файл (*.txt);;CSV (*.csv)");
+            nullptr, "Экспорт данных", "", exportFilters());
+        if (fileName.isEmpty()) return {};
 
-        if (processExportDialog(fileName, metrics, tableData, seriesHeaders)) {
-            QMessageBox::information(nullptr, "Успех", "Данные экспортированы!");
-        } else if (!fileName.isEmpty()) {
-            QMessageBox::critical(nullptr, "Ошибка", "Ошибка записи файла!");
-        }
+        return exportInBackground(table, fileName, seriesHeaders);
     }
 }
@@ -12,12 +12,33 @@
 #include <QString>
 #include <QPair>
 #include <QHash>
+#include <QSaveFile>
+#include <QBuffer>
+#include <QTemporaryFile>
+#include <QThread>
+#include <QProgressDialog>
+#include <QFutureWatcher>
+#include <QMutex>
+#include <QSemaphore>
+#include <QPromise>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtConcurrent/QtConcurrentMap>
 
 #include <algorithm>
 #include <numeric>
 #include "calculate.h"
+#include "accumulators.h"
 #include "globals.h"
 #include "mainwindow.h"
+#include "workspace.h"
+#include "compression.h"
+#include "bufferedWriter.h"
+#include "statsTrailer.h"
+#include "metrics.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
 
 struct TableMetrics {
     int maxNonEmptyCols;
@@ -26,13 +47,16 @@ struct TableMetrics {
 
 
 namespace Export {
+    using RowsWriter = std::function<void(BufferedWriter&)>; // Пишет ряды данных перед метриками
+
     TableMetrics calculateTableMetrics(QTableWidget *table);
-    QStringList prepareTableRows(QTableWidget *table, int columns);
     QStringList getHeaderLabels(QTableWidget *table, int columns);
-    bool processExportDialog(const QString& fileName, const QList<QPair<QString, QString>>& metrics,
-                             const QStringList& tableData, const QStringList& seriesHeaders);
-    void exportData(QTableWidget *table, const QList<QPair<QString, QString>>& metrics);
-    bool writeFileContent(const QString& path, const QList<QPair<QString, QString>>& metrics, const QStringList& data);
+    // Экспорт в фоне: ряды форматируются параллельно, файл заменяется атомарно через QSaveFile.
+    // Возвращает фоновую задачу; окно отменяет и дожидается её, прежде чем удалить таблицу
+    QFuture<void> exportData(QTableWidget *table);
+    bool writeFileContent(const QString& path, const QList<QPair<QString, QString>>& metrics,
+                          const RowsWriter& writeRows = {}, const QStringList& seriesHeaders = {});
+    QList<QPair<QString, QString>> summaryMetrics(const Calculate::SeriesSummary& summary);
 }
 
 #endif // EXPORT_H
@@ -0,0 +1,58 @@
+#ifndef FASTPARSE_H
+#define FASTPARSE_H
+
+#include <charconv>
+#include <system_error>
+
+// Разбор чисел без QString: токены режутся по тем же разделителям, что и при импорте
+// ([,;\t\s]+), одиночный "-" обозначает пустую ячейку.
+namespace FastParse
+{
+    inline bool isSeparator(char c)
+    {
+        return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // Латиница и любые байты UTF-8 вне ASCII (кириллица) считаются буквами, как в проверке импорта
+    inline bool isLetter(char c)
+    {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    inline bool isGap(const char* first, const char* last)
+    {
+        return last - first == 1 && *first == '-';
+    }
+
+    inline bool toDouble(const char* first, const char* last, double& value)
+    {
+        if (first != last && *first == '+') ++first;
+        const auto [ptr, ec] = std::from_chars(first, last, value);
+        return ec == std::errc() && ptr == last && first != last;
+    }
+
+    // Число для ячейки таблицы: токен с буквами отвергается, как строка с буквами при импорте,
+    // поэтому nan, inf и экспоненциальная запись в таблицу не попадают
+    inline bool toCellValue(const char* first, const char* last, double& value)
+    {
+        for (const char* p = first; p != last; ++p) {
+            if (isLetter(*p)) return false;
+        }
+        return toDouble(first, last, value);
+    }
+
+    // Обходит токены строки: callback(column, first, last) для каждой ячейки, включая "-"
+    template <typename Callback>
+    void forEachToken(const char* first, const char* last, Callback&& callback)
+    {
+        int column = 0;
+        while (first != last) {
+            while (first != last && (isSeparator(*first) || *first == '\n')) ++first;
+            const char* tokenStart = first;
+            while (first != last && !isSeparator(*first) && *first != '\n') ++first;
+            if (tokenStart != first) callback(column++, tokenStart, first);
+        }
+    }
+}
+
+#endif // FASTPARSE_H
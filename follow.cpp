@@ -0,0 +1,80 @@
+#include "follow.h"
+
+#include <algorithm>
+
+FileFollower::FileFollower(const QString& path, QObject* parent)
+    : QObject(parent), m_path(path)
+{
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &FileFollower::readAppended);
+    // При замене файла (ротация логов) он пропадает из наблюдения; каталог сообщит о новом
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &FileFollower::readAppended);
+}
+
+bool FileFollower::start(QString* error)
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = "Не удалось открыть файл.";
+        return false;
+    }
+    if (Compression::detectCodec(&file) != Compression::Codec::None) {
+        if (error) *error = "Слежение за сжатыми файлами не поддерживается.";
+        return false;
+    }
+
+    m_watcher.addPath(m_path);
+    m_watcher.addPath(QFileInfo(m_path).absolutePath());
+    readAppended();
+    return true;
+}
+
+void FileFollower::readAppended()
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) return; // Файл мог временно пропасть при замене
+    if (!m_watcher.files().contains(m_path)) m_watcher.addPath(m_path);
+
+    const qint64 size = file.size();
+    if (size < m_offset) {
+        m_offset = 0;
+        m_tail.clear();
+        emit fileReset();
+    }
+    if (size == m_offset || !file.seek(m_offset)) return;
+
+    const QByteArray chunk = file.read(qMin(size - m_offset, followChunkBytes));
+    m_offset += chunk.size();
+    m_tail.append(chunk);
+
+    const qsizetype lastNewline = m_tail.lastIndexOf('\n');
+    if (lastNewline >= 0) {
+        QVector<QVector<double>> values;
+        parseLines(m_tail.constData(), m_tail.constData() + lastNewline + 1, values);
+        m_tail.remove(0, lastNewline + 1);
+        if (!values.isEmpty()) emit recordsAppended(values);
+    }
+
+    // Большой хвост дочитывается частями между событиями интерфейса
+    if (m_offset < size) {
+        QTimer::singleShot(0, this, &FileFollower::readAppended);
+    }
+}
+
+void FileFollower::parseLines(const char* first, const char* last, QVector<QVector<double>>& values)
+{
+    while (first != last) {
+        const char* lineEnd = std::find(first, last, '\n');
+
+        // Строки с буквами (заголовки, метрики экспорта) пропускаются целиком
+        if (std::none_of(first, lineEnd, FastParse::isLetter)) {
+            FastParse::forEachToken(first, lineEnd, [&values](int column, const char* a, const char* b) {
+                double value;
+                if (FastParse::isGap(a, b) || !FastParse::toDouble(a, b, value)) return;
+                if (values.size() <= column) values.resize(column + 1);
+                values[column].append(value);
+            });
+        }
+
+        first = lineEnd == last ? last : lineEnd + 1;
+    }
+}
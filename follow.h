@@ -0,0 +1,43 @@
+#ifndef FOLLOW_H
+#define FOLLOW_H
+
+#include <QObject>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QByteArray>
+#include <QVector>
+
+#include "globals.h"
+#include "fastParse.h"
+#include "compression.h"
+
+// Слежение за дописываемым файлом. Читаются только байты после последнего смещения;
+// каждая полная строка — одна запись, j-е значение строки относится к ряду j.
+class FileFollower : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FileFollower(const QString& path, QObject* parent = nullptr);
+
+    bool start(QString* error = nullptr);
+    QString path() const { return m_path; }
+
+signals:
+    void recordsAppended(const QVector<QVector<double>>& values); // Новые значения по рядам
+    void fileReset();                                             // Файл усечён: данные читаются заново
+
+private slots:
+    void readAppended();
+
+private:
+    static void parseLines(const char* first, const char* last, QVector<QVector<double>>& values);
+
+    QString m_path;
+    QFileSystemWatcher m_watcher;
+    qint64 m_offset = 0;
+    QByteArray m_tail; // Незавершённая последняя строка
+};
+
+#endif // FOLLOW_H
@@ -9,12 +9,47 @@
 constexpr unsigned int initialRowCount = 1;
 constexpr unsigned int initialColCount = 100;
 
+// Импорт
+constexpr int importFirstBatchRows = 64;       // Первый пакет маленький, чтобы таблица появилась сразу
+constexpr int importBatchRows = 4096;
+constexpr int importBatchIntervalMs = 100;     // Максимальная задержка между пакетами
+constexpr int importMaxBatchesInFlight = 4;    // Ограничение очереди пакетов между потоками
+constexpr int importSizingSampleRows = 256;    // Строк для оценки ширины столбцов
+
+// Экспорт
+constexpr qsizetype exportBufferBytes = 1 << 20; // Буфер записи: файл получает данные крупными блоками
+constexpr int exportBlockRows = 256;             // Рядов в блоке параллельного форматирования
+
+// Слежение за файлом
+constexpr int followRefreshMs = 250;             // Период обновления графика и метрик
+constexpr qint64 followChunkBytes = 4 << 20;     // Максимум байт за одно чтение, чтобы не блокировать интерфейс
+
+// Ленивый просмотр больших файлов
+constexpr int lazyIndexStrideRows = 1024;         // Контрольная точка индекса на каждый N-й ряд
+constexpr qint64 lazyIndexStrideBytes = 1 << 20;  // ...и не реже, чем через столько байт
+constexpr int lazyCacheCells = 4000000;           // Бюджет кэша разобранных рядов, в ячейках
+constexpr int lazyRowCells = 1000000;             // Ячеек одного ряда в таблице; весь ряд доступен через сводку
+
+// Прореживание графика
+constexpr int decimationBucketPoints = 16;        // Точек в нижнем уровне пирамиды минимумов и максимумов
+constexpr int decimationLttbFactor = 8;           // До стольких бюджетов точек прореживание идёт по LTTB
+
+// Быстрый график
+constexpr int plotLayerCount = 8;                 // Растров линий во весь график: изменённый ряд перерисовывает только свой слой
+
+// Гистограмма
+constexpr int histogramMaxBins = 200;             // Верхняя граница числа интервалов при автоподборе
+constexpr qsizetype histogramParallelValues = 1 << 20; // С этого размера счёт делится между потоками
+constexpr qsizetype histogramQuartileSample = 100000;  // Значений в выборке для оценки IQR
+
 // Расчёты
 constexpr int statsPrecision = 3;
 constexpr float trimmedMeanPercentage = 0.1;
 constexpr int MIN_SAMPLE_SIZE = 3;
 constexpr int MAX_SAMPLE_SIZE = 5000;
+constexpr int metricsChunkSeries = 4;       // Рядов в порции параллельного расчёта таблицы метрик
 constexpr double SW_CRITICAL_VALUE = 0.05; // Шапиро-Уилк
+constexpr int KS_MIN_SAMPLE_SIZE = 30;     // Колмогоров-Смирнов
 // Ядерная оценка плотности
 constexpr double KDE_BANDWIDTH = 0.5;  // Параметр сглаживания
 constexpr double KDE_EPSILON = 1e-8;   // Для устойчивости вычислений
@@ -22,6 +57,8 @@ constexpr double KDE_EPSILON = 1e-8;   // Для устойчивости выч
 constexpr double CHI2_BINS = 5.0;           // Количество интервалов
 constexpr double CHI2_MIN_EXPECTED = 5.0;
 constexpr double ALPHA_LEVEL = 0.05; // Уровни значимости
+// Потоковые сводки
+constexpr int sketchCapacity = 256;         // Значений на уровень квантильного скетча
 // Критерий Шапиро-Уилка
 constexpr double a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
                     -2.759285104469687e+02, 1.383577518672690e+02,
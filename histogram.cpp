@@ -0,0 +1,203 @@
+#include "histogram.h"
+
+#include <QList>
+#include <QPair>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HISTOGRAM_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Histogram
+{
+    namespace
+    {
+        constexpr int lanes = 4; // Независимые копии счётчиков: соседние значения одного интервала не ждут друг друга
+
+        inline int clampIndex(double t, double last)
+        {
+            // NaN и +inf попадают в последний интервал, как и в векторной ветке
+            return t < last ? (t > 0.0 ? static_cast<int>(t) : 0) : static_cast<int>(last);
+        }
+
+        void countUniform(const double* values, qsizetype size, double lo, double hi, int bins,
+                          std::vector<std::uint64_t>& counts)
+        {
+            std::vector<std::uint64_t> laneCounts(static_cast<size_t>(lanes) * bins, 0);
+            std::uint64_t* lane[lanes];
+            for (int l = 0; l < lanes; ++l) lane[l] = laneCounts.data() + static_cast<size_t>(l) * bins;
+
+            const double scale = bins / (hi - lo);
+            const double last = bins - 1;
+            qsizetype i = 0;
+
+#ifdef HISTOGRAM_SSE2
+            const __m128d vLo = _mm_set1_pd(lo);
+            const __m128d vScale = _mm_set1_pd(scale);
+            const __m128d vLast = _mm_set1_pd(last);
+            const __m128d vZero = _mm_setzero_pd();
+            for (; i + 4 <= size; i += 4) {
+                // Номер интервала = (x - lo) * scale, зажатый в [0, last] до усечения к целому
+                __m128d a = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(values + i), vLo), vScale);
+                __m128d b = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(values + i + 2), vLo), vScale);
+                a = _mm_max_pd(_mm_min_pd(a, vLast), vZero);
+                b = _mm_max_pd(_mm_min_pd(b, vLast), vZero);
+                const __m128i ia = _mm_cvttpd_epi32(a);
+                const __m128i ib = _mm_cvttpd_epi32(b);
+
+                ++lane[0][_mm_cvtsi128_si32(ia)];
+                ++lane[1][_mm_cvtsi128_si32(_mm_shuffle_epi32(ia, 1))];
+                ++lane[2][_mm_cvtsi128_si32(ib)];
+                ++lane[3][_mm_cvtsi128_si32(_mm_shuffle_epi32(ib, 1))];
+            }
+#else
+            for (; i + 4 <= size; i += 4) {
+                for (int l = 0; l < lanes; ++l) {
+                    ++lane[l][clampIndex((values[i + l] - lo) * scale, last)];
+                }
+            }
+#endif
+            for (; i < size; ++i) {
+                ++lane[0][clampIndex((values[i] - lo) * scale, last)];
+            }
+
+            for (int bin = 0; bin < bins; ++bin) {
+                counts[bin] += lane[0][bin] + lane[1][bin] + lane[2][bin] + lane[3][bin];
+            }
+        }
+
+        void countSearch(const double* values, qsizetype size, const std::vector<double>& edges,
+                         std::vector<std::uint64_t>& counts)
+        {
+            // Поиск только по внутренним границам: всё, что левее или правее, уходит в крайние интервалы
+            const auto first = edges.cbegin() + 1;
+            const auto last = edges.cend() - 1;
+            for (qsizetype i = 0; i < size; ++i) {
+                ++counts[std::upper_bound(first, last, values[i]) - first];
+            }
+        }
+
+        std::vector<std::uint64_t> countRange(const double* values, qsizetype size,
+                                              const std::vector<double>& edges, bool uniform)
+        {
+            const int bins = static_cast<int>(edges.size()) - 1;
+            std::vector<std::uint64_t> counts(bins, 0);
+            if (uniform) {
+                countUniform(values, size, edges.front(), edges.back(), bins, counts);
+            } else {
+                countSearch(values, size, edges, counts);
+            }
+            return counts;
+        }
+    }
+
+    std::vector<std::uint64_t> count(const double* values, qsizetype size, const std::vector<double>& edges)
+    {
+        if (edges.size() < 2) return {};
+
+        const bool uniform = isUniform(edges);
+        const int threads = QThread::idealThreadCount();
+        if (size < histogramParallelValues || threads < 2) {
+            return countRange(values, size, edges, uniform);
+        }
+
+        // У каждого потока свой частичный счёт, суммирование в конце
+        QList<QPair<qsizetype, qsizetype>> chunks;
+        const qsizetype chunk = (size + threads - 1) / threads;
+        for (qsizetype begin = 0; begin < size; begin += chunk) {
+            chunks.append({begin, qMin(chunk, size - begin)});
+        }
+        const QList<std::vector<std::uint64_t>> partials = QtConcurrent::blockingMapped<QList<std::vector<std::uint64_t>>>(
+            chunks, [&](const QPair<qsizetype, qsizetype>& range) {
+                return countRange(values + range.first, range.second, edges, uniform);
+            });
+
+        std::vector<std::uint64_t> counts(edges.size() - 1, 0);
+        for (const std::vector<std::uint64_t>& partial : partials) {
+            for (size_t bin = 0; bin < counts.size(); ++bin) counts[bin] += partial[bin];
+        }
+        return counts;
+    }
+
+    bool isUniform(const std::vector<double>& edges)
+    {
+        if (edges.size() < 2) return false;
+
+        const double lo = edges.front();
+        const double hi = edges.back();
+        if (!std::isfinite(lo) || !std::isfinite(hi) || !(hi > lo)) return false;
+
+        const double width = (hi - lo) / (edges.size() - 1);
+        const double tolerance = width * 1e-9;
+        for (size_t i = 1; i + 1 < edges.size(); ++i) {
+            if (std::abs(edges[i] - (lo + width * i)) > tolerance) return false;
+        }
+        return true;
+    }
+
+    std::vector<double> uniformEdges(double min, double max, int bins)
+    {
+        bins = qMax(bins, 1);
+        if (!(max > min)) {
+            // Все значения одинаковы: один интервал единичной ширины вокруг них
+            min -= 0.5;
+            max += 0.5;
+        }
+        std::vector<double> edges(bins + 1);
+        for (int i = 0; i <= bins; ++i) {
+            edges[i] = min + (max - min) * i / bins;
+        }
+        edges[bins] = max;
+        return edges;
+    }
+
+    int sturgesBins(qsizetype size)
+    {
+        if (size <= 1) return 1;
+        return static_cast<int>(std::ceil(std::log2(static_cast<double>(size)))) + 1;
+    }
+
+    int freedmanDiaconisBins(const double* values, qsizetype size, double min, double max)
+    {
+        if (size < 2 || !(max > min)) return 0;
+
+        // Квартили по равномерной выборке: на больших рядах точность IQR не растёт, а копия стоит памяти
+        const qsizetype stride = qMax<qsizetype>(1, size / histogramQuartileSample);
+        std::vector<double> sample;
+        sample.reserve(static_cast<size_t>(size / stride + 1));
+        for (qsizetype i = 0; i < size; i += stride) sample.push_back(values[i]);
+
+        const auto q1 = sample.begin() + static_cast<qsizetype>(sample.size()) / 4;
+        const auto q3 = sample.begin() + static_cast<qsizetype>(sample.size()) * 3 / 4;
+        std::nth_element(sample.begin(), q1, sample.end());
+        const double lower = *q1;
+        std::nth_element(q1, q3, sample.end());
+        const double iqr = *q3 - lower;
+        if (!(iqr > 0.0)) return 0;
+
+        const double width = 2.0 * iqr / std::cbrt(static_cast<double>(size));
+        return static_cast<int>(std::min(std::ceil((max - min) / width), 1e9));
+    }
+
+    Bins build(const std::vector<double>& values, int maxBins)
+    {
+        Bins result;
+        if (values.empty()) return result;
+
+        const auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end());
+        const qsizetype size = static_cast<qsizetype>(values.size());
+
+        int bins = freedmanDiaconisBins(values.data(), size, *minIt, *maxIt);
+        if (bins <= 0) bins = sturgesBins(size);
+        bins = std::clamp(bins, 1, qMax(maxBins, 1));
+
+        result.edges = uniformEdges(*minIt, *maxIt, bins);
+        result.counts = count(values, result.edges);
+        return result;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <QtGlobal>
+
+#include <cstdint>
+#include <vector>
+
+#include "globals.h"
+
+// Подсчёт значений по интервалам: общий для критерия χ² и графика гистограммы.
+// Равные интервалы считаются арифметикой (по два значения за инструкцию SSE2),
+// неравные — двоичным поиском; большие массивы делятся между потоками.
+namespace Histogram
+{
+    struct Bins {
+        std::vector<double> edges;          // bins + 1 границ по возрастанию
+        std::vector<std::uint64_t> counts;  // Значений в интервале [edges[i], edges[i + 1])
+
+        int size() const { return static_cast<int>(counts.size()); }
+    };
+
+    // Значения вне границ попадают в крайние интервалы, последняя граница включается в последний
+    std::vector<std::uint64_t> count(const double* values, qsizetype size, const std::vector<double>& edges);
+    inline std::vector<std::uint64_t> count(const std::vector<double>& values, const std::vector<double>& edges)
+    {
+        return count(values.data(), static_cast<qsizetype>(values.size()), edges);
+    }
+
+    bool isUniform(const std::vector<double>& edges);
+    std::vector<double> uniformEdges(double min, double max, int bins);
+
+    int sturgesBins(qsizetype size);
+    // По правилу Фридмана — Диакониса; 0, если межквартильный размах нулевой
+    int freedmanDiaconisBins(const double* values, qsizetype size, double min, double max);
+
+    // Равные интервалы от минимума до максимума, число выбирается автоматически
+    Bins build(const std::vector<double>& values, int maxBins = histogramMaxBins);
+}
+
+#endif // HISTOGRAM_H
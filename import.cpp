@@ -1,4 +1,5 @@
 #include "import.h"
+#include "draw.h"
 
 namespace Import {
 QRegularExpression regex(R"([,;\t\s]+)");
@@ -8,10 +9,21 @@ struct ParsedRow {
     int lastNonEmptyIndex = -1;
 };
 
-struct ParseResult {
+// Пакет разобранных строк, передаваемый из фонового потока в таблицу
+struct ImportBatch {
     QVector<ParsedRow> rows;
     int maxColumns = 0;
+};
+
+// Общее состояние фонового импорта
+struct ImportState {
     QStringList seriesHeaders;
+    QList<int> invalidLines;
+    QString error;
+    bool openFailed = false;
+    bool sized = false;                              // Ширина столбцов уже оценена
+    QList<StatsTrailer::SeriesRecord> cachedStats;   // Статистики из трейлера, если контрольная сумма сошлась
+    QSemaphore freeBatches{importMaxBatchesInFlight}; // Свободные места в очереди пакетов
 };
 
 // Вспомогательные функции
@@ -27,39 +39,6 @@ void showError(QWidget* parent, const QString& message) {
     QMessageBox::critical(parent, "Ошибка", message);
 }
 
-QList<int> findInvalidDataLines(const QString& filePath, QWidget* parent) {
-    QFile file(filePath);
-    QList<int> invalidLines;
-    QRegularExpression letterRegex("[A-Za-zА-Яа-яЁё]"); // Регулярка для поиска букв
-
-    if (!openFile(file, parent)) return invalidLines;
-
-    QTextStream in(&file);
-    int lineNumber = 0;
-    int emptyLineCounter = 0;
-    const int STOP_LINES = 3;
-
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        lineNumber++;
-
-        if (line.isEmpty()) {
-            emptyLineCounter++;
-            if (emptyLineCounter >= STOP_LINES) break;
-            continue;
-        } else {
-            emptyLineCounter = 0;
-
-            // Проверка на наличие букв в непустых строках данных
-            if (line.contains(letterRegex)) {
-                invalidLines.append(lineNumber);
-            }
-        }
-    }
-    file.close();
-    return invalidLines;
-}
-
 ParsedRow parseLine(const QString& line) {
     ParsedRow row;
     QStringList tokens = line.split(regex, Qt::SkipEmptyParts);
@@ -76,124 +55,587 @@ ParsedRow parseLine(const QString& line) {
     return row;
 }
 
-void adjustRows(QVector<ParsedRow>& rows, int maxColumns) {
-    for (ParsedRow& row : rows) {
-        while (row.data.size() > maxColumns)
-            row.data.removeLast();
-
-        while (row.data.size() < maxColumns)
-            row.data.append("");
-    }
-}
-
 // Основные функции
 QString getFilePath(QWidget* parent) {
     return QFileDialog::getOpenFileName(
         parent,
         "Импорт файла данных",
         "",
-        "Файлы данных (*.csv *.txt);;Все файлы (*)"
+        "Файлы данных (*.csv *.txt *.glws *.gz *.zst);;Рабочее пространство (*.glws);;Сжатые файлы (*.gz *.zst);;Все файлы (*)"
         );
 }
 
-ParseResult readAndParseFile(const QString& filePath, QWidget* parent) {
-    QFile file(filePath);
-    ParseResult result;
-    int emptyLineCounter = 0;  // Счетчик пустых строк
-    const int STOP_LINES = 3;  // Количество пустых строк для остановки
 
-    QList<int> invalidLines = findInvalidDataLines(filePath, parent);
-    if (!invalidLines.isEmpty()) {
-        QString errorMsg = "Невозможно импортировать. Найдены буквы в строках:\n";
-        for (int ln : invalidLines) {
-            errorMsg += QString::number(ln) + ", ";
-        }
-        errorMsg.chop(2);
-        showError(parent, errorMsg);
-        return result;
+// Фоновый разбор файла: строки передаются в GUI-поток пакетами через receiver
+void streamFile(QPromise<void>& promise, const QString& filePath,
+                std::shared_ptr<ImportState> state, QObject* receiver,
+                std::function<void(const ImportBatch&)> applyBatch) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        state->openFailed = true;
+        return;
     }
 
-    if (!openFile(file, parent)) return result;
+    // Сжатые файлы распаковываются потоком; прогресс считается по прочитанным сжатым байтам
+    const Compression::Codec codec = Compression::detectCodec(&file);
+    if (!Compression::isAvailable(codec)) {
+        state->error = QString("Поддержка %1 не включена в сборку.").arg(Compression::codecName(codec));
+        return;
+    }
+    const std::unique_ptr<QIODevice> decoder = Compression::createDecoder(codec, &file);
+    if (codec != Compression::Codec::None && !decoder) {
+        state->openFailed = true;
+        return;
+    }
+    QIODevice& input = decoder ? *decoder : static_cast<QIODevice&>(file);
 
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
+    const QRegularExpression letterRegex("[A-Za-zА-Яа-яЁё]"); // Регулярка для поиска букв
+    const qint64 totalBytes = qMax<qint64>(1, file.size());
+    const int STOP_LINES = 3;  // Количество пустых строк для остановки
+    int emptyLineCounter = 0;
+    int lineNumber = 0;
+    int batchLimit = importFirstBatchRows;
+
+    ImportBatch batch;
+    QElapsedTimer sinceFlush;
+    sinceFlush.start();
+    promise.setProgressRange(0, 1000);
+
+    // Передача пакета с ожиданием свободного места в очереди
+    auto flush = [&]() -> bool {
+        if (batch.rows.isEmpty()) return true;
+        while (!state->freeBatches.tryAcquire(1, 50)) {
+            if (promise.isCanceled()) return false;
+        }
+        QMetaObject::invokeMethod(receiver, [state, applyBatch, batch]() {
+            applyBatch(batch);
+            state->freeBatches.release();
+        }, Qt::QueuedConnection);
+
+        batch = ImportBatch();
+        batchLimit = importBatchRows;
+        sinceFlush.restart();
+        promise.setProgressValue(static_cast<int>(1000 * file.pos() / totalBytes));
+        return true;
+    };
+
+    StatsTrailer::Checksum checksum;
+    while (!input.atEnd()) {
+        if (promise.isCanceled()) return;
+
+        const QByteArray rawLine = input.readLine();
+        if (rawLine.isEmpty()) break; // Даже пустая строка файла содержит перевод строки: это конец или ошибка
+        checksum.update(rawLine.constData(), rawLine.size());
+        const QString line = QString::fromUtf8(rawLine).trimmed();
+        lineNumber++;
 
         // Проверяем разделитель окончания данных
         if (line.isEmpty()) {
             emptyLineCounter++;
-            if (emptyLineCounter >= STOP_LINES) {
-                break; // Обнаружен конец данных
-            }
+            if (emptyLineCounter >= STOP_LINES) break;
             continue;
-        } else {
-            emptyLineCounter = 0; // Сбрасываем счетчик
         }
+        emptyLineCounter = 0;
+
+        // Строки с буквами делают импорт невозможным; дочитываем файл, чтобы перечислить их все
+        if (line.contains(letterRegex)) {
+            state->invalidLines.append(lineNumber);
+            continue;
+        }
+        if (!state->invalidLines.isEmpty()) continue;
 
         ParsedRow row = parseLine(line);
         if (row.lastNonEmptyIndex >= 0) {
-            result.rows.append(row);
-            result.maxColumns = std::max(result.maxColumns, row.lastNonEmptyIndex + 1);
+            batch.maxColumns = std::max(batch.maxColumns, row.lastNonEmptyIndex + 1);
+            batch.rows.append(std::move(row));
+        }
+
+        if (batch.rows.size() >= batchLimit || sinceFlush.elapsed() >= importBatchIntervalMs) {
+            if (!flush()) return;
         }
     }
+    if (!flush()) return;
+    if (Compression::hasReadError(input)) {
+        state->error = "Ошибка чтения файла: " + input.errorString();
+        return;
+    }
 
-    QVector<QString> seriesHeaders;
-    while(!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if(line.startsWith("# Заголовки рядов")) {
-            if(!in.atEnd()) {
-                QString headersLine = in.readLine().trimmed();
-                seriesHeaders = headersLine.split(", ", Qt::SkipEmptyParts);
+    // Трейлер: заголовки рядов и необязательный блок статистик с контрольной суммой данных
+    QList<StatsTrailer::SeriesRecord> records;
+    bool inStats = false;
+    while (!input.atEnd()) {
+        if (promise.isCanceled()) return;
+
+        const QByteArray rawLine = input.readLine();
+        if (rawLine.isEmpty()) break;
+        const QString line = QString::fromUtf8(rawLine).trimmed();
+        if (inStats) {
+            quint64 expected = 0;
+            if (StatsTrailer::parseChecksum(line, expected)) {
+                if (expected == checksum.value() && state->invalidLines.isEmpty())
+                    state->cachedStats = records;
+                break;
+            }
+            StatsTrailer::SeriesRecord record;
+            if (!StatsTrailer::parseRecord(line, record)) break; // Повреждённый блок игнорируется
+            records.append(std::move(record));
+        } else if (line.startsWith("# Заголовки рядов")) {
+            if (!input.atEnd()) {
+                const QString headersLine = QString::fromUtf8(input.readLine()).trimmed();
+                state->seriesHeaders = headersLine.split(", ", Qt::SkipEmptyParts);
             }
-            break;
+        } else if (StatsTrailer::isSectionStart(line)) {
+            inStats = true;
+        }
+    }
+    if (Compression::hasReadError(input)) {
+        state->error = "Ошибка чтения файла: " + input.errorString();
+        return;
+    }
+    promise.setProgressValue(1000);
+}
+
+// Ширина столбцов оценивается по выборке первых строк вместо измерения каждой ячейки
+void estimateSectionSizes(QTableWidget* table, const ImportBatch& sample) {
+    const QFontMetrics metrics(table->font());
+    int widest = metrics.horizontalAdvance(QString::number(table->columnCount()));
+
+    const int sampleRows = static_cast<int>(qMin<qsizetype>(sample.rows.size(), importSizingSampleRows));
+    for (int i = 0; i < sampleRows; ++i) {
+        for (const QString& cell : sample.rows[i].data) {
+            widest = qMax(widest, metrics.horizontalAdvance(cell));
         }
     }
-    result.seriesHeaders = seriesHeaders;
 
-    file.close();
-    adjustRows(result.rows, result.maxColumns);
-    return result;
+    const int padding = 16;
+    QHeaderView* header = table->horizontalHeader();
+    header->setDefaultSectionSize(qMax(header->minimumSectionSize(), widest + padding));
+    table->verticalHeader()->setDefaultSectionSize(metrics.height() + padding / 2);
+}
+
+void appendBatch(QTableWidget* table, ImportState& state, const ImportBatch& batch) {
+    const int firstRow = table->rowCount();
+    if (batch.maxColumns > table->columnCount()) {
+        table->setColumnCount(batch.maxColumns);
+    }
+    table->setRowCount(firstRow + batch.rows.size());
+
+    {
+        // Модель молчит, пока заполняются ячейки: иначе каждая вставка запускает пересчёт статистики
+        const QSignalBlocker blocker(table->model());
+        for (int i = 0; i < batch.rows.size(); ++i) {
+            const auto& rowData = batch.rows[i].data;
+            for (int j = 0; j < rowData.size(); ++j) {
+                if (!rowData[j].isEmpty()) {
+                    table->setItem(firstRow + i, j, new QTableWidgetItem(rowData[j]));
+                }
+            }
+        }
+    }
+
+    if (!state.sized) {
+        estimateSectionSizes(table, batch);
+        state.sized = true;
+    }
+    table->viewport()->update();
 }
 
-void updateTable(QTableWidget* table, const ParseResult& result) {
-    if (result.rows.isEmpty()) {
+void finishImport(QTableWidget* table, const ImportState& state, bool canceled) {
+    if (state.openFailed) {
+        showError(table, "Не удалось открыть файл.");
+    } else if (!state.error.isEmpty()) {
+        // Оборванные или повреждённые данные в таблице не остаются
+        table->clearContents();
+        table->setRowCount(initialRowCount);
+        showError(table, state.error);
+    } else if (!state.invalidLines.isEmpty()) {
+        QString errorMsg = "Невозможно импортировать. Найдены буквы в строках:\n";
+        for (int ln : state.invalidLines) {
+            errorMsg += QString::number(ln) + ", ";
+        }
+        errorMsg.chop(2);
+        table->clearContents();
+        table->setRowCount(initialRowCount);
+        showError(table, errorMsg);
+    } else if (table->rowCount() == 0 && !canceled) {
         QMessageBox::warning(table, "Предупреждение", "Файл пуст!");
+    }
+
+    if (table->rowCount() == 0) {
+        table->setRowCount(initialRowCount);
+    }
+
+    MainWindow* mainWindow = qobject_cast<MainWindow*>(table->window());
+    if (mainWindow && !state.seriesHeaders.isEmpty()) {
+        mainWindow->setSeriesHeaders(state.seriesHeaders);
+    }
+    if (mainWindow && !canceled && state.invalidLines.isEmpty()) {
+        mainWindow->setCachedStatistics(state.cachedStats);
+    }
+}
+
+void importFile(QTableWidget* table, std::function<void()> onFinished) {
+    const QString filePath = getFilePath(table);
+    if (filePath.isEmpty()) return;
+
+    // Рабочее пространство отображается в память и не требует разбора текста
+    if (Workspace::isWorkspaceFile(filePath)) {
+        Workspace::MappedWorkspace workspace;
+        QString error;
+        if (!workspace.open(filePath, &error)) {
+            showError(table, error);
+            return;
+        }
+        Workspace::loadIntoTable(table, workspace);
+        if (onFinished) onFinished();
         return;
     }
 
+    QFile probe(filePath);
+    if (!openFile(probe, table)) return;
+    probe.close();
+
+    auto* progress = new QProgressDialog("Импорт данных...", "Отмена", 0, 1000, table);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+    progress->setAutoReset(false);
+
+    auto* watcher = new QFutureWatcher<void>(table);
+    auto state = std::make_shared<ImportState>();
+
+    QObject::connect(watcher, &QFutureWatcherBase::progressValueChanged, progress, &QProgressDialog::setValue);
+    QObject::connect(progress, &QProgressDialog::canceled, watcher, &QFutureWatcherBase::cancel);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, table, [=]() {
+        progress->close();
+        finishImport(table, *state, watcher->isCanceled());
+        if (onFinished) onFinished();
+        progress->deleteLater();
+        watcher->deleteLater();
+    });
+
     table->clearContents();
-    table->setRowCount(result.rows.size());
-    table->setColumnCount(result.maxColumns);
-
-    for (int i = 0; i < result.rows.size(); ++i) {
-        const auto& rowData = result.rows[i].data;
-        for (int j = 0; j < result.maxColumns; ++j) {
-            if (j < rowData.size() && !rowData[j].isEmpty()) {
-                QTableWidgetItem* item = new QTableWidgetItem(rowData[j]);
-                table->setItem(i, j, item);
+    table->setRowCount(0);
+
+    auto applyBatch = [table, state](const ImportBatch& batch) { appendBatch(table, *state, batch); };
+    watcher->setFuture(QtConcurrent::run([=](QPromise<void>& promise) {
+        streamFile(promise, filePath, state, watcher, applyBatch);
+    }));
+}
+
+// Фоновый подсчёт сводки: файл проходит через Summary::StreamParser блоками
+void streamSummary(QPromise<void>& promise, const QString& filePath,
+                   std::shared_ptr<ImportState> state, std::shared_ptr<Summary::Result> result) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        state->openFailed = true;
+        return;
+    }
+
+    const Compression::Codec codec = Compression::detectCodec(&file);
+    if (!Compression::isAvailable(codec)) {
+        state->error = QString("Поддержка %1 не включена в сборку.").arg(Compression::codecName(codec));
+        return;
+    }
+    const std::unique_ptr<QIODevice> decoder = Compression::createDecoder(codec, &file);
+    if (codec != Compression::Codec::None && !decoder) {
+        state->openFailed = true;
+        return;
+    }
+    QIODevice& input = decoder ? *decoder : static_cast<QIODevice&>(file);
+
+    const qint64 totalBytes = qMax<qint64>(1, file.size());
+    promise.setProgressRange(0, 1000);
+    const bool completed = Summary::summarize(
+        input, *result,
+        [&promise]() { return promise.isCanceled(); },
+        [&]() { promise.setProgressValue(static_cast<int>(1000 * file.pos() / totalBytes)); });
+    if (!completed) {
+        if (Compression::hasReadError(input)) state->error = "Ошибка чтения файла: " + input.errorString();
+        return;
+    }
+    promise.setProgressValue(1000);
+}
+
+// Сводка по рабочему пространству: ряды читаются прямо из отображения файла
+void summarizeWorkspace(const Workspace::MappedWorkspace& workspace, Summary::Result& result) {
+    Calculate::SeriesSummary summary;
+    for (int series = 0; series < workspace.seriesCount(); ++series) {
+        summary.clear();
+        for (double value : workspace.seriesValues(series)) {
+            summary.add(value);
+        }
+        result.seriesMetrics.append(Export::summaryMetrics(summary));
+    }
+    result.seriesHeaders = workspace.seriesHeaders();
+}
+
+void showSummary(QWidget* parent, const Summary::Result& result) {
+    QPushButton* saveBtn = nullptr;
+    QDialog* dialog = Draw::createSummaryDialog(parent, result.seriesHeaders, result.seriesMetrics, &saveBtn);
+
+    const Summary::MetricList metrics = result.joinedMetrics();
+    const QStringList headers = result.seriesHeaders;
+    Draw::connect(saveBtn, [dialog, metrics, headers]() {
+        const QString fileName = QFileDialog::getSaveFileName(
+            dialog, "Сохранить отчёт", "", "Текстовый файл (*.txt);;Текстовый файл, gzip (*.txt.gz)");
+        if (fileName.isEmpty()) return;
+        if (Export::writeFileContent(fileName, metrics, {}, headers)) {
+            QMessageBox::information(dialog, "Успех", "Отчёт сохранён!");
+        } else {
+            showError(dialog, "Ошибка записи файла!");
+        }
+    });
+    dialog->show();
+}
+
+void summarizeFile(QWidget* parent) {
+    const QString filePath = getFilePath(parent);
+    if (filePath.isEmpty()) return;
+
+    if (Workspace::isWorkspaceFile(filePath)) {
+        Workspace::MappedWorkspace workspace;
+        QString error;
+        if (!workspace.open(filePath, &error)) {
+            showError(parent, error);
+            return;
+        }
+        Summary::Result result;
+        summarizeWorkspace(workspace, result);
+        showSummary(parent, result);
+        return;
+    }
+
+    QFile probe(filePath);
+    if (!openFile(probe, parent)) return;
+    probe.close();
+
+    auto* progress = new QProgressDialog("Подсчёт сводки...", "Отмена", 0, 1000, parent);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+    progress->setAutoReset(false);
+
+    auto* watcher = new QFutureWatcher<void>(parent);
+    auto state = std::make_shared<ImportState>();
+    auto result = std::make_shared<Summary::Result>();
+
+    QObject::connect(watcher, &QFutureWatcherBase::progressValueChanged, progress, &QProgressDialog::setValue);
+    QObject::connect(progress, &QProgressDialog::canceled, watcher, &QFutureWatcherBase::cancel);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, parent, [=]() {
+        progress->close();
+        if (state->openFailed) {
+            showError(parent, "Не удалось открыть файл.");
+        } else if (!state->error.isEmpty()) {
+            showError(parent, state->error);
+        } else if (!result->invalidLines.isEmpty()) {
+            QString errorMsg = "Невозможно посчитать сводку. Найдены буквы в строках:\n";
+            for (int ln : result->invalidLines) {
+                errorMsg += QString::number(ln) + ", ";
+            }
+            errorMsg.chop(2);
+            showError(parent, errorMsg);
+        } else if (!watcher->isCanceled()) {
+            if (result->seriesMetrics.isEmpty()) {
+                QMessageBox::warning(parent, "Предупреждение", "Файл пуст!");
+            } else {
+                showSummary(parent, *result);
             }
         }
+        progress->deleteLater();
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::run([=](QPromise<void>& promise) {
+        streamSummary(promise, filePath, state, result);
+    }));
+}
+
+// Фоновое построение индекса: порции передаются модели по мере чтения файла
+void scanLineIndex(QPromise<void>& promise, const QString& filePath, LazyTableModel* model) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    LineIndex::Scanner scanner;
+    auto publish = [&]() {
+        QMetaObject::invokeMethod(model, [model, update = scanner.takeUpdate()]() {
+            model->applyUpdate(update);
+        }, Qt::QueuedConnection);
+    };
+
+    const qint64 totalBytes = qMax<qint64>(1, file.size());
+    std::vector<char> buffer(4 << 20);
+    QElapsedTimer sincePublish;
+    sincePublish.start();
+    bool firstChunk = true; // Первая порция уходит сразу, чтобы таблица появилась без ожидания
+    promise.setProgressRange(0, 1000);
+
+    while (!file.atEnd()) {
+        if (promise.isCanceled()) return;
+
+        const qint64 n = file.read(buffer.data(), static_cast<qint64>(buffer.size()));
+        if (n <= 0) break;
+        scanner.feed(buffer.data(), n);
+
+        if (firstChunk || sincePublish.elapsed() >= importBatchIntervalMs) {
+            publish();
+            firstChunk = false;
+            sincePublish.restart();
+            promise.setProgressValue(static_cast<int>(1000 * scanner.offset() / totalBytes));
+        }
     }
+    scanner.finish();
+    publish();
+    promise.setProgressValue(1000);
+}
 
-    MainWindow* mainWindow = qobject_cast<MainWindow*>(table->window());
-    if(mainWindow && !result.seriesHeaders.isEmpty()) {
-        mainWindow->setSeriesHeaders(result.seriesHeaders);
+// Сводка одного ряда просмотра: длинный ряд читается долго, поэтому в фоне и с отменой.
+// summarize работает в рабочем потоке и не должна обращаться к модели просмотра
+void summarizeRowInBackground(QDialog* dialog, const QString& seriesName, const QString& notFoundMessage,
+                              std::function<bool(const std::function<bool(double)>&, Calculate::SeriesSummary&)> summarize) {
+    auto* progress = new QProgressDialog("Подсчёт сводки ряда...", "Отмена", 0, 1000, dialog);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+    progress->setAutoReset(false);
+
+    auto* watcher = new QFutureWatcher<void>(dialog);
+    auto summary = std::make_shared<Calculate::SeriesSummary>();
+    auto found = std::make_shared<bool>(false);
+
+    QObject::connect(watcher, &QFutureWatcherBase::progressValueChanged, progress, &QProgressDialog::setValue);
+    QObject::connect(progress, &QProgressDialog::canceled, watcher, &QFutureWatcherBase::cancel);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, dialog, [=]() {
+        progress->close();
+        if (!watcher->isCanceled()) {
+            if (!*found) {
+                showError(dialog, notFoundMessage);
+            } else {
+                Summary::Result result;
+                result.seriesMetrics.append(Export::summaryMetrics(*summary));
+                result.seriesHeaders = QStringList{seriesName};
+                showSummary(dialog, result);
+            }
+        }
+        progress->deleteLater();
+        watcher->deleteLater();
+    });
+
+    const QFuture<void> future = QtConcurrent::run([=](QPromise<void>& promise) {
+        promise.setProgressRange(0, 1000);
+        *found = summarize([&promise](double fraction) {
+            promise.setProgressValue(static_cast<int>(1000 * fraction));
+            return !promise.isCanceled();
+        }, *summary);
+    });
+    watcher->setFuture(future);
+
+    // Окно просмотра закрыто раньше: расчёт больше никому не нужен
+    QObject::connect(dialog, &QObject::destroyed, [future]() mutable { future.cancel(); });
+}
+
+// Рабочее пространство показывается прямо из отображения файла: ни разбора, ни ячеек таблицы
+void openWorkspaceView(QWidget* parent, const QString& filePath) {
+    auto* model = new WorkspaceTableModel();
+    QString error;
+    if (!model->open(filePath, &error)) {
+        delete model;
+        showError(parent, error);
+        return;
     }
 
-    table->resizeColumnsToContents();
-    table->resizeRowsToContents();
+    QTableView* view = nullptr;
+    QLabel* status = nullptr;
+    QPushButton* metricsBtn = nullptr;
+    QDialog* dialog = Draw::createLazyViewer(parent, QFileInfo(filePath).fileName(), model,
+                                             &view, &status, &metricsBtn);
+    model->setParent(dialog);
+    status->setText(QString("Рядов: %1, столбцов: %2").arg(model->rowCount()).arg(model->columnCount()));
+
+    Draw::connect(metricsBtn, [=]() {
+        const QModelIndex current = view->currentIndex();
+        const int row = current.isValid() ? current.row() : 0;
+        if (row >= model->rowCount()) return;
+
+        const QString path = model->path();
+        summarizeRowInBackground(dialog, model->seriesName(row), "Не удалось прочитать ряд.",
+                                 [path, row](const std::function<bool(double)>& proceed, Calculate::SeriesSummary& summary) {
+            return WorkspaceTableModel::summarizeRow(path, row, summary, proceed);
+        });
+    });
+
+    dialog->show();
 }
 
-void importFile(QTableWidget* table) {
-    const QString filePath = getFilePath(table);
+void openLazyView(QWidget* parent) {
+    const QString filePath = getFilePath(parent);
     if (filePath.isEmpty()) return;
-    const auto parseResult = readAndParseFile(filePath, table);
 
-    // Уже была показана ошибка, выходим
-    if (parseResult.rows.isEmpty() && parseResult.seriesHeaders.isEmpty()) {
+    if (Workspace::isWorkspaceFile(filePath)) {
+        openWorkspaceView(parent, filePath);
         return;
     }
 
-    updateTable(table, parseResult);
+    QFile probe(filePath);
+    if (!openFile(probe, parent)) return;
+    if (Compression::detectCodec(&probe) != Compression::Codec::None) {
+        showError(parent, "Ленивый просмотр доступен только для несжатых текстовых файлов и рабочих пространств.");
+        return;
+    }
+    probe.close();
+
+    // Модель живёт дольше окна: фоновое сканирование обращается к ней до своего завершения
+    auto* model = new LazyTableModel(filePath);
+    auto* watcher = new QFutureWatcher<void>(model);
+
+    QTableView* view = nullptr;
+    QLabel* status = nullptr;
+    QPushButton* metricsBtn = nullptr;
+    QPointer<QDialog> dialog = Draw::createLazyViewer(parent, QFileInfo(filePath).fileName(), model,
+                                                      &view, &status, &metricsBtn);
+
+    QObject::connect(watcher, &QFutureWatcherBase::progressValueChanged, status, [status, model](int value) {
+        status->setText(QString("Индексация: %1%, рядов: %2").arg(value / 10).arg(model->rowCount()));
+    });
+    QObject::connect(watcher, &QFutureWatcherBase::finished, model, [=]() {
+        if (!dialog) {
+            model->deleteLater();
+            return;
+        }
+        if (!model->invalidLines().isEmpty()) {
+            QString errorMsg = "Невозможно открыть файл. Найдены буквы в строках:\n";
+            for (int ln : model->invalidLines()) {
+                errorMsg += QString::number(ln) + ", ";
+            }
+            errorMsg.chop(2);
+            showError(dialog, errorMsg);
+            dialog->close();
+            return;
+        }
+        status->setText(QString("Рядов: %1, столбцов: %2").arg(model->rowCount()).arg(model->columnCount()));
+    });
+    QObject::connect(dialog, &QObject::destroyed, model, [=]() {
+        if (watcher->isFinished()) model->deleteLater();
+        else watcher->cancel();
+    });
+
+    Draw::connect(metricsBtn, [=]() {
+        const QModelIndex current = view->currentIndex();
+        const int row = current.isValid() ? current.row() : 0;
+
+        LineIndex::RowLocation location;
+        if (!model->locateRow(row, location)) {
+            showError(dialog, "Ряд ещё не проиндексирован.");
+            return;
+        }
+        const QString path = model->path();
+        summarizeRowInBackground(dialog, model->seriesName(row), "Не удалось прочитать ряд.",
+                                 [path, location](const std::function<bool(double)>& proceed, Calculate::SeriesSummary& summary) {
+            QFile file(path);
+            return file.open(QIODevice::ReadOnly) && LineIndex::summarizeRow(file, location, summary, proceed);
+        });
+    });
+
+    dialog->show();
+    watcher->setFuture(QtConcurrent::run([=](QPromise<void>& promise) {
+        scanLineIndex(promise, filePath, model);
+    }));
 }
 }
@@ -11,15 +11,38 @@
 #include <QMessageBox>
 #include <QHeaderView>
 #include <QFileInfo>
+#include <QProgressDialog>
+#include <QFutureWatcher>
+#include <QPromise>
+#include <QSemaphore>
+#include <QSignalBlocker>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QPointer>
+#include <QApplication>
+
+#include <functional>
+#include <memory>
 
 #include "mainwindow.h"
+#include "workspace.h"
+#include "compression.h"
+#include "summary.h"
+#include "lazyTableModel.h"
+#include "workspaceTableModel.h"
 
 namespace Import {
     QString getFilePath(QWidget *parent);
     QString readSingleLineFile(const QString &filePath, QWidget *parent); // Возвращает одну строку
     QStringList parseData(const QString &line, const QRegularExpression &regex);
     void updateTableWithData(QTableWidget *table, const QStringList &data);
-    void importFile(QTableWidget *table);
+    // Импорт в фоновом потоке: строки поступают в таблицу пакетами, onFinished вызывается после загрузки
+    void importFile(QTableWidget *table, std::function<void()> onFinished = {});
+    // Только метрики по рядам файла: таблица и графики не заполняются, память не зависит от размера файла
+    void summarizeFile(QWidget *parent);
+    // Просмотр файла больше памяти: строится разреженный индекс строк, ряды читаются при прокрутке.
+    // Рабочее пространство показывается прямо из отображения файла, без индекса
+    void openLazyView(QWidget *parent);
 }
 
 #endif // IMPORT_H
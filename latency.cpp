@@ -0,0 +1,31 @@
+#include "latency.h"
+
+#include <utility>
+
+namespace Latency
+{
+    namespace {
+        bool enabled = false;
+        QMap<QString, QList<qint64>> samples; // Только из потока интерфейса
+    }
+
+    void setEnabled(bool value)
+    {
+        enabled = value;
+    }
+
+    bool isEnabled()
+    {
+        return enabled;
+    }
+
+    void record(const char* stage, qint64 nsecs)
+    {
+        samples[QString::fromLatin1(stage)].append(nsecs);
+    }
+
+    QMap<QString, QList<qint64>> takeSamples()
+    {
+        return std::exchange(samples, {});
+    }
+}
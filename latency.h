@@ -0,0 +1,40 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+// Замеры длительности этапов обновления окна для uibench. Выключены по умолчанию:
+// Scope тогда только проверяет флаг и ничего не записывает.
+namespace Latency
+{
+    void setEnabled(bool enabled);
+    bool isEnabled();
+
+    void record(const char* stage, qint64 nsecs);
+    QMap<QString, QList<qint64>> takeSamples(); // Накопленные длительности этапов, нс; накопитель очищается
+
+    // Длительность от создания до конца области видимости
+    class Scope
+    {
+    public:
+        explicit Scope(const char* stage) : m_stage(stage)
+        {
+            if (isEnabled()) m_timer.start();
+        }
+        ~Scope()
+        {
+            if (m_timer.isValid()) record(m_stage, m_timer.nsecsElapsed());
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_stage;
+        QElapsedTimer m_timer;
+    };
+}
+
+#endif // LATENCY_H
@@ -0,0 +1,135 @@
+#include "lazyTableModel.h"
+
+#include <algorithm>
+#include <limits>
+
+LazyTableModel::LazyTableModel(const QString& path, QObject* parent)
+    : QAbstractTableModel(parent), m_path(path), m_file(path)
+{
+    m_cache.setMaxCost(lazyCacheCells);
+}
+
+int LazyTableModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) return 0;
+    return static_cast<int>(std::min<qint64>(m_rowCount, std::numeric_limits<int>::max()));
+}
+
+int LazyTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_columnCount;
+}
+
+QVariant LazyTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole)) return QVariant();
+
+    const qsizetype blockIndex = blockOf(index.row());
+    const Block* rows = block(blockIndex);
+    if (!rows) return QVariant();
+
+    const qint64 local = index.row() - m_checkpoints[blockIndex].row;
+    if (local < 0 || local >= rows->size()) return QVariant();
+
+    const QStringList& cells = rows->at(local);
+    return index.column() < cells.size() ? cells[index.column()] : QVariant();
+}
+
+QVariant LazyTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+    return orientation == Qt::Vertical ? seriesName(section) : QString::number(section + 1);
+}
+
+void LazyTableModel::applyUpdate(const LineIndex::Update& update)
+{
+    // Столбцы дальше lazyRowCells не читаются, поэтому и не показываются
+    const int columns = std::min(update.columnCount, lazyRowCells);
+    if (columns > m_columnCount) {
+        beginInsertColumns(QModelIndex(), m_columnCount, columns - 1);
+        m_columnCount = columns;
+        endInsertColumns();
+    }
+
+    const int oldRows = rowCount();
+    m_checkpoints.insert(m_checkpoints.end(), update.checkpoints.begin(), update.checkpoints.end());
+    m_dataEnd = update.dataEnd;
+    m_uncachedIndex = -1; // Последний блок мог пополниться новыми рядами
+    m_finished = update.finished;
+    m_invalidLines = update.invalidLines;
+
+    const int newRows = static_cast<int>(std::min<qint64>(update.rowCount, std::numeric_limits<int>::max()));
+    if (newRows > oldRows) {
+        beginInsertRows(QModelIndex(), oldRows, newRows - 1);
+        m_rowCount = newRows;
+        endInsertRows();
+    }
+
+    if (update.seriesHeaders != m_seriesHeaders) {
+        m_seriesHeaders = update.seriesHeaders;
+        if (m_rowCount > 0) emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
+    }
+}
+
+QString LazyTableModel::seriesName(int row) const
+{
+    return row < m_seriesHeaders.size() ? m_seriesHeaders[row] : QString("Ряд %1").arg(row + 1);
+}
+
+bool LazyTableModel::locateRow(int row, LineIndex::RowLocation& location) const
+{
+    if (row < 0 || row >= m_rowCount) return false;
+
+    const qsizetype blockIndex = blockOf(row);
+    location.begin = m_checkpoints[blockIndex].offset;
+    location.end = blockEnd(blockIndex);
+    location.firstRow = m_checkpoints[blockIndex].row;
+    location.row = row;
+    return true;
+}
+
+qsizetype LazyTableModel::blockOf(qint64 row) const
+{
+    auto it = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), row,
+                               [](qint64 value, const LineIndex::Checkpoint& checkpoint) {
+                                   return value < checkpoint.row;
+                               });
+    return std::max<qsizetype>(0, std::distance(m_checkpoints.begin(), it) - 1);
+}
+
+qint64 LazyTableModel::blockEnd(qsizetype block) const
+{
+    return block + 1 < static_cast<qsizetype>(m_checkpoints.size()) ? m_checkpoints[block + 1].offset
+                                                                    : m_dataEnd;
+}
+
+qint64 LazyTableModel::blockRows(qsizetype block) const
+{
+    const qint64 next = block + 1 < static_cast<qsizetype>(m_checkpoints.size()) ? m_checkpoints[block + 1].row
+                                                                                 : m_rowCount;
+    return next - m_checkpoints[block].row;
+}
+
+const LazyTableModel::Block* LazyTableModel::block(qsizetype index) const
+{
+    if (index < 0 || index >= static_cast<qsizetype>(m_checkpoints.size())) return nullptr;
+    if (Block* cached = m_cache.object(index)) return cached;
+    if (index == m_uncachedIndex) return &m_uncachedBlock;
+    if (!m_file.isOpen() && !m_file.open(QIODevice::ReadOnly)) return nullptr;
+
+    auto loaded = std::make_unique<Block>(LineIndex::readRows(m_file, m_checkpoints[index].offset, blockEnd(index),
+                                                              blockRows(index), lazyRowCells));
+    qsizetype cells = 0;
+    for (const QStringList& row : *loaded) cells += row.size();
+
+    // Последний блок ещё дописывается сканером, а слишком большой вытеснил бы весь кэш
+    const bool complete = m_finished || index + 1 < static_cast<qsizetype>(m_checkpoints.size());
+    if (complete && cells <= m_cache.maxCost()) {
+        Block* raw = loaded.release();
+        m_cache.insert(index, raw, std::max<qsizetype>(1, cells));
+        return raw;
+    }
+    m_uncachedBlock = std::move(*loaded);
+    m_uncachedIndex = index;
+    return &m_uncachedBlock;
+}
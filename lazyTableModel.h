@@ -0,0 +1,59 @@
+#ifndef LAZYTABLEMODEL_H
+#define LAZYTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QFile>
+
+#include <memory>
+#include <vector>
+
+#include "lineIndex.h"
+
+// Модель таблицы поверх разреженного индекса: блоки рядов читаются и разбираются
+// при обращении, разобранные блоки хранятся в LRU-кэше с бюджетом по числу ячеек.
+class LazyTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit LazyTableModel(const QString& path, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void applyUpdate(const LineIndex::Update& update); // Новые ряды из фонового сканирования
+    bool isIndexFinished() const { return m_finished; }
+    const QList<int>& invalidLines() const { return m_invalidLines; }
+    QString seriesName(int row) const;
+    QStringList seriesHeaders() const { return m_seriesHeaders; }
+    QString path() const { return m_path; }
+
+    // Где читать ряд для сводки: сама сводка считается в фоне по своему QFile, без ячеек таблицы
+    bool locateRow(int row, LineIndex::RowLocation& location) const;
+
+private:
+    using Block = QVector<QStringList>;
+
+    qsizetype blockOf(qint64 row) const;
+    qint64 blockEnd(qsizetype block) const;
+    qint64 blockRows(qsizetype block) const;
+    const Block* block(qsizetype index) const;
+
+    QString m_path;
+    mutable QFile m_file;
+    mutable QCache<qsizetype, Block> m_cache;
+    mutable Block m_uncachedBlock;         // Последний прочитанный блок, который нельзя положить в кэш
+    mutable qsizetype m_uncachedIndex = -1; // Его номер; -1 — нет или устарел
+
+    std::vector<LineIndex::Checkpoint> m_checkpoints;
+    qint64 m_rowCount = 0;
+    int m_columnCount = 0;
+    qint64 m_dataEnd = 0;
+    bool m_finished = false;
+    QStringList m_seriesHeaders;
+    QList<int> m_invalidLines;
+};
+
+#endif // LAZYTABLEMODEL_H
@@ -0,0 +1,192 @@
+#include "lineIndex.h"
+#include "summary.h"
+
+#include <algorithm>
+
+namespace LineIndex
+{
+    void Scanner::feed(const char* data, qint64 size)
+    {
+        for (qint64 i = 0; i < size; ++i) {
+            const char c = data[i];
+
+            if (m_inTrailer) {
+                if (c == '\n') processTrailerLine();
+                else m_trailerLine.append(c);
+                continue;
+            }
+
+            if (c == '\n') {
+                endToken();
+                endLine(m_offset + i + 1);
+            } else if (FastParse::isSeparator(c)) {
+                endToken();
+                if (c == ',' || c == ';') m_lineHasContent = true;
+            } else {
+                m_lineHasContent = true;
+                m_tokenIsGap = m_tokenLength == 0 && c == '-';
+                m_tokenLength++;
+                if (FastParse::isLetter(c)) m_lineInvalid = true;
+            }
+        }
+        m_offset += size;
+    }
+
+    void Scanner::finish()
+    {
+        if (m_inTrailer) {
+            if (!m_trailerLine.isEmpty()) processTrailerLine();
+        } else if (m_lineHasContent) {
+            endToken();
+            endLine(m_offset);
+        }
+        m_update.finished = true;
+    }
+
+    Update Scanner::takeUpdate()
+    {
+        Update update = m_update;
+        m_update.checkpoints.clear();
+        return update;
+    }
+
+    void Scanner::endToken()
+    {
+        if (m_tokenLength == 0) return;
+        if (!m_tokenIsGap) m_lastCellIndex = m_tokenIndex;
+        m_tokenIndex++;
+        m_tokenLength = 0;
+        m_tokenIsGap = false;
+    }
+
+    void Scanner::endLine(qint64 lineEnd)
+    {
+        m_lineNumber++;
+
+        if (!m_lineHasContent) {
+            if (++m_emptyLineCounter >= stopLines) m_inTrailer = true;
+        } else {
+            m_emptyLineCounter = 0;
+            if (m_lineInvalid) {
+                m_update.invalidLines.append(m_lineNumber);
+            } else if (m_lastCellIndex >= 0) {
+                const qint64 row = m_update.rowCount;
+                if (row % lazyIndexStrideRows == 0
+                    || m_lineStart - m_lastCheckpointOffset >= lazyIndexStrideBytes) {
+                    m_update.checkpoints.push_back({row, m_lineStart});
+                    m_lastCheckpointOffset = m_lineStart;
+                }
+                m_update.rowCount++;
+                m_update.columnCount = std::max(m_update.columnCount, m_lastCellIndex + 1);
+                m_update.dataEnd = lineEnd;
+            }
+        }
+
+        m_lineStart = lineEnd;
+        m_tokenIndex = 0;
+        m_lastCellIndex = -1;
+        m_lineHasContent = false;
+        m_lineInvalid = false;
+    }
+
+    void Scanner::processTrailerLine()
+    {
+        const QString line = QString::fromUtf8(m_trailerLine).trimmed();
+        m_trailerLine.clear();
+
+        if (m_expectHeaders) {
+            m_update.seriesHeaders = line.split(", ", Qt::SkipEmptyParts);
+            m_expectHeaders = false;
+        } else if (line.startsWith("# Заголовки рядов")) {
+            m_expectHeaders = true;
+        }
+    }
+
+    QVector<QStringList> readRows(QFile& file, qint64 begin, qint64 end, qint64 maxRows, int maxCells)
+    {
+        constexpr int maxCellBytes = 1024; // Длиннее число не бывает, а мусор в ячейке обрезается
+
+        QVector<QStringList> rows;
+        if (end <= begin || maxRows <= 0 || !file.seek(begin)) return rows;
+
+        QStringList cells;
+        QByteArray token;
+        qint64 tokenLength = 0;
+        char tokenFirst = 0;
+        bool hasCells = false;
+
+        auto endToken = [&]() {
+            if (tokenLength == 0) return;
+            const bool gap = tokenLength == 1 && tokenFirst == '-';
+            if (!gap) hasCells = true;
+            if (cells.size() < maxCells) cells.append(gap ? QString() : QString::fromUtf8(token));
+            token.clear();
+            tokenLength = 0;
+        };
+        auto endLine = [&]() {
+            endToken();
+            if (hasCells) rows.append(std::move(cells));
+            cells = QStringList();
+            hasCells = false;
+        };
+
+        std::vector<char> buffer(1 << 20);
+        qint64 remaining = end - begin;
+        while (remaining > 0) {
+            const qint64 n = file.read(buffer.data(), std::min<qint64>(remaining, buffer.size()));
+            if (n <= 0) break;
+            remaining -= n;
+
+            for (qint64 i = 0; i < n; ++i) {
+                const char c = buffer[i];
+                if (c == '\n') {
+                    endLine();
+                    if (rows.size() >= maxRows) return rows;
+                } else if (FastParse::isSeparator(c)) {
+                    endToken();
+                    // Последний нужный ряд набран: остаток строки не читается
+                    if (cells.size() >= maxCells && hasCells && rows.size() + 1 >= maxRows) {
+                        rows.append(std::move(cells));
+                        return rows;
+                    }
+                } else {
+                    if (tokenLength++ == 0) tokenFirst = c;
+                    if (cells.size() < maxCells && token.size() < maxCellBytes) token.append(c);
+                }
+            }
+        }
+        endLine();
+        return rows;
+    }
+
+    bool summarizeRow(QFile& file, const RowLocation& location, Calculate::SeriesSummary& summary,
+                      const std::function<bool(double)>& proceed)
+    {
+        const qint64 begin = location.begin;
+        const qint64 end = location.end;
+        if (location.row < location.firstRow || end <= begin || !file.seek(begin)) return false;
+
+        // Ряд может быть длиннее памяти: значения идут в сводку, не складываясь в ячейки
+        qint64 current = location.firstRow;
+        bool found = false;
+        Summary::StreamParser parser([&](const Calculate::SeriesSummary& series) {
+            if (!found && current == location.row) {
+                summary = series;
+                found = true;
+            }
+            current++;
+        });
+
+        std::vector<char> buffer(1 << 20);
+        qint64 remaining = end - begin;
+        while (remaining > 0 && !found) {
+            const qint64 n = file.read(buffer.data(), std::min<qint64>(remaining, buffer.size()));
+            if (n <= 0) break;
+            parser.feed(buffer.data(), n);
+            remaining -= n;
+            if (proceed && !proceed(1.0 - static_cast<double>(remaining) / (end - begin))) return false;
+        }
+        if (!found) parser.finish();
+        return found;
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+
+#include <functional>
+#include <vector>
+
+#include "globals.h"
+#include "fastParse.h"
+#include "accumulators.h"
+
+// Разреженный индекс строк текстового файла: смещение начала каждого N-го ряда
+// (и не реже, чем через lazyIndexStrideBytes). Ряды разбираются только по запросу.
+namespace LineIndex
+{
+    struct Checkpoint {
+        qint64 row = 0;    // Номер первого ряда блока
+        qint64 offset = 0; // Смещение начала его строки в файле
+    };
+
+    // Порция индекса, которую сканер передаёт модели по мере чтения
+    struct Update {
+        std::vector<Checkpoint> checkpoints; // Только новые с прошлой порции
+        qint64 rowCount = 0;
+        int columnCount = 0;
+        qint64 dataEnd = 0;                  // Конец последнего полностью прочитанного ряда
+        bool finished = false;
+        QStringList seriesHeaders;
+        QList<int> invalidLines;
+    };
+
+    // Однопроходный сканер: считает ряды по тем же правилам, что и импорт
+    // (пустые строки пропускаются, три подряд завершают данные, строки с буквами недопустимы)
+    class Scanner
+    {
+    public:
+        void feed(const char* data, qint64 size);
+        void finish();
+        Update takeUpdate(); // Забирает накопленное с прошлого вызова
+
+        qint64 offset() const { return m_offset; }
+
+    private:
+        void endToken();
+        void endLine(qint64 lineEnd);
+        void processTrailerLine();
+
+        static constexpr int stopLines = 3;
+
+        Update m_update;
+        qint64 m_offset = 0;
+        qint64 m_lineStart = 0;
+        qint64 m_lastCheckpointOffset = -1;
+
+        int m_tokenLength = 0;
+        bool m_tokenIsGap = false;
+        int m_tokenIndex = 0;
+        int m_lastCellIndex = -1;
+        bool m_lineHasContent = false;
+        bool m_lineInvalid = false;
+        int m_lineNumber = 0;
+        int m_emptyLineCounter = 0;
+
+        bool m_inTrailer = false;
+        bool m_expectHeaders = false;
+        QByteArray m_trailerLine;
+    };
+
+    // Первые maxRows рядов блока [begin, end) в виде ячеек; "-" становится пустой ячейкой.
+    // Файл читается порциями, от каждого ряда остаются первые maxCells ячеек: ряд длиннее памяти
+    // не загружается целиком, а чтение заканчивается, как только нужные ряды собраны
+    QVector<QStringList> readRows(QFile& file, qint64 begin, qint64 end, qint64 maxRows, int maxCells);
+
+    // Блок [begin, end), в котором лежит ряд row; по нему ряд читается своим QFile в любом потоке
+    struct RowLocation {
+        qint64 begin = 0;
+        qint64 end = 0;
+        qint64 firstRow = 0; // Номер ряда, с которого начинается блок
+        qint64 row = 0;
+    };
+
+    // Потоковая сводка ряда. proceed(доля прочитанного) вызывается после каждой порции, false прерывает чтение
+    bool summarizeRow(QFile& file, const RowLocation& location, Calculate::SeriesSummary& summary,
+                      const std::function<bool(double)>& proceed = {});
+}
+
+#endif // LINEINDEX_H
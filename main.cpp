@@ -1,13 +1,25 @@
 #include "mainwindow.h"
+#include "batch.h"
+#include "startup.h"
 
 #include <QApplication>
+#include <QGuiApplication>
 #include <QLocale>
 #include <QTranslator>
 #include <QHeaderView>
 
 int main(int argc, char *argv[])
 {
+    // Пакетный режим: без окон и без дисплея, только рисование в файлы
+    if (Batch::isRequested(argc, argv)) {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+        QGuiApplication app(argc, argv);
+        return Batch::run(app.arguments());
+    }
+
+    Startup::start();
     QApplication a(argc, argv);
+    Startup::configure(a.arguments());
 
     QTranslator translator;
     const QStringList uiLanguages = QLocale::system().uiLanguages();
@@ -23,5 +35,6 @@ int main(int argc, char *argv[])
 
     MainWindow w;
     w.show();
+    Startup::watchFirstFrame(&w);
     return a.exec();
 }
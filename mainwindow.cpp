@@ -1,15 +1,12 @@
 #include "mainwindow.h"
 
-// Получение цвета по индексу с цикличностью
+// Палитра общая с быстрым графиком и пакетным режимом
 QColor MainWindow::getSeriesColor(int index) const {
-    return m_seriesColors[index % m_seriesColors.size()];
+    return PlotPainter::seriesColor(index);
 }
 
 QPen MainWindow::getSeriesPen(int index) const {
-    QPen pen(getSeriesColor(index));
-    pen.setWidthF(2.5); // Толщина линии
-    pen.setStyle(Qt::SolidLine); // Стиль линии
-    return pen;
+    return PlotPainter::seriesPen(index);
 }
 
 // Автоматическое затемнение для границ
@@ -38,6 +35,7 @@ QWidget* MainWindow::setupDataSection(QWidget* parent) {
 
     QWidget* statsPanel = setupDataPanel(dataSection);
     QScrollArea* statsScrollArea = Draw::setupDataSectionScrollArea(dataSection, statsPanel);
+    m_statsScrollArea = statsScrollArea;
     QWidget* tablePanel = setupTablePanel(dataSection);
     QSplitter* splitter = Draw::addSplitter(dataSection, statsScrollArea, tablePanel, 1, 2);
 
@@ -49,6 +47,14 @@ QWidget* MainWindow::setupDataSection(QWidget* parent) {
                          statsScrollArea->setVerticalScrollBarPolicy(max > min ? Qt::ScrollBarAsNeeded : Qt::ScrollBarAlwaysOff);
                      });
 
+    // Метрики, попавшие в видимую часть панели, досчитываются по требованию
+    connect(statsScrollArea->verticalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::updateVisibleMetrics);
+    connect(statsScrollArea->verticalScrollBar(), &QScrollBar::rangeChanged, this, &MainWindow::updateVisibleMetrics);
+    for (QToolButton* header : statsPanel->findChildren<QToolButton*>("sectionHeader")) {
+        // После раскрытия секции геометрия строк обновляется только на следующем проходе цикла событий
+        connect(header, &QToolButton::toggled, this, &MainWindow::updateVisibleMetrics, Qt::QueuedConnection);
+    }
+
     return dataSection;
 }
 
@@ -63,16 +69,33 @@ QWidget* MainWindow::setupDataPanel(QWidget* parent)
     statsLayout->setSpacing(8);
 
     QWidget* rowSelectionWidget = Draw::createRowSelectionWidget(statsPanel, &m_rowToCalculateCombo, &m_rowToCalculateLabel);
+    m_rowToCalculateCombo->setModel(m_seriesModel);
+    if (QListView* list = qobject_cast<QListView*>(m_rowToCalculateCombo->view())) {
+        list->setUniformItemSizes(true); // Список из тысяч рядов не измеряет каждую строку
+    }
     statsLayout->addWidget(rowSelectionWidget);
 
+    QPushButton* matrixBtn = new QPushButton("Метрики всех рядов", statsPanel);
+    Draw::connect(matrixBtn, [this]() { showStatsMatrix(); });
+    statsLayout->addWidget(matrixBtn);
+
     Draw::createDataHeader(statsPanel, statsLayout);
-    statsLayout->addWidget(Draw::createBasicDataSection(statsPanel, &m_elementCountLabel, &m_sumLabel, &m_averageLabel));
-    statsLayout->addWidget(Draw::createMeansSection(statsPanel, &m_geometricMeanLabel, &m_harmonicMeanLabel,
-                                                    &m_rmsLabel, &m_trimmedMeanLabel));
-    statsLayout->addWidget(Draw::createDistributionSection(statsPanel, &m_medianLabel, &m_modeLabel, &m_stdDevLabel,
-                                                           &m_skewnessLabel, &m_kurtosisLabel, &m_madLabel, &m_robustStdLabel,
-                                                           &m_shapiroWilkLabel, &m_densityLabel, &m_chiSquareLabel, &m_kolmogorovLabel));
-    statsLayout->addWidget(Draw::createExtremesSection(statsPanel, &m_minLabel, &m_maxLabel, &m_rangeLabel));
+    m_metricTexts.clear();
+    for (const Metrics::Definition& definition : Metrics::registry()) {
+        m_metricTexts.append(definition.format == Metrics::Format::Count ? "0" : na);
+    }
+
+    // При отложенной инициализации секции, кроме основной, свёрнуты и строятся при первом раскрытии
+    auto showTexts = [this]() {
+        for (int i = 0; i < m_metricLabels.size(); ++i) {
+            if (m_metricLabels[i]) m_metricLabels[i]->setText(m_metricTexts[i]);
+        }
+    };
+    for (Metrics::Section section : {Metrics::Section::Basic, Metrics::Section::Means,
+                                     Metrics::Section::Distribution, Metrics::Section::Extremes}) {
+        const bool collapsed = Startup::isDeferred() && section != Metrics::Section::Basic;
+        statsLayout->addWidget(Draw::createMetricSection(statsPanel, section, m_metricLabels, collapsed, showTexts));
+    }
 
     statsLayout->addStretch();
     return statsPanel;
@@ -119,20 +142,33 @@ QWidget* MainWindow::setupTableToolbar(QWidget* parent, QTableWidget* table) {
     return toolbar;
 }
 
+void MainWindow::syncTableSpins() {
+    // Без сигналов: значение, упёршееся в максимум спинбокса, не должно обрезать таблицу
+    const QSignalBlocker rowBlocker(m_rowSpin);
+    const QSignalBlocker colBlocker(m_colSpin);
+    m_rowSpin->setValue(m_table->rowCount());
+    m_colSpin->setValue(m_table->columnCount());
+}
+
 void MainWindow::setupTableActions()
 {
+    // Спинбоксы следуют за размером таблицы, как бы он ни менялся: кнопки, вставка, импорт
+    QAbstractItemModel* tableModel = m_table->model();
+    connect(tableModel, &QAbstractItemModel::rowsInserted, this, &MainWindow::syncTableSpins);
+    connect(tableModel, &QAbstractItemModel::rowsRemoved, this, &MainWindow::syncTableSpins);
+    connect(tableModel, &QAbstractItemModel::columnsInserted, this, &MainWindow::syncTableSpins);
+    connect(tableModel, &QAbstractItemModel::columnsRemoved, this, &MainWindow::syncTableSpins);
+
     // Добавление столбца
     Draw::connect(m_addColBtn, [=]()
                   {
-                      m_table->setColumnCount(m_table->columnCount() + 1);
-                      m_colSpin->setValue(m_table->columnCount()); });
+                      m_table->setColumnCount(m_table->columnCount() + 1); });
 
     // Удаление столбца
     Draw::connect(m_delColBtn, [=]()
                   {
                       if(m_table->columnCount() > 1) {
                           m_table->setColumnCount(m_table->columnCount() - 1);
-                          m_colSpin->setValue(m_table->columnCount());
                       } });
 
     // Очистка таблицы
@@ -147,7 +183,7 @@ void MainWindow::setupTableActions()
 
                       if (reply == QMessageBox::Yes) {
                           m_table->clearContents();
-                          m_colSpin->setValue(m_colSpin->minimum());
+                          m_table->setColumnCount(m_colSpin->minimum());
                       } });
 
     // Авторазмер
@@ -159,13 +195,56 @@ void MainWindow::setupTableActions()
     // Обработка изменения спинбокса столбцов
     Draw::connect(m_colSpin, [=](int value)
                   {
-                      if (value >= m_colSpin->minimum()) {
+                      // Максимум спинбокса меньше ширины таблицы: он её не обрезает
+                      const bool clamped = value == m_colSpin->maximum() && m_table->columnCount() > value;
+                      if (value >= m_colSpin->minimum() && !clamped) {
                           m_table->setColumnCount(value);
                       } });
 
-    // Импорт файлов
-    QObject::connect(m_importBtn, &QPushButton::clicked, [=]() {
-        Import::importFile(m_table);
+    // Импорт файлов: в таблицу или только сводка метрик без загрузки данных
+    QMenu* importMenu = new QMenu(m_importBtn);
+    m_importToTableAction = importMenu->addAction("Импорт в таблицу");
+    QAction* summaryAction = importMenu->addAction("Сводка без загрузки таблицы");
+    m_importBtn->setMenu(importMenu);
+    Draw::connect(m_importToTableAction, [=]() {
+        m_followAction->setChecked(false);
+        // Ячейки импорта заполняются без сигналов модели: все ряды перечитываются после загрузки
+        Import::importFile(m_table, [this]() {
+            m_store.markAllDirty();
+            updateStatistics();
+        });
+    });
+    Draw::connect(summaryAction, [=]() {
+        Import::summarizeFile(this);
+    });
+    QAction* lazyViewAction = importMenu->addAction("Открыть большой файл без загрузки");
+    Draw::connect(lazyViewAction, [=]() {
+        Import::openLazyView(this);
+    });
+    importMenu->addSeparator();
+    m_followAction = importMenu->addAction("Следить за файлом");
+    m_followAction->setCheckable(true);
+    connect(m_followAction, &QAction::toggled, this, [this](bool checked) {
+        if (checked) startFollow();
+        else stopFollow();
+    });
+
+    // Вставка блока и заполнение выделения: ячейки пишутся разом, статистика пересчитывается один раз.
+    // Открытый редактор ячейки сам перехватывает эти сочетания
+    m_pasteAction = new QAction("Вставить", m_table);
+    m_pasteAction->setShortcut(QKeySequence::Paste);
+    m_pasteAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    m_table->addAction(m_pasteAction);
+    Draw::connect(m_pasteAction, [=]() {
+        applyBulkEdit(Clipboard::paste(m_table));
+    });
+
+    m_fillAction = new QAction("Заполнить выделение", m_table);
+    m_fillAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_D));
+    m_fillAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    m_table->addAction(m_fillAction);
+    Draw::connect(m_fillAction, [=]() {
+        applyBulkEdit(Clipboard::fillSelection(m_table));
     });
 
     // Экспорт файлов
@@ -175,31 +254,26 @@ void MainWindow::setupTableActions()
             return;
         }
 
-        QList<QPair<QString, QString>> metrics;
-        for (const auto& [name, label] : getMetricsList()) {
-            metrics.append({name, label->text()});
-        }
-
-        Export::exportData(m_table, metrics);
+        // Метрики рядов экспорт считает сам по снимку таблицы, в фоне
+        m_exportFuture = Export::exportData(m_table);
     });
 
     // Добавление ряда
     Draw::connect(m_addRowBtn, [=]() {
         m_table->setRowCount(m_table->rowCount() + 1);
-        m_rowSpin->setValue(m_table->rowCount());
     });
 
     // Удаление ряда
     Draw::connect(m_delRowBtn, [=]() {
         if(m_table->rowCount() > 1) {
             m_table->setRowCount(m_table->rowCount() - 1);
-            m_rowSpin->setValue(m_table->rowCount());
         }
     });
 
     // Обработка изменения спиннера рядов
     Draw::connect(m_rowSpin, [=](int value) {
-        if (value >= m_rowSpin->minimum()) {
+        const bool clamped = value == m_rowSpin->maximum() && m_table->rowCount() > value;
+        if (value >= m_rowSpin->minimum() && !clamped) {
             m_table->setRowCount(value);
         }
     });
@@ -220,212 +294,126 @@ void MainWindow::setupGraphSettingsSlots() {
 }
 
 void MainWindow::updateMarker(int seriesIndex, bool isMax) {
-    // Проверяем валидность индекса
-    if (seriesIndex < 0 || seriesIndex >= m_table->rowCount()) return;
-
-    // Проверяем существование контейнера маркеров
-    if (!m_seriesMarkers.contains(seriesIndex)) {
-        m_seriesMarkers.insert(seriesIndex, SeriesMarkers{});
-    }
+    if (seriesIndex < 0 || seriesIndex >= m_table->rowCount() || !m_chartView) return;
+    if (m_plotWidget) m_plotWidget->update(); // Быстрый график рисует маркеры по состоянию кнопок
 
     auto& markers = m_seriesMarkers[seriesIndex];
-    QScatterSeries** marker = isMax ? &markers.maxMarker : &markers.minMarker;
-
-    // Удаляем только если маркер существует и добавлен на график
-    if (*marker && m_chartView->chart()->series().contains(*marker)) {
-        m_chartView->chart()->removeSeries(*marker);
-        delete* marker;
-       * marker = nullptr;
-    }
-
-    // Пересчитываем экстремум только если кнопка активна
-    if ((isMax && m_maxButtons[seriesIndex]->isChecked()) ||
-        (!isMax && m_minButtons[seriesIndex]->isChecked())) {
-
-        auto [val, col] = findExtremum(seriesIndex, isMax);
-        if (col != -1) {
-           * marker = Draw::createMarker(col, val, m_chartView->chart(), m_axisX, m_axisY, isMax);
-            // Дополнительная проверка перед добавлением
-            if (*marker && !m_chartView->chart()->series().contains(*marker)) {
-                m_chartView->chart()->addSeries(*marker);
-                (*marker)->attachAxis(m_axisX);
-                (*marker)->attachAxis(m_axisY);
-            }
+    QScatterSeries*& marker = isMax ? markers.maxMarker : markers.minMarker;
+    // Выключенная кнопка убирает маркер с графика
+    if (!m_seriesModel->showMarker(seriesIndex, isMax)) {
+        if (marker) {
+            m_chartView->chart()->removeSeries(marker);
+            delete marker;
+            marker = nullptr;
         }
+        return;
     }
-}
-
-void MainWindow::handleExtremumToggle(int seriesIndex, bool isMax, bool checked) {
-    if (seriesIndex < 0 || seriesIndex >= m_seriesMarkers.size()) return;
-
-    auto& markers = m_seriesMarkers[seriesIndex];
-    QScatterSeries** targetMarker = isMax ? &markers.maxMarker : &markers.minMarker;
-    QMetaObject::Connection* connection = isMax ? &markers.maxConnection : &markers.minConnection;
-
-    // Remove existing marker and disconnect its connection
-    if (*targetMarker) {
-        if (m_chartView && m_chartView->chart()) {
-            m_chartView->chart()->removeSeries(*targetMarker);
-        }
-        delete *targetMarker;
-        *targetMarker = nullptr;
 
-        // Disconnect the specific connection
-        if (*connection) {
-            QObject::disconnect(*connection);
-            *connection = QMetaObject::Connection(); // Reset to null
-        }
+    auto [value, col] = findExtremum(seriesIndex, isMax);
+    if (col == -1) {
+        if (marker) marker->clear(); // Ряд опустел: маркер ждёт новых данных
+        return;
     }
 
-    if (checked) {
-        auto [value, col] = findExtremum(seriesIndex, isMax);
-        if (col != -1 && m_chartView && m_chartView->chart()) {
-            *targetMarker = Draw::createMarker(col, value, m_chartView->chart(),
-                                               m_axisX, m_axisY, isMax);
-
-            // Connect dataChanged and store the connection
-            *connection = connect(m_table->model(), &QAbstractItemModel::dataChanged,
-                                  this, [=, this]() { updateExtremumMarker(seriesIndex, isMax); });
-        }
+    // Существующий маркер переносится в новую точку, серия не пересоздаётся
+    if (marker) {
+        marker->replace(QList<QPointF>{QPointF(col, value)});
+    } else {
+        marker = Draw::createMarker(col, value, m_chartView->chart(), m_axisX, m_axisY, isMax);
     }
 }
 
-
-void MainWindow::updateExtremumMarker(int seriesIndex, bool isMax) {
-    if (seriesIndex < 0 ||
-        seriesIndex >= m_seriesMarkers.size() ||
-        seriesIndex >= m_maxButtons.size() ||
-        seriesIndex >= m_minButtons.size()) return;
-
-    auto& markers = m_seriesMarkers[seriesIndex];
-    QScatterSeries** targetMarker = isMax ? &markers.maxMarker : &markers.minMarker;
-    QPushButton* btn = isMax ? m_maxButtons[seriesIndex] : m_minButtons[seriesIndex];
-
-    if (btn->isChecked()) {
-        handleExtremumToggle(seriesIndex, isMax, true);
+void MainWindow::handleSeriesAdded(const QModelIndex &parent, int first, int last) {
+    // Строки настроек — записи модели; выбор ряда для расчёта не пересчитывает статистику посреди вставки
+    const int settingsCount = qMin(last - first + 1, m_table->rowCount() - m_seriesModel->rowCount());
+    if (settingsCount > 0) {
+        const QSignalBlocker blocker(m_rowToCalculateCombo);
+        m_seriesModel->insertSeries(first, settingsCount);
     }
-}
 
-void MainWindow::handleSeriesAdded(const QModelIndex &parent, int first, int last) {
-    if (QVBoxLayout* layout = qobject_cast<QVBoxLayout*>(m_seriesSettingsContent->layout())) {
-        for(int row = first; row <= last; ++row) {
-            if(row >= m_seriesNameEdits.size()) {
-                QLineEdit* edit;
-                QPushButton* minBtn,* maxBtn;
-                QWidget* rowWidget = Draw::createSeriesNameRow(m_seriesSettingsContent, row, &edit, &minBtn, &maxBtn);
-
-                // Настройка кнопок
-                minBtn->setCheckable(true);
-                maxBtn->setCheckable(true);
-                updateButtonsState(row);
-
-                connect(minBtn, &QPushButton::toggled, [=](bool checked) {
-                    if (!minBtn->isEnabled()) return;
-                    handleExtremumToggle(row, false, checked);
-                });
-
-                connect(maxBtn, &QPushButton::toggled, [=](bool checked) {
-                    if (!maxBtn->isEnabled()) return;
-                    handleExtremumToggle(row, true, checked);
-                });
-
-                // Сохраняем ссылки
-                m_seriesNameEdits.append(edit);
-                m_minButtons.append(minBtn);
-                m_maxButtons.append(maxBtn);
-                m_seriesMarkers.insert(row, SeriesMarkers{});
-
-                layout->insertWidget(row, rowWidget);
-                connect(edit, &QLineEdit::textChanged, this, &MainWindow::updateSeriesNames);
+    // Линия графика создаётся один раз на ряд и живёт, пока ряд есть в таблице
+    const int count = qMin(last - first + 1, m_table->rowCount() - static_cast<int>(m_rowSeries.size()));
+    if (count > 0 && m_chartView) {
+        m_store.insertRows(first, count);
+        m_statsMatrix->insertSeries(first, count);
+        ++m_statsMatrixLayout;
+        for (int row = first; row < first + count; ++row) {
+            QLineSeries* series = createSeries(row, false);
+            series->setName(seriesDisplayName(row));
+            series->setVisible(!m_follower);
+            m_chartView->chart()->addSeries(series);
+            attachSeriesToAxes(series);
+            m_rowSeries.insert(row, series);
+
+            // Пустой ряд не показывается в легенде, пока в нём нет чисел
+            for (QLegendMarker* marker : m_chartView->chart()->legend()->markers(series)) {
+                marker->setVisible(false);
             }
         }
-        updateRowSelectionCombo();
+        if (m_plotWidget) m_plotWidget->invalidateAll();
     }
 }
 
 void MainWindow::handleSeriesRemoved(const QModelIndex &parent, int first, int last) {
-    if (QVBoxLayout* layout = qobject_cast<QVBoxLayout*>(m_seriesSettingsContent->layout())) {
-        for(int i = last; i >= first; --i) {
-            // Удаляем маркеры перед удалением ряда
-            if (m_seriesMarkers.contains(i)) {
-                auto& markers = m_seriesMarkers[i];
-                if (markers.minMarker) {
-                    m_chartView->chart()->removeSeries(markers.minMarker);
-                    delete markers.minMarker;
-                }
-                if (markers.maxMarker) {
-                    m_chartView->chart()->removeSeries(markers.maxMarker);
-                    delete markers.maxMarker;
-                }
-                m_seriesMarkers.remove(i);
+    for(int i = last; i >= first; --i) {
+        // Удаляем маркеры перед удалением ряда
+        if (m_seriesMarkers.contains(i)) {
+            auto& markers = m_seriesMarkers[i];
+            if (markers.minMarker) {
+                m_chartView->chart()->removeSeries(markers.minMarker);
+                delete markers.minMarker;
             }
-
-            // Обновляем индексы для оставшихся элементов
-            for (int j = i; j < m_seriesMarkers.size(); ++j) {
-                if (m_seriesMarkers.contains(j + 1)) {
-                    m_seriesMarkers[j] = m_seriesMarkers.take(j + 1);
-                }
+            if (markers.maxMarker) {
+                m_chartView->chart()->removeSeries(markers.maxMarker);
+                delete markers.maxMarker;
             }
+            m_seriesMarkers.remove(i);
         }
-    }
-}
-
-// Общая функция для поиска экстремумов
-std::pair<double, int> MainWindow::findExtremum(int seriesIndex, bool findMax) {
-    double extremumVal = findMax ? std::numeric_limits<double>::lowest()
-                                : std::numeric_limits<double>::max();
-    int extremumCol = -1;
 
-    if(seriesIndex < 0 || seriesIndex >= m_table->rowCount())
-        return {extremumVal, extremumCol};
-
-    for(int col = 0; col < m_table->columnCount(); ++col) {
-        if(auto item = m_table->item(seriesIndex, col)) {
-            bool ok;
-            double val = item->text().toDouble(&ok);
-            if(ok) {
-                if((findMax && val > extremumVal) || (!findMax && val < extremumVal)) {
-                    extremumVal = val;
-                    extremumCol = col;
-                }
+        // Обновляем индексы для оставшихся элементов
+        for (int j = i; j < m_seriesMarkers.size(); ++j) {
+            if (m_seriesMarkers.contains(j + 1)) {
+                m_seriesMarkers[j] = m_seriesMarkers.take(j + 1);
             }
         }
     }
-    return {extremumVal, extremumCol};
-}
 
-void MainWindow::updateButtonsState(int seriesIndex) {
-    if(seriesIndex < 0 || seriesIndex >= m_minButtons.size())
-        return;
-
-    bool isEmpty = isSeriesEmpty(seriesIndex);
+    for (int row = qMin(last, static_cast<int>(m_rowSeries.size()) - 1); row >= first; --row) {
+        QLineSeries* series = m_rowSeries.takeAt(row);
+        m_chartView->chart()->removeSeries(series);
+        delete series;
+    }
+    m_store.removeRows(first, last - first + 1);
+    m_statsMatrix->removeSeries(first, last - first + 1);
+    ++m_statsMatrixLayout;
+    if (m_plotWidget) m_plotWidget->invalidateAll();
 
-    // Обновляем состояния кнопок
-    QPushButton* minBtn = m_minButtons[seriesIndex];
-    QPushButton* maxBtn = m_maxButtons[seriesIndex];
+    const QSignalBlocker blocker(m_rowToCalculateCombo);
+    m_seriesModel->removeSeries(first, last - first + 1);
+}
 
-    // Блокировка кнопок
-    minBtn->setDisabled(isEmpty);
-    maxBtn->setDisabled(isEmpty);
+// Экстремум ряда хранится в SeriesStore и обновляется вместе с изменёнными ячейками
+std::pair<double, int> MainWindow::findExtremum(int seriesIndex, bool findMax) const {
+    if (seriesIndex < 0 || seriesIndex >= m_store.size() || m_store.series(seriesIndex).isEmpty()) {
+        return {findMax ? std::numeric_limits<double>::lowest() : std::numeric_limits<double>::max(), -1};
+    }
 
-    // Принудительное обновление стилей
-    minBtn->style()->unpolish(minBtn);
-    minBtn->style()->polish(minBtn);
+    const SeriesStore::Series& series = m_store.series(seriesIndex);
+    return findMax ? std::make_pair(series.maxY, series.maxColumn)
+                   : std::make_pair(series.minY, series.minColumn);
+}
 
-    maxBtn->style()->unpolish(maxBtn);
-    maxBtn->style()->polish(maxBtn);
+void MainWindow::updateButtonsState(int seriesIndex) {
+    // Модель сообщает об изменении только при смене состояния: перерисуется одна строка панели
+    m_seriesModel->setHasData(seriesIndex, !isSeriesEmpty(seriesIndex));
 }
 
 bool MainWindow::isSeriesEmpty(int seriesIndex) const {
-    if(seriesIndex < 0 || seriesIndex >= m_table->rowCount())
+    if(seriesIndex < 0 || seriesIndex >= m_store.size())
         return true;
 
-    for(int col = 0; col < m_table->columnCount(); ++col) {
-        if(auto item = m_table->item(seriesIndex, col)) {
-            if(!item->text().isEmpty()) return false;
-        }
-    }
-    return true;
+    // Счётчик непустых ячеек ведёт SeriesStore; ряд, ещё не перечитанный из таблицы, считается по старым данным
+    return m_store.series(seriesIndex).occupiedCells() == 0;
 }
 
 void MainWindow::refreshLegend() {
@@ -456,56 +444,45 @@ void MainWindow::handleShowMax(int seriesIndex) {
     }
 }
 
-void MainWindow::updateSeriesNames() {
-    for(int i = 0; i < m_seriesNameEdits.size(); ++i) {
-        if(QAbstractSeries* series = m_chartView->chart()->series().value(i)) {
-            series->setName(m_seriesNameEdits[i]->text());
+void MainWindow::handleSeriesSettingsChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                                             const QList<int>& roles) {
+    if (roles.contains(SeriesListModel::NameRole)) {
+        updateSeriesNames();
+    }
+    for (int role : {SeriesListModel::ShowMinRole, SeriesListModel::ShowMaxRole}) {
+        if (!roles.contains(role)) continue;
+        for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+            updateMarker(row, role == SeriesListModel::ShowMaxRole);
         }
     }
 }
 
-bool MainWindow::areAllLabelsDefined() {
-    for (const auto& [name, label] : getMetricsList()) {
-        if (!label) return false;
+void MainWindow::updateSeriesNames() {
+    for(int i = 0; i < m_rowSeries.size(); ++i) {
+        m_rowSeries[i]->setName(seriesDisplayName(i));
     }
-    return m_table != nullptr;
+    if (m_plotWidget) m_plotWidget->update();
 }
 
-TableData MainWindow::parse() const {
-    TableData plotData;
-    for (int row = 0; row < m_table->rowCount(); ++row) {
-        std::vector<std::pair<int, int>> rowData;
-
-        for (int col = 0; col < m_table->columnCount(); ++col) {
-            if (auto item = m_table->item(row, col)) {
-                bool ok;
-                double value = item->text().toDouble(&ok);
-                if (ok) {
-                    rowData.emplace_back(col, value);
-                }
-            }
-        }
-
-        if (!rowData.empty()) {
-            plotData.push_back(rowData);
-        }
+QString MainWindow::seriesDisplayName(int row) const {
+    const QString name = m_seriesModel->name(row);
+    if (!name.isEmpty()) {
+        return name;
     }
-    return plotData;
+    return "Наименование ";
 }
 
-std::vector<std::pair<int, int>> MainWindow::getSelectedRowData() const {
-    std::vector<std::pair<int, int>> selectedData;
+bool MainWindow::areAllLabelsDefined() {
+    return m_table != nullptr && m_metricTexts.size() == Metrics::count();
+}
+
+std::vector<std::pair<int, double>> MainWindow::getSelectedRowData() const {
+    std::vector<std::pair<int, double>> selectedData;
     const int targetRow = m_rowToCalculateCombo->currentIndex();
 
-    if(targetRow >= 0 && targetRow < m_table->rowCount()) {
-        for(int col = 0; col < m_table->columnCount(); ++col) {
-            if(auto item = m_table->item(targetRow, col)) {
-                bool ok;
-                double value = item->text().toDouble(&ok);
-                if(ok) {
-                    selectedData.emplace_back(col, value);
-                }
-            }
+    if(targetRow >= 0 && targetRow < m_store.size()) {
+        for(const QPointF& point : m_store.series(targetRow).points) {
+            selectedData.emplace_back(static_cast<int>(point.x()), point.y());
         }
     }
     return selectedData;
@@ -529,70 +506,181 @@ void MainWindow::initializeChart() {
         if (m_chartView) {
             setupChartAxes();
             m_chartView->setRenderHint(QPainter::Antialiasing);
+            m_chartView->setRubberBand(QChartView::HorizontalRubberBand);
+
+            // Масштаб и размер графика меняют число точек на пиксель: прореживание пересчитывается один раз за цикл событий
+            m_decimationTimer = new QTimer(this);
+            m_decimationTimer->setSingleShot(true);
+            m_decimationTimer->setInterval(0);
+            connect(m_decimationTimer, &QTimer::timeout, this, &MainWindow::redecimateSeries);
+            connect(m_axisX, &QValueAxis::rangeChanged, this, [this]() { m_decimationTimer->start(); });
+            connect(m_chartView->chart(), &QChart::plotAreaChanged, this, [this]() { m_decimationTimer->start(); });
             m_chartView->chart()->setBackgroundBrush(Qt::white);
         }
+
+        // Быстрый график рисует те же ряды прямо из SeriesStore
+        m_plotWidget = graphSection->findChild<PlotWidget*>();
+        if (m_plotWidget) {
+            m_plotWidget->setSource(&m_store, [this](int row) {
+                PlotWidget::SeriesStyle style;
+                style.pen = getSeriesPen(row);
+                style.name = seriesDisplayName(row);
+                style.showMin = m_seriesModel->showMarker(row, false);
+                style.showMax = m_seriesModel->showMarker(row, true);
+                return style;
+            });
+            m_plotWidget->setAxisTitles(m_xAxisTitleEdit->text(), m_yAxisTitleEdit->text());
+        }
+
+        connect(m_rendererCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+                this, &MainWindow::setPlotMode);
     }
 }
 
-void MainWindow::updateAxesRange(const TableData& data) {
-    double minX = std::numeric_limits<double>::max();
-    double maxX = std::numeric_limits<double>::min();
-    double minY = std::numeric_limits<double>::max();
-    double maxY = std::numeric_limits<double>::min();
+// Гистограмма выбранного ряда на отдельном графике со своими осями; создаётся при первом выборе
+void MainWindow::ensureHistogramView() {
+    if (m_histogramView) return;
+    auto* stack = qobject_cast<QStackedWidget*>(m_chartView->parentWidget());
+    if (!stack) return;
+
+    m_histogramView = Draw::createHistogramView(stack);
+    stack->addWidget(m_histogramView);
+    m_histogramAxisX = Draw::setupAxis("Значение", 0, 1);
+    m_histogramAxisX->setLabelFormat("%.3g");
+    m_histogramAxisY = Draw::setupAxis("Количество", 0, 1);
+    m_histogramView->chart()->addAxis(m_histogramAxisX, Qt::AlignBottom);
+    m_histogramView->chart()->addAxis(m_histogramAxisY, Qt::AlignLeft);
+}
 
-    // Ищем минимальные и максимальные значения
-    for (const auto& series : data) {
-        for (const auto& [x, y] : series) {
-            minX = std::min(minX, static_cast<double>(x));
-            maxX = std::max(maxX, static_cast<double>(x));
-            minY = std::min(minY, static_cast<double>(y));
-            maxY = std::max(maxY, static_cast<double>(y));
-        }
+void MainWindow::setPlotMode(int mode) {
+    if (mode == 2) ensureHistogramView();
+    m_fastPlot = mode == 1 && m_plotWidget;
+    m_histogramPlot = mode == 2 && m_histogramView;
+    if (auto* stack = qobject_cast<QStackedWidget*>(m_chartView->parentWidget())) {
+        QWidget* current = m_chartView;
+        if (m_fastPlot) current = m_plotWidget;
+        if (m_histogramPlot) current = m_histogramView;
+        stack->setCurrentWidget(current);
     }
 
-    // Устанавливаем новые границы с небольшим запасом
-    const double padding = 0.1;
-    m_axisX->setRange(minX - padding, maxX + padding);
-    m_axisY->setRange(minY - padding, maxY + padding);
+    if (m_fastPlot) {
+        m_plotWidget->invalidateAll();
+    } else if (m_histogramPlot) {
+        updateHistogram();
+    } else {
+        // Пока был выбран быстрый график, линии QtCharts не обновлялись
+        for (int row = 0; row < m_rowSeries.size() && row < m_store.size(); ++row) {
+            updateRowSeries(row);
+        }
+    }
 }
 
-void MainWindow::plotData(const TableData& data) {
-    if (!m_chartView || !m_axisX || !m_axisY) return;
+void MainWindow::updateHistogram() {
+    if (!m_histogramPlot) return;
 
-    clearChart();
+    QChart* chart = m_histogramView->chart();
+    chart->removeAllSeries();
 
-    double minX = std::numeric_limits<double>::max();
-    double maxX = std::numeric_limits<double>::lowest();
-    double minY = std::numeric_limits<double>::max();
-    double maxY = std::numeric_limits<double>::lowest();
+    const int row = m_rowToCalculateCombo->currentIndex();
+    if (row < 0 || row >= m_store.size() || m_store.series(row).isEmpty()) {
+        chart->setTitle("Гистограмма");
+        return;
+    }
 
-    for (size_t i = 0; i < data.size(); ++i) {
-        // Создаем серию один раз
-        QLineSeries* series = createSeries(i,false);
+    std::vector<double> values;
+    values.reserve(m_store.series(row).points.size());
+    for (const QPointF& point : m_store.series(row).points) {
+        values.push_back(point.y());
+    }
+    const Histogram::Bins bins = Histogram::build(values);
+
+    // Ступенчатый контур столбцов; нижняя граница области — ось на нуле
+    QList<QPointF> outline;
+    outline.reserve(2 * bins.size() + 2);
+    std::uint64_t maxCount = 0;
+    outline.append(QPointF(bins.edges.front(), 0));
+    for (int i = 0; i < bins.size(); ++i) {
+        outline.append(QPointF(bins.edges[i], bins.counts[i]));
+        outline.append(QPointF(bins.edges[i + 1], bins.counts[i]));
+        maxCount = qMax(maxCount, bins.counts[i]);
+    }
+    outline.append(QPointF(bins.edges.back(), 0));
+
+    QLineSeries* upper = new QLineSeries();
+    upper->replace(outline);
+    QAreaSeries* area = new QAreaSeries(upper);
+    QColor fill = getSeriesColor(row);
+    area->setPen(QPen(fill.darker(130), 1.0));
+    fill.setAlpha(180);
+    area->setBrush(fill);
+
+    chart->addSeries(area);
+    area->attachAxis(m_histogramAxisX);
+    area->attachAxis(m_histogramAxisY);
+    m_histogramAxisX->setRange(bins.edges.front(), bins.edges.back());
+    m_histogramAxisY->setRange(0, maxCount * 1.1);
+    chart->setTitle(QString("Гистограмма: %1, интервалов %2").arg(seriesDisplayName(row)).arg(bins.size()));
+}
 
-        // Устанавливаем имя из поля ввода или по умолчанию
-        QString seriesName = "Наименование ";
-        if (i < static_cast<size_t>(m_seriesNameEdits.size())) {
-            seriesName = m_seriesNameEdits[i]->text().isEmpty()
-                       ? seriesName
-                       : m_seriesNameEdits[i]->text();
-        }
-        series->setName(seriesName);
+void MainWindow::plotData(const QList<int>& changedRows) {
+    const Latency::Scope latency("plotData");
+    if (!m_chartView || !m_axisX || !m_axisY || changedRows.isEmpty()) return;
 
-        // Добавляем точки и обновляем границы
-        addPointsToSeries(series, data[i], minX, maxX, minY, maxY);
+    // Сначала границы осей: прореживание берёт из них видимый диапазон
+    double minX, maxX, minY, maxY;
+    m_store.bounds(minX, maxX, minY, maxY);
+    updateAxisRanges(minX, maxX, minY, maxY);
 
-        // Добавляем серию на график
-        m_chartView->chart()->addSeries(series);
-        attachSeriesToAxes(series);
+    if (m_fastPlot) {
+        m_plotWidget->markDirty(changedRows);
+        return;
     }
 
-    updateAxisRanges(minX, maxX, minY, maxY);
-    m_chartView->chart()->update();
+    // Неизменённые ряды не трогаются: их линии не перестраиваются и не перерисовываются заново
+    for (int row : changedRows) {
+        if (row < m_rowSeries.size()) updateRowSeries(row);
+    }
 }
-void MainWindow::clearChart() {
-    if (m_chartView) {
-        m_chartView->chart()->removeAllSeries();
+
+void MainWindow::updateRowSeries(int row) {
+    const SeriesStore::Series& data = m_store.series(row);
+    QLineSeries* series = m_rowSeries[row];
+    series->replace(visiblePoints(data.points, data.pyramid)); // Одна замена всех точек
+    for (QLegendMarker* marker : m_chartView->chart()->legend()->markers(series)) {
+        marker->setVisible(!data.isEmpty());
+    }
+}
+
+int MainWindow::plotColumns() const {
+    return qMax(1, qRound(m_chartView->chart()->plotArea().width()));
+}
+
+QList<QPointF> MainWindow::visiblePoints(const QList<QPointF>& points,
+                                         const Decimation::MinMaxPyramid& pyramid) const {
+    return Decimation::decimate(points, pyramid, m_axisX->min(), m_axisX->max(), plotColumns());
+}
+
+void MainWindow::redecimateSeries() {
+    // Короткие ряды показаны целиком и от масштаба не зависят
+    const int budget = 2 * plotColumns();
+    auto refresh = [&](QLineSeries* series, const QList<QPointF>& points, const Decimation::MinMaxPyramid& pyramid) {
+        if (series->isVisible() && (points.size() > budget || series->count() != points.size())) {
+            series->replace(visiblePoints(points, pyramid));
+        }
+    };
+
+    // Линии рядов таблицы не используются, пока выбран быстрый график
+    for (int row = 0; !m_fastPlot && row < m_rowSeries.size() && row < m_store.size(); ++row) {
+        refresh(m_rowSeries[row], m_store.series(row).points, m_store.series(row).pyramid);
+    }
+    for (const FollowedSeries& followed : m_followedSeries) {
+        refresh(followed.line, followed.points, followed.pyramid);
+    }
+}
+
+void MainWindow::setRowSeriesVisible(bool visible) {
+    for (QLineSeries* series : m_rowSeries) {
+        series->setVisible(visible);
     }
 }
 
@@ -623,21 +711,6 @@ QLineSeries* MainWindow::createSeries(int seriesIndex, bool showPoints) {
     return series;
 }
 
-void MainWindow::addPointsToSeries(QLineSeries* series,
-                                   const std::vector<std::pair<int, int>>& data,
-                                   double& minX, double& maxX,
-                                   double& minY, double& maxY) {
-    for (const auto& [x, y] : data) {
-        QPointF point(x, y);
-        series->append(point.x(), point.y());
-
-        minX = qMin(minX, point.x());
-        maxX = qMax(maxX, point.x());
-        minY = qMin(minY, point.y());
-        maxY = qMax(maxY, point.y());
-    }
-}
-
 void MainWindow::attachSeriesToAxes(QXYSeries* series) {
     series->attachAxis(m_axisX);
     series->attachAxis(m_axisY);
@@ -645,136 +718,404 @@ void MainWindow::attachSeriesToAxes(QXYSeries* series) {
 
 void MainWindow::updateAxisRanges(double minX, double maxX, double minY, double maxY) {
     if (minX == std::numeric_limits<double>::max()) { // Нет данных
-        m_axisX->setRange(0, 10);
-        m_axisY->setRange(0, 10);
+        const PlotPainter::AxisScale empty;
+        Draw::applyAxisScale(m_axisX, empty);
+        Draw::applyAxisScale(m_axisY, empty);
+        if (m_plotWidget) m_plotWidget->setRange(empty.min, empty.max, empty.min, empty.max);
         return;
     }
 
     const double xPadding = (maxX - minX)*  0.1;
     const double yPadding = (maxY - minY)*  0.1;
 
-    m_axisX->setRange(minX - xPadding, maxX + xPadding);
-    m_axisY->setRange(minY - yPadding, maxY + yPadding);
+    // Границы округляются до шага меток: при небольших изменениях данных оси остаются прежними
+    const PlotPainter::AxisScale xScale = PlotPainter::niceScale(minX - xPadding, maxX + xPadding);
+    const PlotPainter::AxisScale yScale = PlotPainter::niceScale(minY - yPadding, maxY + yPadding);
+    Draw::applyAxisScale(m_axisX, xScale);
+    Draw::applyAxisScale(m_axisY, yScale);
+    if (m_plotWidget) {
+        m_plotWidget->setRange(xScale.min, xScale.max, yScale.min, yScale.max);
+    }
 }
 
-QString formatValue(double value, int precision = 2) {
-    return QString::number(value, 'f', precision);
+std::vector<bool> MainWindow::visibleMetrics() const {
+    std::vector<bool> visible(m_metricLabels.size(), false);
+    if (!m_statsScrollArea || !m_statsScrollArea->isVisible()) { // До показа окна геометрии ещё нет
+        visible.assign(visible.size(), true);
+        return visible;
+    }
+
+    QWidget* viewport = m_statsScrollArea->viewport();
+    const QRect viewportRect = viewport->rect();
+    for (int i = 0; i < m_metricLabels.size(); ++i) {
+        QWidget* row = m_metricLabels[i] ? m_metricLabels[i]->parentWidget() : nullptr;
+        if (!row || !row->isVisibleTo(m_statsScrollArea->widget())) continue; // Секция свёрнута
+        const QRect rowRect(row->mapTo(viewport, QPoint(0, 0)), row->size());
+        visible[i] = rowRect.intersects(viewportRect);
+    }
+    return visible;
 }
 
-template<typename Func, typename... Args>
-QString MainWindow::calculateAndFormat(bool hasData, Func func, Args&&... args) const {
-    return hasData ? formatValue(func(std::forward<Args>(args)...)) : na;
+void MainWindow::updateVisibleMetrics() {
+    if (m_metricSeries.empty()) return;
+    computeMetrics(visibleMetrics());
+}
+
+void MainWindow::computeMetrics(std::vector<bool> wanted) {
+    if (m_metricSeries.empty()) return;
+
+    bool any = false;
+    for (size_t i = 0; i < wanted.size(); ++i) {
+        wanted[i] = wanted[i] && !m_metricReady[i];
+        any = any || wanted[i];
+    }
+    if (!any) return;
+
+    // Общие промежуточные данные (моменты, сортировка, частоты) строятся один раз на вызов
+    const std::vector<double> values = Metrics::evaluate(m_metricSeries, wanted);
+    bool complete = true;
+    for (size_t i = 0; i < wanted.size(); ++i) {
+        if (wanted[i]) {
+            setMetricText(static_cast<int>(i), Metrics::formatPanel(static_cast<int>(i), values[i]));
+            m_metricReady[i] = true;
+        }
+        complete = complete && m_metricReady[i];
+    }
+    if (complete) {
+        m_metricSeries = std::vector<double>(); // Все строки заполнены: копия ряда больше не нужна
+    }
 }
 
-void MainWindow::updateBasicMetrics(bool hasData, const std::vector<double>& values, double mean) {
-    m_elementCountLabel->setText(hasData ? QString::number(values.size()) : na);
-    m_sumLabel->setText(calculateAndFormat(hasData, Calculate::getSum, values));
-    m_averageLabel->setText(calculateAndFormat(hasData, [mean](){ return mean; }));
+void MainWindow::updateUI(const TableData& data) {
+    const Latency::Scope latency("updateUI");
+    m_metricSeries.clear();
+    const bool hasData = !data.empty() && !data[0].empty();
+
+    // До появления в видимой части строки панели показывают прочерк, а не значения прошлого ряда
+    for (int i = 0; i < m_metricTexts.size(); ++i) {
+        setMetricText(i, na);
+    }
+    if (!hasData) return;
+
+    m_metricSeries.reserve(data[0].size());
+    for (const auto& pair : data[0]) {
+        m_metricSeries.push_back(pair.second);
+    }
+    m_metricReady.assign(m_metricLabels.size(), false);
+    updateVisibleMetrics();
 }
 
-void MainWindow::updateAverages(bool hasData, const std::vector<double>& values) {
-    m_geometricMeanLabel->setText(calculateAndFormat(hasData, Calculate::geometricMean, values));
-    m_harmonicMeanLabel->setText(calculateAndFormat(hasData, Calculate::harmonicMean, values));
-    m_rmsLabel->setText(calculateAndFormat(hasData, Calculate::rootMeanSquare, values));
-    m_trimmedMeanLabel->setText(calculateAndFormat(hasData,
-                                                   Calculate::trimmedMean, values, trimmedMeanPercentage));
+void MainWindow::showCachedMetrics(const std::vector<double>& metrics) {
+    m_metricSeries.clear(); // Все значения уже посчитаны при экспорте файла
+    for (int i = 0; i < m_metricTexts.size() && i < static_cast<int>(metrics.size()); ++i) {
+        setMetricText(i, Metrics::formatPanel(i, metrics[i]));
+    }
 }
 
-void MainWindow::updateDistribution(bool hasData, const std::vector<double>& values, double mean, double stdDev) {
-    m_medianLabel->setText(calculateAndFormat(hasData, Calculate::getMedian, values));
-    m_modeLabel->setText(calculateAndFormat(hasData, Calculate::getMode, values));
-    m_stdDevLabel->setText(calculateAndFormat(hasData, [stdDev](){ return stdDev; }));
-    m_skewnessLabel->setText(calculateAndFormat(hasData, Calculate::skewness, values, mean, stdDev));
-    m_kurtosisLabel->setText(calculateAndFormat(hasData, Calculate::kurtosis, values, mean, stdDev));
-    m_madLabel->setText(calculateAndFormat(hasData, Calculate::medianAbsoluteDeviation, values));
-    m_robustStdLabel->setText(calculateAndFormat(hasData, Calculate::robustStandardDeviation, values));
+void MainWindow::showStatsMatrix() {
+    if (!m_statsMatrixDialog) {
+        m_statsMatrixDialog = Draw::createStatsMatrixDialog(this, m_statsMatrix);
+        refreshStatsMatrix(); // Пока окно было закрыто, ряды только отмечались устаревшими
+    }
+    m_statsMatrixDialog->show();
+    m_statsMatrixDialog->raise();
+    m_statsMatrixDialog->activateWindow();
 }
 
-void MainWindow::updateStatisticalTests(bool hasData, const std::vector<double>& values, double mean) {
-    m_shapiroWilkLabel->setText(calculateAndFormat(hasData, Calculate::shapiroWilkTest, values));
-    m_densityLabel->setText(calculateAndFormat(hasData, Calculate::calculateDensity, values, mean));
-    m_chiSquareLabel->setText(calculateAndFormat(hasData, Calculate::chiSquareTest, values));
-    m_kolmogorovLabel->setText(calculateAndFormat(hasData, Calculate::kolmogorovSmirnovTest, values));
+void MainWindow::refreshStatsMatrix() {
+    if (!m_statsMatrixDialog) return;
+    if (m_statsMatrixWatcher && m_statsMatrixWatcher->isRunning()) return; // Остальное подхватит applyStatsMatrix
+
+    const QList<int> stale = m_statsMatrix->staleSeries();
+    if (stale.isEmpty()) return;
+
+    // Метрики из трейлера файла точные: такие ряды не пересчитываются
+    QList<int> cachedRows;
+    std::vector<std::vector<double>> cachedValues;
+    QList<int> rows;
+    for (int row : stale) {
+        const auto cached = m_cachedMetrics.constFind(row);
+        if (cached != m_cachedMetrics.cend()) {
+            cachedRows.append(row);
+            cachedValues.push_back(*cached);
+        } else {
+            rows.append(row);
+        }
+    }
+    m_statsMatrix->setValues(cachedRows, std::move(cachedValues));
+    if (rows.isEmpty()) return;
+
+    // Рабочие потоки получают копию значений: таблица и SeriesStore меняются, пока идёт расчёт
+    auto snapshot = std::make_shared<std::vector<std::vector<double>>>(rows.size());
+    for (int i = 0; i < rows.size(); ++i) {
+        if (rows[i] >= m_store.size()) continue;
+        const QList<QPointF>& points = m_store.series(rows[i]).points;
+        std::vector<double>& y = (*snapshot)[i];
+        y.reserve(points.size());
+        for (const QPointF& point : points) {
+            y.push_back(point.y());
+        }
+    }
+
+    if (!m_statsMatrixWatcher) {
+        m_statsMatrixWatcher = new QFutureWatcher<std::vector<std::vector<double>>>(this);
+    }
+    m_statsMatrixWatcher->disconnect(this);
+    const int layout = m_statsMatrixLayout;
+    connect(m_statsMatrixWatcher, &QFutureWatcherBase::finished, this, [this, layout]() {
+        applyStatsMatrix(layout);
+    });
+    m_statsMatrixRows = rows;
+    m_statsMatrixRestale.clear();
+    m_statsMatrixWatcher->setFuture(QtConcurrent::run([snapshot]() {
+        return Metrics::evaluateMany(static_cast<int>(snapshot->size()), [&](int i) {
+            return std::move((*snapshot)[i]); // Каждый ряд запрашивается один раз
+        });
+    }));
 }
 
-void MainWindow::updateExtremes(bool hasData, double min, double max, double range) {
-    auto format = [](double val){ return QString::number(val, 'f', statsPrecision); };
-    m_minLabel->setText(hasData ? format(min) : na);
-    m_maxLabel->setText(hasData ? format(max) : na);
-    m_rangeLabel->setText(hasData ? format(range) : na);
+void MainWindow::applyStatsMatrix(int layout) {
+    const QList<int> rows = std::exchange(m_statsMatrixRows, {});
+    const QSet<int> restale = std::exchange(m_statsMatrixRestale, {});
+
+    // Ряды вставлялись или удалялись: номера в результате указывают не на те ряды, они остаются устаревшими
+    if (layout == m_statsMatrixLayout) {
+        m_statsMatrix->setValues(rows, m_statsMatrixWatcher->result());
+        // Значения рядов, изменённых во время расчёта, видны до следующего пересчёта
+        m_statsMatrix->markStale(restale.values());
+    }
+    refreshStatsMatrix();
 }
 
-void MainWindow::updateUI(const TableData& data) {
-    const bool hasData = !data.empty() && !data[0].empty();
-    std::vector<double> values;
+void MainWindow::setMetricText(int index, const QString& text) {
+    m_metricTexts[index] = text;
+    if (QLabel* label = m_metricLabels.value(index)) { // Строки свёрнутой секции могут быть ещё не созданы
+        label->setText(text);
+    }
+}
 
-    if(hasData) {
-        values.reserve(data[0].size());
-        for(const auto& pair : data[0]) {
-            values.push_back(pair.second);
-        }
+void MainWindow::applyBulkEdit(const Clipboard::Result& result) {
+    // Ячейки записаны без itemChanged: ряды перечитываются здесь, пересчёт — один на всю операцию
+    for (int row : result.rows) {
+        m_cachedMetrics.remove(row);
+        m_store.markDirty(row);
+    }
+    syncTableSpins();
+    if (!result.rows.isEmpty()) {
+        updateStatistics();
     }
 
-    const double mean = hasData ? Calculate::getMean(values) : 0.0;
-    const double stdDev = hasData ? Calculate::getStandardDeviation(values, mean) : 0.0;
-    const double min = hasData ?* std::min_element(values.begin(), values.end()) : 0.0;
-    const double max = hasData ?* std::max_element(values.begin(), values.end()) : 0.0;
-    const double range = max - min;
-
-    updateBasicMetrics(hasData, values, mean);
-    updateAverages(hasData, values);
-    updateDistribution(hasData, values, mean, stdDev);
-    updateStatisticalTests(hasData, values, mean);
-    updateExtremes(hasData, min, max, range);
-}
-
-QList<QPair<QString, QLabel*>> MainWindow::getMetricsList() const {
-    return {
-        {"Количество элементов", m_elementCountLabel},
-        {"Сумма", m_sumLabel},
-        {"Среднее арифметическое", m_averageLabel},
-        {"Геометрическое среднее", m_geometricMeanLabel},
-        {"Гармоническое среднее", m_harmonicMeanLabel},
-        {"Квадратичное среднее", m_rmsLabel},
-        {"Усечённое среднее", m_trimmedMeanLabel},
-        {"Медиана", m_medianLabel},
-        {"Мода", m_modeLabel},
-        {"Стандартное отклонение", m_stdDevLabel},
-        {"Асимметрия", m_skewnessLabel},
-        {"Эксцесс", m_kurtosisLabel},
-        {"Медианное абс. отклонение", m_madLabel},
-        {"Робастное стан. отклонение", m_robustStdLabel},
-        {"Тест Шапиро-Уилка", m_shapiroWilkLabel},
-        {"Плотность распределения", m_densityLabel},
-        {"χ²-критерий", m_chiSquareLabel},
-        {"Критерий Колмогорова-Смирнова", m_kolmogorovLabel},
-        {"Минимум", m_minLabel},
-        {"Максимум", m_maxLabel},
-        {"Размах", m_rangeLabel}
-    };
+    if (result.skippedCells > 0) {
+        QMessageBox::warning(this, "Предупреждение",
+                             QString("Нечисловые значения пропущены: %1").arg(result.skippedCells));
+    }
 }
 
 void MainWindow::updateStatistics() {
+    const Latency::Scope latency("updateStatistics");
     if (!areAllLabelsDefined()) return;
 
-    const TableData allData = parse(); // Все данные для графиков
-    const auto selectedData = getSelectedRowData(); // Данные для метрик
+    // В режиме слежения данные живут вне таблицы
+    if (m_follower) {
+        updateFollowStatistics();
+        return;
+    }
+
+    const QList<int> changedRows = m_store.refresh(m_table); // Перечитываются только изменённые ряды
 
-    // Создаем временную TableData для совместимости с updateUI
-    TableData metricsData;
-    if(!selectedData.empty()) {
-        metricsData.push_back(selectedData);
+    const auto cached = m_cachedMetrics.constFind(m_rowToCalculateCombo->currentIndex());
+    if (cached != m_cachedMetrics.cend()) {
+        showCachedMetrics(*cached);
+    } else {
+        const auto selectedData = getSelectedRowData(); // Данные для метрик
+
+        // Создаем временную TableData для совместимости с updateUI
+        TableData metricsData;
+        if(!selectedData.empty()) {
+            metricsData.push_back(selectedData);
+        }
+
+        updateUI(metricsData); // Передаем только выбранный ряд для метрик
     }
+    plotData(changedRows);
+    updateHistogram();
+    m_statsMatrix->markStale(changedRows);
+    if (m_statsMatrixWatcher && m_statsMatrixWatcher->isRunning()) {
+        for (int row : changedRows) m_statsMatrixRestale.insert(row);
+    }
+    refreshStatsMatrix();
 
-    updateUI(metricsData); // Передаем только выбранный ряд для метрик
-    plotData(allData); // Передаем все данные для отрисовки графиков
+    for(int row : changedRows) {
+        updateButtonsState(row);
 
-    for(int i = 0; i < m_table->rowCount(); ++i) {
-        updateButtonsState(i);
+        // Маркеры экстремумов переносятся только у рядов с новыми точками
+        updateMarker(row, false);
+        updateMarker(row, true);
     }
     refreshLegend();
 }
 
+void MainWindow::startFollow() {
+    const QString filePath = Import::getFilePath(this);
+    auto* follower = filePath.isEmpty() ? nullptr : new FileFollower(filePath, this);
+    if (!follower) {
+        m_followAction->setChecked(false);
+        return;
+    }
+
+    connect(follower, &FileFollower::recordsAppended, this, &MainWindow::handleFollowedRecords);
+    connect(follower, &FileFollower::fileReset, this, &MainWindow::handleFollowReset);
+
+    // Таблица не хранит значения ряда: в ней остаются только строки-ряды для панели настроек
+    m_follower = follower;
+    m_table->clearContents();
+    m_table->setRowCount(initialRowCount);
+    m_table->setEnabled(false);
+    setRowSeriesVisible(false);
+    m_rendererCombo->setCurrentIndex(0); // Ряды слежения есть только в QtCharts
+    m_rendererCombo->setEnabled(false);
+    m_followedSeries.clear();
+    handleFollowReset();
+
+    if (!m_followTimer) {
+        m_followTimer = new QTimer(this);
+        m_followTimer->setInterval(followRefreshMs);
+        connect(m_followTimer, &QTimer::timeout, this, &MainWindow::flushFollowedSeries);
+    }
+    m_followTimer->start();
+    setWindowTitle(QString("Glacé — %1").arg(QFileInfo(filePath).fileName()));
+
+    QString error;
+    if (!follower->start(&error)) {
+        QMessageBox::critical(this, "Ошибка", error);
+        m_followAction->setChecked(false);
+    }
+}
+
+void MainWindow::stopFollow() {
+    if (!m_follower) return;
+
+    flushFollowedSeries();
+    m_followTimer->stop();
+    m_follower->deleteLater();
+    m_follower = nullptr;
+    for (const FollowedSeries& followed : m_followedSeries) {
+        m_chartView->chart()->removeSeries(followed.line);
+        delete followed.line;
+    }
+    m_followedSeries.clear();
+    m_table->setEnabled(true);
+    m_rendererCombo->setEnabled(true);
+    setWindowTitle(QString::fromStdString("Glacé"));
+
+    // График возвращается к рядам таблицы
+    setRowSeriesVisible(true);
+    m_store.markAllDirty();
+    updateStatistics();
+}
+
+void MainWindow::handleFollowedRecords(const QVector<QVector<double>>& values) {
+    if (values.size() > m_followedSeries.size()) {
+        const int first = m_followedSeries.size();
+        m_followedSeries.resize(values.size());
+        for (int i = first; i < m_followedSeries.size(); ++i) {
+            QLineSeries* series = createSeries(i, false);
+            series->setName(!m_seriesModel->name(i).isEmpty()
+                                ? m_seriesModel->name(i)
+                                : QString("Ряд %1").arg(i + 1));
+            m_chartView->chart()->addSeries(series);
+            attachSeriesToAxes(series);
+            m_followedSeries[i].line = series;
+        }
+        // Во время экспорта строки добавятся после его завершения
+        if (!m_tableLocked && m_table->rowCount() < m_followedSeries.size()) {
+            m_table->setRowCount(m_followedSeries.size());
+        }
+    }
+
+    const int selected = m_rowToCalculateCombo->currentIndex();
+    for (int i = 0; i < values.size(); ++i) {
+        if (values[i].isEmpty()) continue;
+
+        FollowedSeries& followed = m_followedSeries[i];
+        for (double value : values[i]) {
+            followed.pendingPoints.append(QPointF(static_cast<double>(followed.summary.moments.count), value));
+            followed.summary.add(value);
+        }
+        m_followMinY = std::min(m_followMinY, followed.summary.moments.min);
+        m_followMaxY = std::max(m_followMaxY, followed.summary.moments.max);
+        if (i == selected) m_followStatsDirty = true;
+    }
+}
+
+void MainWindow::handleFollowReset() {
+    for (FollowedSeries& followed : m_followedSeries) {
+        followed.line->clear();
+        followed.summary.clear();
+        followed.points.clear();
+        followed.pyramid.clear();
+        followed.pendingPoints.clear();
+    }
+    m_followMinY = std::numeric_limits<double>::max();
+    m_followMaxY = std::numeric_limits<double>::lowest();
+    m_followStatsDirty = true;
+}
+
+void MainWindow::flushFollowedSeries() {
+    bool appended = false;
+    double maxX = 0.0;
+    for (const FollowedSeries& followed : m_followedSeries) {
+        appended = appended || !followed.pendingPoints.isEmpty();
+        maxX = std::max(maxX, static_cast<double>(followed.summary.moments.count) - 1.0);
+    }
+
+    if (appended) {
+        updateAxisRanges(0.0, maxX, m_followMinY, m_followMaxY);
+    }
+
+    const int budget = 2 * plotColumns();
+    for (FollowedSeries& followed : m_followedSeries) {
+        if (followed.pendingPoints.isEmpty()) continue;
+
+        const qsizetype from = followed.points.size();
+        followed.points.append(followed.pendingPoints);
+        followed.pyramid.append(followed.points, from);
+        if (followed.points.size() <= budget && followed.line->count() == from) {
+            // Только новые точки: уже построенная часть линии не перестраивается
+            followed.line->append(followed.pendingPoints);
+        } else {
+            followed.line->replace(visiblePoints(followed.points, followed.pyramid));
+        }
+        followed.pendingPoints.clear();
+    }
+
+    if (m_followStatsDirty) {
+        updateFollowStatistics();
+    }
+}
+
+void MainWindow::updateFollowStatistics() {
+    m_followStatsDirty = false;
+    const int selected = m_rowToCalculateCombo->currentIndex();
+    if (selected < 0 || selected >= m_followedSeries.size()
+        || m_followedSeries[selected].summary.moments.count == 0) {
+        updateUI({});
+        return;
+    }
+
+    // Для рядов до MAX_SAMPLE_SIZE метрики точные, дальше — по моментам и скетчу
+    m_metricSeries.clear();
+    const auto metrics = Export::summaryMetrics(m_followedSeries[selected].summary);
+    QHash<QString, QString> values;
+    for (const auto& [name, value] : metrics) {
+        values.insert(name, value);
+    }
+    const QList<Metrics::Definition>& definitions = Metrics::registry();
+    for (int i = 0; i < definitions.size(); ++i) {
+        setMetricText(i, values.value(definitions[i].name, na));
+    }
+}
+
 void MainWindow::updateXAxisTitle() {
     if(m_chartView && m_chartView->chart()) {
         // Получаем все горизонтальные оси
@@ -785,6 +1126,7 @@ void MainWindow::updateXAxisTitle() {
             }
         }
     }
+    if (m_plotWidget) m_plotWidget->setAxisTitles(m_xAxisTitleEdit->text(), m_yAxisTitleEdit->text());
 }
 
 void MainWindow::updateYAxisTitle() {
@@ -797,6 +1139,7 @@ void MainWindow::updateYAxisTitle() {
             }
         }
     }
+    if (m_plotWidget) m_plotWidget->setAxisTitles(m_xAxisTitleEdit->text(), m_yAxisTitleEdit->text());
 }
 
 void MainWindow::setupPalette() {
@@ -809,32 +1152,34 @@ void MainWindow::setupPalette() {
 }
 
 void MainWindow::setupTableSlots() {
+    // Изменённый ряд теряет метрики из трейлера файла; подключено раньше пересчёта статистики
+    connect(m_table, &QTableWidget::itemChanged, this, [this](QTableWidgetItem* item) {
+        m_cachedMetrics.remove(item->row());
+        m_store.setCell(item->row(), item->column(), item->text());
+    });
+
     connect(m_table, &QTableWidget::currentCellChanged, [this](int row, int, int, int) {
         updateStatistics();
     });
 
     connect(m_table, &QTableWidget::itemChanged, this, &MainWindow::updateStatistics);
 
-    connect(m_table->model(), &QAbstractItemModel::dataChanged, [this]() {
-        const int rows = m_table->rowCount();
-        const int buttonsCount = qMin(m_minButtons.size(), m_maxButtons.size());
-
-        for (int i = 0; i < qMin(rows, buttonsCount); ++i) {
-            if (m_minButtons[i]->isChecked() || m_maxButtons[i]->isChecked()) {
-                QTimer::singleShot(0, [this, i]() { // Добавляем задержку
-                    if (i < m_table->rowCount()) { // Проверка актуальности индекса
-                        if (m_minButtons[i]->isChecked()) updateMarker(i, false);
-                        if (m_maxButtons[i]->isChecked()) updateMarker(i, true);
-                    }
-                });
-            }
-        }
+    // Сдвиг рядов делает метрики из трейлера файла устаревшими
+    connect(m_table->model(), &QAbstractItemModel::rowsInserted, this, [this]() { m_cachedMetrics.clear(); });
+    connect(m_table->model(), &QAbstractItemModel::rowsRemoved, this, [this]() { m_cachedMetrics.clear(); });
+    connect(m_table->model(), &QAbstractItemModel::columnsRemoved, this, [this]() {
+        m_cachedMetrics.clear();
+        m_store.markAllDirty();
+    });
+    connect(m_table->model(), &QAbstractItemModel::modelReset, this, [this]() {
+        m_cachedMetrics.clear();
+        m_store.markAllDirty();
     });
 
-    // Обновление списка рядов
-    connect(m_table->model(), &QAbstractItemModel::rowsInserted,
+    // Пункты выбора ряда приходят из модели настроек; здесь только доступность и выбор
+    connect(m_seriesModel, &QAbstractItemModel::rowsInserted,
             this, &MainWindow::updateRowSelectionCombo);
-    connect(m_table->model(), &QAbstractItemModel::rowsAboutToBeRemoved,
+    connect(m_seriesModel, &QAbstractItemModel::rowsRemoved,
             this, &MainWindow::updateRowSelectionCombo);
 
     // Обработка выбора ряда
@@ -843,80 +1188,142 @@ void MainWindow::setupTableSlots() {
 }
 
 void MainWindow::updateRowSelectionCombo() {
-    const int prevIndex = m_rowToCalculateCombo->currentIndex();
-    const int rowCount = m_table->rowCount();
+    const int rowCount = m_seriesModel->rowCount();
 
-    m_rowToCalculateCombo->blockSignals(true);
-    m_rowToCalculateCombo->clear();
-
-    for(int i = 0; i < rowCount; ++i) {
-        m_rowToCalculateCombo->addItem(QString("Ряд %1").arg(i+1));
+    // Пункты не пересоздаются: комбобокс сам следит за вставкой и удалением строк модели
+    const QSignalBlocker blocker(m_rowToCalculateCombo);
+    if (rowCount > 0 && m_rowToCalculateCombo->currentIndex() < 0) {
+        m_rowToCalculateCombo->setCurrentIndex(0);
     }
-
-    // Восстанавливаем выбор или устанавливаем первый элемент
-    const int newIndex = rowCount > 0 ? qBound(0, prevIndex, rowCount-1) : -1;
-    m_rowToCalculateCombo->setCurrentIndex(newIndex);
     m_rowToCalculateCombo->setEnabled(rowCount > 0);
-    m_rowToCalculateCombo->blockSignals(false);
 }
 
 void MainWindow::loadStylesheets() {
+    // Повторная установка того же листа заново полирует все виджеты приложения
+    static QString loaded;
     QFile styleFile(":/stylesheets/style.qss");
     styleFile.open(QFile::ReadOnly);
-    QString style = QLatin1String(styleFile.readAll());
+    const QString style = QString::fromUtf8(styleFile.readAll());
+    if (style == loaded && qApp->styleSheet() == loaded) return;
+    loaded = style;
     qApp->setStyleSheet(style);
 }
 
-MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
-    QWidget* mainWidget = new QWidget(this);
-    setCentralWidget(mainWidget);
-    loadStylesheets();
+// График с панелью настроек рядов. placeholder — пустой виджет, занимавший место секции до первого кадра
+void MainWindow::buildGraphSection(QWidget* placeholder) {
+    QWidget* mainWidget = centralWidget();
 
-    // Объявляем переменные для хранения элементов управления
     QLineEdit* xAxisEdit = nullptr;
     QLineEdit* yAxisEdit = nullptr;
-    QWidget* seriesContent = nullptr;
-
-    QWidget* dataSection = setupDataSection(mainWidget);
+    QListView* seriesView = nullptr;
+    QComboBox* rendererCombo = nullptr;
     QWidget* graphSection = Draw::setupGraphSection(
         mainWidget,
         &xAxisEdit,
         &yAxisEdit,
-        &seriesContent
+        &seriesView,
+        &rendererCombo
         );
 
     // Сохраняем ссылки на элементы управления
     m_xAxisTitleEdit = xAxisEdit;
     m_yAxisTitleEdit = yAxisEdit;
-    m_seriesSettingsContent = seriesContent;
+    seriesView->setModel(m_seriesModel);
+    seriesView->setItemDelegate(new SeriesDelegate(seriesView));
+    connect(m_seriesModel, &QAbstractItemModel::dataChanged, this, &MainWindow::handleSeriesSettingsChanged);
+    m_rendererCombo = rendererCombo;
+
+    QVBoxLayout* mainLayout = qobject_cast<QVBoxLayout*>(mainWidget->layout());
+    if (placeholder) {
+        delete mainLayout->replaceWidget(placeholder, graphSection);
+        placeholder->deleteLater();
+    } else {
+        mainLayout->addWidget(graphSection, 1);
+    }
+
+    initializeChart();
+    setupGraphSettingsSlots();
+    setAxisTitles(m_pendingXAxisTitle, m_pendingYAxisTitle); // Если рабочее пространство открыли раньше
+
+    // Линии создаются для всех рядов, уже бывших в таблице; записи модели повторно не вставляются
+    const int rows = m_table->rowCount();
+    if (rows > 0) {
+        handleSeriesAdded(QModelIndex(), 0, rows - 1);
+    }
+}
+
+MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
+    QWidget* mainWidget = new QWidget(this);
+    setCentralWidget(mainWidget);
+    loadStylesheets();
+    Startup::mark("Стили");
+
+    m_seriesModel = new SeriesListModel(this);
+    m_statsMatrix = new StatsMatrixModel(this);
+    QWidget* dataSection = setupDataSection(mainWidget);
+    if (!m_table) {
+        qFatal("Table initialization failed!");
+    }
 
     QVBoxLayout* mainLayout = new QVBoxLayout(mainWidget);
     mainLayout->setContentsMargins(10, 10, 10, 10);
     mainLayout->addWidget(dataSection, 1);
-    mainLayout->addWidget(graphSection, 1);
-
-    if (m_table) {
-        setupTableSlots();
-        initializeChart();
-        setupGraphSettingsSlots();
-        updateRowSelectionCombo();
-
-        // Принудительно создаем поля для начальных рядов
-        QTimer::singleShot(0, this, [this]() {
-            int rows = m_table->rowCount();
-            if(rows > 0) {
-                handleSeriesAdded(QModelIndex(), 0, rows-1);
-            }
-        });
+    setupTableSlots();
 
-        updateStatistics();
+    // Записи настроек для начальных рядов: выбор ряда для расчёта доступен сразу
+    if (m_table->rowCount() > 0) {
+        handleSeriesAdded(QModelIndex(), 0, m_table->rowCount() - 1);
+    }
+    updateRowSelectionCombo();
+    Startup::mark("Панель данных");
+
+    if (Startup::isDeferred()) {
+        // До первого кадра место графика занимает пустой виджет
+        QWidget* placeholder = new QWidget(mainWidget);
+        mainLayout->addWidget(placeholder, 1);
+        Startup::afterFirstFrame([this, placeholder]() {
+            buildGraphSection(placeholder);
+            m_store.markAllDirty(); // Ряды перечитываются уже с линиями графика
+            updateStatistics();
+        });
     } else {
-        qFatal("Table initialization failed!");
+        buildGraphSection(nullptr);
+        Startup::mark("График");
     }
 
+    updateStatistics();
+    Startup::mark("Статистика");
+
     this->setWindowState(Qt::WindowMaximized);
     this->setWindowIcon(QIcon(":/icons/logo.png"));
     this->setWindowTitle(QString::fromStdString("Glacé"));
 }
 
-MainWindow::~MainWindow() {}
+void MainWindow::setTableLocked(bool locked) {
+    if (locked == m_tableLocked) return;
+    m_tableLocked = locked;
+    const QList<QWidget*> widgets = {m_addRowBtn, m_delRowBtn, m_addColBtn, m_delColBtn, m_clearBtn,
+                                     m_rowSpin, m_colSpin, m_exportBtn};
+    for (QWidget* widget : widgets) {
+        widget->setEnabled(!locked);
+    }
+    for (QAction* action : {m_importToTableAction, m_followAction, m_pasteAction, m_fillAction}) {
+        action->setEnabled(!locked);
+    }
+    if (locked) {
+        m_tableEditTriggers = m_table->editTriggers();
+        m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    } else {
+        m_table->setEditTriggers(m_tableEditTriggers);
+    }
+
+    if (!locked && m_follower && m_table->rowCount() < m_followedSeries.size()) {
+        m_table->setRowCount(m_followedSeries.size());
+    }
+}
+
+MainWindow::~MainWindow() {
+    // Фоновый экспорт читает таблицу: отменяется и завершается раньше, чем она удалена
+    m_exportFuture.cancel();
+    m_exportFuture.waitForFinished();
+}
@@ -7,6 +7,19 @@
 #include "structs.h"
 #include "export.h"
 #include "import.h"
+#include "follow.h"
+#include "accumulators.h"
+#include "statsTrailer.h"
+#include "seriesStore.h"
+#include "decimation.h"
+#include "plotWidget.h"
+#include "histogram.h"
+#include "seriesListModel.h"
+#include "seriesDelegate.h"
+#include "clipboard.h"
+#include "startup.h"
+#include "statsMatrixModel.h"
+#include "latency.h"
 
 #include <QMainWindow>
 #include <QTableWidget>
@@ -35,18 +48,34 @@
 #include <QPair>
 #include <QList>
 #include <QComboBox>
+#include <QMenu>
+#include <QAction>
 #include <QScatterSeries>
 #include <QValueAxis>
 #include <QLineSeries>
+#include <QAreaSeries>
+#include <QStackedWidget>
+#include <QPointer>
+#include <QFutureWatcher>
+#include <QSet>
 
 #include <limits>
+#include <memory>
+#include <utility>
 #include <iostream>
 
 struct SeriesMarkers {
     QScatterSeries* maxMarker = nullptr;
     QScatterSeries* minMarker = nullptr;
-    QMetaObject::Connection maxConnection;
-    QMetaObject::Connection minConnection;
+};
+
+// Ряд в режиме слежения: точки графика дописываются, метрики накапливаются без пересчёта
+struct FollowedSeries {
+    QLineSeries* line = nullptr;
+    Calculate::SeriesSummary summary;
+    QList<QPointF> points;        // Все точки ряда; длинный ряд уходит графику прореженным
+    Decimation::MinMaxPyramid pyramid;
+    QList<QPointF> pendingPoints; // Ещё не переданы графику
 };
 
 class MainWindow : public QMainWindow
@@ -57,19 +86,31 @@ public:
     ~MainWindow();
 private slots:
     void updateStatistics();
-    void plotData(const TableData& data);
     void updateXAxisTitle();
     void updateYAxisTitle();
     void updateSeriesNames();
+    void handleSeriesSettingsChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles);
     void handleSeriesAdded(const QModelIndex &parent, int first, int last);
     void handleSeriesRemoved(const QModelIndex &parent, int first, int last);
     void handleShowMin(int seriesIndex);
     void handleShowMax(int seriesIndex);
+    void handleFollowedRecords(const QVector<QVector<double>>& values);
+    void handleFollowReset();
+    void flushFollowedSeries();
+    void redecimateSeries();
 
 private:
-    QWidget* m_seriesSettingsContent;
-    QLineEdit* m_xAxisTitleEdit;
-    QLineEdit* m_yAxisTitleEdit;
+    SeriesListModel* m_seriesModel = nullptr; // Настройки рядов: панель настроек и выбор ряда для расчёта
+    StatsMatrixModel* m_statsMatrix = nullptr; // Метрики всех рядов; считаются, только пока открыто окно
+    QPointer<QDialog> m_statsMatrixDialog;
+    QFutureWatcher<std::vector<std::vector<double>>>* m_statsMatrixWatcher = nullptr; // Фоновый расчёт устаревших рядов
+    QList<int> m_statsMatrixRows;    // Ряды, которые сейчас считаются в фоне
+    QSet<int> m_statsMatrixRestale;  // Изменились во время расчёта: после него снова устаревшие
+    int m_statsMatrixLayout = 0;     // Растёт при вставке и удалении рядов: номера в расчёте больше не верны
+    QLineEdit* m_xAxisTitleEdit = nullptr; // Появляются вместе с секцией графика, после первого кадра
+    QLineEdit* m_yAxisTitleEdit = nullptr;
+    QString m_pendingXAxisTitle;           // Названия, заданные до появления секции графика
+    QString m_pendingYAxisTitle;
     QTableWidget* m_table = nullptr;
     QPushButton* m_addColBtn = nullptr;
     QPushButton* m_delColBtn = nullptr;
@@ -82,75 +123,73 @@ private:
     QPushButton* m_addRowBtn = nullptr;
     QPushButton* m_delRowBtn = nullptr;
     QComboBox* m_rowToCalculateCombo = nullptr;
+    QAction* m_importToTableAction = nullptr;
+    QAction* m_followAction = nullptr;
+    QAction* m_pasteAction = nullptr;
+    QAction* m_fillAction = nullptr;
+    QFuture<void> m_exportFuture;   // Фоновый экспорт снимает таблицу порциями, пока не завершится
+    bool m_tableLocked = false;     // Идёт экспорт: действия, меняющие таблицу, отключены
+    QAbstractItemView::EditTriggers m_tableEditTriggers;
+    FileFollower* m_follower = nullptr;
+    QTimer* m_followTimer = nullptr;
+    QTimer* m_decimationTimer = nullptr; // Пересчёт прореживания после масштабирования и изменения размера
+    QVector<FollowedSeries> m_followedSeries;
+    double m_followMinY = std::numeric_limits<double>::max();
+    double m_followMaxY = std::numeric_limits<double>::lowest();
+    bool m_followStatsDirty = false;
+    QHash<int, std::vector<double>> m_cachedMetrics; // Метрики рядов из трейлера файла, до первого изменения ряда
+    SeriesStore m_store;                // Разобранные значения рядов таблицы
+    QVector<QLineSeries*> m_rowSeries;  // Линия графика каждого ряда таблицы, живёт вместе с рядом
 
-    QLabel* m_elementCountLabel = nullptr;
-    QLabel* m_sumLabel = nullptr;
-    QLabel* m_averageLabel = nullptr;
-    QLabel* m_medianLabel = nullptr;
-    QLabel* m_modeLabel = nullptr;
-    QLabel* m_stdDevLabel = nullptr;
-    QLabel* m_minLabel = nullptr;
-    QLabel* m_maxLabel = nullptr;
-    QLabel* m_rangeLabel = nullptr;
-    QLabel* m_geometricMeanLabel = nullptr;
-    QLabel* m_skewnessLabel = nullptr;
-    QLabel* m_kurtosisLabel = nullptr;
-    QLabel* m_harmonicMeanLabel = nullptr;
-    QLabel* m_trimmedMeanLabel = nullptr;
-    QLabel* m_madLabel = nullptr;
-    QLabel* m_rmsLabel = nullptr;
-    QLabel* m_robustStdLabel = nullptr;
-    QLabel* m_shapiroWilkLabel = nullptr;
-    QLabel* m_densityLabel = nullptr;
-    QLabel* m_chiSquareLabel = nullptr;
-    QLabel* m_kolmogorovLabel = nullptr;
+    QVector<QLabel*> m_metricLabels;    // По индексу Metrics::registry(); nullptr, пока секция не раскрыта
+    QStringList m_metricTexts;          // Текст строк панели, в том числе ещё не созданных
+    QScrollArea* m_statsScrollArea = nullptr;
+    std::vector<double> m_metricSeries; // Значения ряда, пока не все метрики панели посчитаны
+    std::vector<bool> m_metricReady;
     QLabel* m_rowToCalculateLabel = nullptr;
     QChartView* m_chartView = nullptr;
+    PlotWidget* m_plotWidget = nullptr;
+    QComboBox* m_rendererCombo = nullptr;
+    bool m_fastPlot = false; // Выбран PlotWidget: линии QtCharts не обновляются
+    QChartView* m_histogramView = nullptr;
+    QValueAxis* m_histogramAxisX = nullptr;
+    QValueAxis* m_histogramAxisY = nullptr;
+    bool m_histogramPlot = false; // Выбрана гистограмма ряда из m_rowToCalculateCombo
     QValueAxis* m_axisX = nullptr;
     QValueAxis* m_axisY = nullptr;
 
-    QVector<QLineEdit*> m_seriesNameEdits;
-    QVector<QColor> m_seriesColors {
-        QColor("#A8E6CF"), QColor("#DCEDC1"), QColor("#FFD3B6"), QColor("#FFAAA5"),  // Мятный, салатовый, персиковый, розовый
-        QColor("#D4A5A5"), QColor("#FFC8DD"), QColor("#B5EAD7"), QColor("#E2F0CB"),  // Пудровый, малиновый, аквамарин, лайм
-        QColor("#FFDAC1"), QColor("#C7CEEA"), QColor("#F8B195"), QColor("#F67280"),  // Карамельный, лавандовый, коралловый, арбузный
-        QColor("#6B5B95"), QColor("#88B04B"), QColor("#FF6F61"), QColor("#92A8D1")   // Фиолетовый, оливковый, красный, голубой
-    };
     QHash<int, SeriesMarkers> m_seriesMarkers; // Хранит маркеры для каждого ряда
-    QVector<QPushButton*> m_minButtons;
-    QVector<QPushButton*> m_maxButtons;
 
-    void clearChart();
-    void updateExtremumMarker(int seriesIndex, bool isMax);
-    void handleExtremumToggle(int seriesIndex, bool isMax, bool checked);
     QLineSeries* createSeries(int seriesIndex, bool showPoints = false);
-    void addPointsToSeries(QLineSeries* series,
-                           const std::vector<std::pair<int, int>>& data,
-                           double& minX, double& maxX,
-                           double& minY, double& maxY);
+    void plotData(const QList<int>& changedRows);
+    QString seriesDisplayName(int row) const;
+    void setRowSeriesVisible(bool visible);
+    void updateRowSeries(int row);
+    void setPlotMode(int mode); // Индекс m_rendererCombo: QtCharts, быстрый график, гистограмма
+    void updateHistogram();
+    int plotColumns() const;
+    QList<QPointF> visiblePoints(const QList<QPointF>& points, const Decimation::MinMaxPyramid& pyramid) const;
     void updateAxisRanges(double minX, double maxX, double minY, double maxY);
-    TableData parse() const;
     QWidget* setupDataSection(QWidget* parent);
     QWidget* setupDataPanel(QWidget* parent);
-    QWidget* createBasicDataSection(QWidget* parent, QLabel* *elementCountLabel, QLabel* *sumLabel, QLabel* *averageLabel);
-    QWidget* createMeansSection(QWidget* parent);
-    QWidget* createDistributionSection(QWidget* parent);
-    QWidget* createExtremesSection(QWidget* parent);
     QWidget* createCorrelationSection(QWidget* parent);
-    void updateAxesRange(const TableData& data);
     QWidget* setupTableToolbar(QWidget* parent, QTableWidget* table);
     QWidget* setupTablePanel(QWidget* parent);
     void setupTableActions();
+    void applyBulkEdit(const Clipboard::Result& result); // После вставки или заполнения выделения
+    void syncTableSpins(); // Спинбоксы показывают размер таблицы, не меняя его
     void updateUI(const TableData& data);
     void createDataHeader(QWidget* statsPanel, QVBoxLayout* statsLayout);
     bool areAllLabelsDefined();
     void setupChartAxes();
     void initializeChart();
+    void buildGraphSection(QWidget* placeholder);
+    void ensureHistogramView();
     void attachSeriesToAxes(QXYSeries* series);
     void setupGraphSettingsSlots();
     void setupPalette();
     void updateMarker(int seriesIndex, bool isMax);
-    std::pair<double, int> findExtremum(int seriesIndex, bool findMax);
+    std::pair<double, int> findExtremum(int seriesIndex, bool findMax) const;
     bool isSeriesEmpty(int seriesIndex) const;
     void updateButtonsState(int seriesIndex);
     void setupTableSlots();
@@ -160,32 +199,59 @@ private:
     QColor getBorderColor(int index) const;
     void addPointsToSeriesGraph(int seriesIndex, QLineSeries* series);
     void loadStylesheets();
-    void updateBasicMetrics(bool hasData, const std::vector<double>& values, double mean);
-    void updateAverages(bool hasData, const std::vector<double>& values);
-    void updateDistribution(bool hasData, const std::vector<double>& values, double mean, double stdDev);
-    void updateStatisticalTests(bool hasData, const std::vector<double>& values, double mean);
-    void updateExtremes(bool hasData, double min, double max, double range);
-    QList<QPair<QString, QLabel*>> getMetricsList() const;
-    template<typename Func, typename... Args>
-    QString calculateAndFormat(bool hasData, Func func, Args&&... args) const;
+    std::vector<bool> visibleMetrics() const; // Строки панели в развёрнутых секциях и в видимой части прокрутки
+    void updateVisibleMetrics();
+    void computeMetrics(std::vector<bool> wanted); // Досчитывает отмеченные и ещё не готовые строки панели
+    void setMetricText(int index, const QString& text);
     void updateRowSelectionCombo();
-    std::vector<std::pair<int, int>> getSelectedRowData() const;
+    std::vector<std::pair<int, double>> getSelectedRowData() const;
+    void startFollow();
+    void stopFollow();
+    void updateFollowStatistics();
+    void showCachedMetrics(const std::vector<double>& metrics);
+    void showStatsMatrix();
+    void refreshStatsMatrix(); // Запускает фоновый пересчёт устаревших строк открытой таблицы метрик
+    void applyStatsMatrix(int layout); // Результат фонового пересчёта
 
 public:
     QStringList getSeriesHeaders() const {
         QStringList headers;
-        for(auto* edit : m_seriesNameEdits) {
-            headers << (edit->text().isEmpty() ?
-                            QString("Ряд %1").arg(headers.size()+1) :
-                            edit->text());
+        for(int i = 0; i < m_seriesModel->rowCount(); ++i) {
+            const QString name = m_seriesModel->name(i);
+            headers << (name.isEmpty() ? QString("Ряд %1").arg(i+1) : name);
         }
         return headers;
     }
 
     void setSeriesHeaders(const QStringList& headers) {
-        for(int i = 0; i < qMin(headers.size(), m_seriesNameEdits.size()); ++i) {
-            m_seriesNameEdits[i]->setText(headers[i]);
+        m_seriesModel->setNames(headers);
+    }
+
+    // Метрики из трейлера импортированного файла показываются без пересчёта, пока ряд не изменён
+    void setCachedStatistics(const QList<StatsTrailer::SeriesRecord>& records) {
+        m_cachedMetrics.clear();
+        for (const auto& record : records) {
+            if (record.metrics.size() == StatsTrailer::metricCount) {
+                m_cachedMetrics.insert(static_cast<int>(record.row), record.metrics);
+            }
+        }
+    }
+
+    // На время фонового экспорта: правка ячеек, вставка, ряды, столбцы, очистка, импорт и слежение
+    void setTableLocked(bool locked);
+
+    QString xAxisTitle() const { return m_xAxisTitleEdit ? m_xAxisTitleEdit->text() : m_pendingXAxisTitle; }
+    QString yAxisTitle() const { return m_yAxisTitleEdit ? m_yAxisTitleEdit->text() : m_pendingYAxisTitle; }
+
+    // До построения секции графика названия запоминаются и применяются в buildGraphSection
+    void setAxisTitles(const QString& xTitle, const QString& yTitle) {
+        if (!m_xAxisTitleEdit || !m_yAxisTitleEdit) {
+            m_pendingXAxisTitle = xTitle;
+            m_pendingYAxisTitle = yTitle;
+            return;
         }
+        m_xAxisTitleEdit->setText(xTitle);
+        m_yAxisTitleEdit->setText(yTitle);
     }
 };
 
@@ -0,0 +1,286 @@
+#include "metrics.h"
+#include "calculate.h"
+#include "globals.h"
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Metrics
+{
+    void Inputs::buildMoments()
+    {
+        if (m_built & Moments) return;
+        m_built |= Moments;
+
+        // Те же формулы, что у getSum, getMean и getStandardDeviation, но сумма считается один раз
+        const long double sum = std::accumulate(m_values.begin(), m_values.end(), 0.0L);
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        m_sum = std::isfinite(sum) ? static_cast<double>(sum) : nan;
+        m_mean = !m_values.empty() && std::isfinite(sum) ? static_cast<double>(sum / m_values.size()) : nan;
+        m_stdDev = Calculate::getStandardDeviation(m_values, m_mean);
+    }
+
+    double Inputs::sum()
+    {
+        buildMoments();
+        return m_sum;
+    }
+
+    double Inputs::mean()
+    {
+        buildMoments();
+        return m_mean;
+    }
+
+    double Inputs::stdDev()
+    {
+        buildMoments();
+        return m_stdDev;
+    }
+
+    const std::vector<double>& Inputs::sorted()
+    {
+        if (!(m_built & Sorted)) {
+            m_built |= Sorted;
+            m_sorted = Calculate::sortedFinite(m_values);
+        }
+        return m_sorted;
+    }
+
+    const std::map<double, int>& Inputs::frequencies()
+    {
+        if (!(m_built & Frequencies)) {
+            m_built |= Frequencies;
+            if (m_built & Sorted) {
+                // Из отсортированных значений таблица частот собирается за один проход
+                for (double value : m_sorted) {
+                    if (std::isfinite(value)) ++m_frequencies.emplace_hint(m_frequencies.end(), value, 0)->second;
+                }
+            } else {
+                for (double value : m_values) {
+                    if (std::isfinite(value)) ++m_frequencies[value];
+                }
+            }
+        }
+        return m_frequencies;
+    }
+
+    double Inputs::medianAbsoluteDeviation()
+    {
+        if (!m_madBuilt) {
+            m_madBuilt = true;
+            m_mad = Calculate::sortedMedianAbsoluteDeviation(sorted());
+        }
+        return m_mad;
+    }
+
+    const std::vector<Calculate::QuantileSketch::WeightedValue>& SketchInputs::view()
+    {
+        if (!m_viewBuilt) {
+            m_viewBuilt = true;
+            m_view = m_summary.sketch.sortedView();
+        }
+        return m_view;
+    }
+
+    double SketchInputs::medianAbsoluteDeviation()
+    {
+        if (!m_madBuilt) {
+            m_madBuilt = true;
+            m_mad = Calculate::sketchMedianAbsoluteDeviation(view());
+        }
+        return m_mad;
+    }
+
+    const QList<Definition>& registry()
+    {
+        static const QList<Definition> definitions = {
+            {"Количество элементов", "Количество элементов", "elementCountLabel", Section::Basic, 0, 1, 0, Format::Count,
+             [](Inputs& in) { return static_cast<double>(in.values().size()); },
+             [](SketchInputs& in) { return static_cast<double>(in.moments().count); }},
+            {"Сумма", "Сумма", "sumLabel", Section::Basic, Moments, 1, 0, Format::Value,
+             [](Inputs& in) { return in.sum(); },
+             [](SketchInputs& in) { return in.moments().total(); }},
+            {"Среднее арифметическое", "Среднее арифметическое", "averageLabel", Section::Basic, Moments, 1, 0, Format::Value,
+             [](Inputs& in) { return in.mean(); },
+             [](SketchInputs& in) { return in.moments().mean; }},
+
+            {"Геометрическое среднее", "Геом. среднее", "geometricMeanLabel", Section::Means, 0, 1, 0, Format::Value,
+             [](Inputs& in) { return Calculate::geometricMean(in.values()); },
+             [](SketchInputs& in) { return in.moments().geometricMean(); }},
+            {"Гармоническое среднее", "Гарм. среднее", "harmonicMeanLabel", Section::Means, 0, 1, 0, Format::Value,
+             [](Inputs& in) { return Calculate::harmonicMean(in.values()); },
+             [](SketchInputs& in) { return in.moments().harmonicMean(); }},
+            {"Квадратичное среднее", "Квадр. среднее", "rmsLabel", Section::Means, 0, 1, 0, Format::Value,
+             [](Inputs& in) { return Calculate::rootMeanSquare(in.values()); },
+             [](SketchInputs& in) { return in.moments().rootMeanSquare(); }},
+            {"Усечённое среднее", "Усеч. среднее", "trimmedMeanLabel", Section::Means, Sorted, 1, 0, Format::Value,
+             [](Inputs& in) { return Calculate::sortedTrimmedMean(in.sorted(), trimmedMeanPercentage); },
+             [](SketchInputs& in) { return Calculate::sketchTrimmedMean(in.view(), trimmedMeanPercentage); }},
+
+            {"Медиана", "Медиана", "medianLabel", Section::Distribution, Sorted, 1, 0, Format::Value,
+             [](Inputs& in) { return Calculate::sortedMedian(in.sorted()); },
+             [](SketchInputs& in) { return Calculate::sketchQuantile(in.view(), 0.5); }},
+            {"Мода", "Мода", "modeLabel", Section::Distribution, Frequencies, 1, 0, Format::Value,
+             [](Inputs& in) { return Calculate::frequencyMode(in.frequencies()); },
+             nullptr},
+            {"Стандартное отклонение", "Стандартное отклонение", "stdDevLabel", Section::Distribution, Moments, 1, 0, Format::Value,
+             [](Inputs& in) { return in.stdDev(); },
+             [](SketchInputs& in) { return in.stdDev(); }},
+            {"Асимметрия", "Асимметрия", "skewnessLabel", Section::Distribution, Moments, 3, 0, Format::Value,
+             [](Inputs& in) { return Calculate::skewness(in.values(), in.mean(), in.stdDev()); },
+             [](SketchInputs& in) { return in.moments().skewness(); }},
+            {"Эксцесс", "Эксцесс", "kurtosisLabel", Section::Distribution, Moments, 4, 0, Format::Value,
+             [](Inputs& in) { return Calculate::kurtosis(in.values(), in.mean(), in.stdDev()); },
+             [](SketchInputs& in) { return in.moments().kurtosis(); }},
+            {"Медианное абс. отклонение", "Медианное абсолютное отклонение", "madLabel", Section::Distribution, Sorted, 1, 0, Format::Value,
+             [](Inputs& in) { return in.medianAbsoluteDeviation(); },
+             [](SketchInputs& in) { return in.medianAbsoluteDeviation(); }},
+            {"Робастное стан. отклонение", "Робастный стандартный разброс", "robustStdLabel", Section::Distribution, Sorted, 1, 0, Format::Value,
+             [](Inputs& in) {
+                 const double mad = in.medianAbsoluteDeviation();
+                 return (mad != 0.0 && !std::isnan(mad)) ? 1.4826 * mad : std::numeric_limits<double>::quiet_NaN();
+             },
+             [](SketchInputs& in) {
+                 const double mad = in.medianAbsoluteDeviation();
+                 return (mad != 0.0 && !std::isnan(mad)) ? 1.4826 * mad : std::numeric_limits<double>::quiet_NaN();
+             }},
+            {"Тест Шапиро-Уилка", "Шапиро-Уилк", "shapiroWilkLabel", Section::Distribution, Sorted,
+             MIN_SAMPLE_SIZE, MAX_SAMPLE_SIZE, Format::Value,
+             [](Inputs& in) { return Calculate::sortedShapiroWilkTest(in.sorted()); },
+             nullptr},
+            {"Плотность распределения", "Плотность", "densityLabel", Section::Distribution, Moments, 1, 0, Format::Value,
+             [](Inputs& in) { return Calculate::calculateDensity(in.values(), in.mean()); },
+             [](SketchInputs& in) { return Calculate::sketchDensity(in.view(), in.moments().mean); }},
+            {"χ²-критерий", "χ²-критерий", "chiSquareLabel", Section::Distribution, Moments, MIN_SAMPLE_SIZE, 0, Format::Value,
+             [](Inputs& in) { return Calculate::chiSquareTest(in.values(), in.mean(), in.stdDev()); },
+             [](SketchInputs& in) { return Calculate::sketchChiSquareTest(in.view(), in.moments().mean, in.stdDev()); }},
+            {"Критерий Колмогорова-Смирнова", "Колмогоров-Смирнов", "kolmogorovLabel", Section::Distribution, Moments | Sorted,
+             KS_MIN_SAMPLE_SIZE, 0, Format::Value,
+             [](Inputs& in) { return Calculate::sortedKolmogorovSmirnovTest(in.sorted(), in.mean(), in.stdDev()); },
+             [](SketchInputs& in) { return Calculate::sketchKolmogorovSmirnovTest(in.view(), in.moments().mean, in.stdDev()); }},
+
+            {"Минимум", "Минимум", "minLabel", Section::Extremes, Sorted, 1, 0, Format::Extreme,
+             [](Inputs& in) { return in.sorted().empty() ? std::numeric_limits<double>::quiet_NaN() : in.sorted().front(); },
+             [](SketchInputs& in) { return in.moments().min; }},
+            {"Максимум", "Максимум", "maxLabel", Section::Extremes, Sorted, 1, 0, Format::Extreme,
+             [](Inputs& in) { return in.sorted().empty() ? std::numeric_limits<double>::quiet_NaN() : in.sorted().back(); },
+             [](SketchInputs& in) { return in.moments().max; }},
+            {"Размах", "Размах", "rangeLabel", Section::Extremes, Sorted, 1, 0, Format::Extreme,
+             [](Inputs& in) {
+                 const std::vector<double>& sorted = in.sorted();
+                 return sorted.empty() ? std::numeric_limits<double>::quiet_NaN() : sorted.back() - sorted.front();
+             },
+             [](SketchInputs& in) { return in.moments().max - in.moments().min; }}
+        };
+        return definitions;
+    }
+
+    int count()
+    {
+        return registry().size();
+    }
+
+    QString sectionTitle(Section section)
+    {
+        switch (section) {
+        case Section::Basic: return "Основные метрики";
+        case Section::Means: return "Средние";
+        case Section::Distribution: return "Распределение";
+        case Section::Extremes: return "Экстремумы";
+        }
+        return {};
+    }
+
+    std::vector<double> evaluate(const std::vector<double>& values, const std::vector<bool>& wanted)
+    {
+        const QList<Definition>& definitions = registry();
+        std::vector<double> result(definitions.size(), std::numeric_limits<double>::quiet_NaN());
+        if (values.empty()) return result;
+
+        // Сначала отбираются метрики, которые нужны и применимы к размеру ряда
+        const qsizetype size = static_cast<qsizetype>(values.size());
+        std::vector<int> scheduled;
+        unsigned needed = 0;
+        for (int i = 0; i < definitions.size(); ++i) {
+            const Definition& definition = definitions[i];
+            if (!wanted.empty() && (i >= static_cast<int>(wanted.size()) || !wanted[i])) continue;
+            if (size < definition.minSamples || (definition.maxSamples > 0 && size > definition.maxSamples)) continue;
+            scheduled.push_back(i);
+            needed |= definition.inputs;
+        }
+
+        // Сортировка идёт раньше частот: таблица частот тогда собирается из неё без дерева поиска
+        Inputs inputs(values);
+        if (needed & Sorted) inputs.sorted();
+
+        for (int i : scheduled) {
+            try {
+                result[i] = definitions[i].compute(inputs);
+            } catch (...) {
+                // Метрика, бросившая исключение, остаётся NaN
+            }
+        }
+        return result;
+    }
+
+    std::vector<double> evaluateSketch(const Calculate::SeriesSummary& summary)
+    {
+        const QList<Definition>& definitions = registry();
+        std::vector<double> result(definitions.size(), std::numeric_limits<double>::quiet_NaN());
+        SketchInputs inputs(summary);
+        for (int i = 0; i < definitions.size(); ++i) {
+            if (definitions[i].sketch) result[i] = definitions[i].sketch(inputs);
+        }
+        return result;
+    }
+
+    std::vector<std::vector<double>> evaluateMany(int count, const std::function<std::vector<double>(int)>& valuesOf)
+    {
+        std::vector<std::vector<double>> results(qMax(0, count));
+        const int chunks = (count + metricsChunkSeries - 1) / metricsChunkSeries;
+        const int threads = qMin(QThread::idealThreadCount(), chunks);
+
+        // Следующая свободная порция: поток, закончивший свою, сразу берёт новую
+        std::atomic<int> next{0};
+        auto work = [&](int) {
+            for (int first = next.fetch_add(metricsChunkSeries); first < count; first = next.fetch_add(metricsChunkSeries)) {
+                const int last = qMin(first + metricsChunkSeries, count);
+                for (int i = first; i < last; ++i) {
+                    results[i] = evaluate(valuesOf(i));
+                }
+            }
+        };
+
+        if (threads < 2) {
+            work(0);
+        } else {
+            QList<int> workers(threads);
+            std::iota(workers.begin(), workers.end(), 0);
+            QtConcurrent::blockingMap(workers, work);
+        }
+        return results;
+    }
+
+    QString formatPanel(int index, double value)
+    {
+        switch (registry()[index].format) {
+        case Format::Count: return QString::number(static_cast<qint64>(value));
+        case Format::Extreme: return QString::number(value, 'f', statsPrecision);
+        case Format::Value: break;
+        }
+        return QString::number(value, 'f', 2);
+    }
+
+    QString formatExport(int index, double value)
+    {
+        if (registry()[index].format == Format::Count) return QString::number(static_cast<qint64>(value));
+        return QString::number(value, 'f', 2);
+    }
+}
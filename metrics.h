@@ -0,0 +1,108 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "accumulators.h"
+
+#include <QString>
+#include <QList>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+// Единый реестр метрик ряда: панель, экспорт и трейлер берут отсюда названия, порядок,
+// формат и способ расчёта. Каждая метрика объявляет, какие общие промежуточные данные
+// ей нужны; evaluate строит их лениво и не больше одного раза на ряд.
+namespace Metrics
+{
+    enum class Section { Basic, Means, Distribution, Extremes };
+
+    enum Input : unsigned {
+        Moments = 1u << 0,     // Сумма, среднее и стандартное отклонение
+        Sorted = 1u << 1,      // Конечные значения по возрастанию
+        Frequencies = 1u << 2  // Частоты значений
+    };
+
+    enum class Format { Count, Value, Extreme };
+
+    // Промежуточные данные одного ряда, общие для всех метрик
+    class Inputs
+    {
+    public:
+        explicit Inputs(const std::vector<double>& values) : m_values(values) {}
+
+        const std::vector<double>& values() const { return m_values; }
+        double sum();
+        double mean();
+        double stdDev();
+        const std::vector<double>& sorted();
+        const std::map<double, int>& frequencies();
+        double medianAbsoluteDeviation(); // Общая для MAD и робастного отклонения
+
+        unsigned built() const { return m_built; } // Какие Input уже построены
+
+    private:
+        void buildMoments();
+
+        const std::vector<double>& m_values;
+        unsigned m_built = 0;
+        double m_sum = 0.0;
+        double m_mean = 0.0;
+        double m_stdDev = 0.0;
+        std::vector<double> m_sorted;
+        std::map<double, int> m_frequencies;
+        double m_mad = 0.0;
+        bool m_madBuilt = false;
+    };
+
+    // Длинный ряд без самих значений: точные моменты и квантильный скетч из сводки
+    class SketchInputs
+    {
+    public:
+        explicit SketchInputs(const Calculate::SeriesSummary& summary) : m_summary(summary) {}
+
+        const Calculate::MomentAccumulator& moments() const { return m_summary.moments; }
+        double stdDev() const { return m_summary.moments.standardDeviation(); }
+        const std::vector<Calculate::QuantileSketch::WeightedValue>& view(); // Строится при первом запросе
+        double medianAbsoluteDeviation();
+
+    private:
+        const Calculate::SeriesSummary& m_summary;
+        std::vector<Calculate::QuantileSketch::WeightedValue> m_view;
+        bool m_viewBuilt = false;
+        double m_mad = 0.0;
+        bool m_madBuilt = false;
+    };
+
+    struct Definition {
+        QString name;        // В экспорте и трейлере
+        QString title;       // Подпись строки панели
+        QString objectName;
+        Section section;
+        unsigned inputs;     // Маска Input
+        int minSamples;      // Короче — метрика не считается (NaN)
+        int maxSamples;      // 0 — без ограничения сверху
+        Format format;
+        std::function<double(Inputs&)> compute;
+        std::function<double(SketchInputs&)> sketch; // Оценка по сводке длинного ряда; пусто — N/A
+    };
+
+    const QList<Definition>& registry(); // Порядок совпадает с трейлером StatsTrailer
+    int count();
+    QString sectionTitle(Section section);
+
+    // Значения запрошенных метрик; пустой wanted — все. Незапрошенные и неприменимые — NaN
+    std::vector<double> evaluate(const std::vector<double>& values, const std::vector<bool>& wanted = {});
+
+    // Метрики ряда длиннее MAX_SAMPLE_SIZE по его сводке; без оценки по скетчу — NaN
+    std::vector<double> evaluateSketch(const Calculate::SeriesSummary& summary);
+
+    // Все метрики count рядов. Потоки забирают ряды порциями из общей очереди, поэтому длинный ряд
+    // не задерживает остальных; valuesOf(i) вызывается из рабочих потоков и должен только читать данные
+    std::vector<std::vector<double>> evaluateMany(int count, const std::function<std::vector<double>(int)>& valuesOf);
+
+    QString formatPanel(int index, double value);
+    QString formatExport(int index, double value);
+}
+
+#endif // METRICS_H
@@ -0,0 +1,344 @@
+#include "plotWidget.h"
+#include "decimation.h"
+#include "globals.h"
+
+#include <QResizeEvent>
+#include <QFontMetrics>
+
+#include <cmath>
+
+namespace PlotPainter
+{
+    constexpr int marginLeft = 64;
+    constexpr int marginRight = 16;
+    constexpr int marginTop = 28;    // Строка легенды
+    constexpr int marginBottom = 44;
+    constexpr int markerRadius = 5;
+
+    QPointF Range::toPixel(const QPointF& point, const QRectF& area) const
+    {
+        const double spanX = maxX > minX ? maxX - minX : 1.0;
+        const double spanY = maxY > minY ? maxY - minY : 1.0;
+        return QPointF(area.left() + (point.x() - minX) / spanX * area.width(),
+                       area.bottom() - (point.y() - minY) / spanY * area.height());
+    }
+
+    namespace
+    {
+        // Ближайшее «круглое» число: 1, 2, 5 или 10, умноженное на степень десяти
+        double niceNumber(double value, bool round)
+        {
+            const double exponent = std::floor(std::log10(value));
+            const double fraction = value / std::pow(10.0, exponent);
+            double nice;
+            if (round) {
+                nice = fraction < 1.5 ? 1.0 : fraction < 3.0 ? 2.0 : fraction < 7.0 ? 5.0 : 10.0;
+            } else {
+                nice = fraction <= 1.0 ? 1.0 : fraction <= 2.0 ? 2.0 : fraction <= 5.0 ? 5.0 : 10.0;
+            }
+            return nice * std::pow(10.0, exponent);
+        }
+    }
+
+    AxisScale niceScale(double min, double max, int maxTicks)
+    {
+        if (!std::isfinite(min) || !std::isfinite(max)) return {};
+        if (!(max > min)) {
+            // Одно значение: диапазон вокруг него
+            const double half = min != 0.0 ? std::abs(min) * 0.1 : 1.0;
+            min -= half;
+            max += half;
+        }
+
+        AxisScale scale;
+        const double span = niceNumber(max - min, false);
+        scale.step = niceNumber(span / qMax(maxTicks - 1, 1), true);
+        scale.min = std::floor(min / scale.step) * scale.step;
+        scale.max = std::ceil(max / scale.step) * scale.step;
+        scale.ticks = qRound((scale.max - scale.min) / scale.step) + 1;
+        scale.decimals = qMax(0, -static_cast<int>(std::floor(std::log10(scale.step))));
+        return scale;
+    }
+
+    QColor seriesColor(int index)
+    {
+        static const QVector<QColor> palette {
+            QColor("#A8E6CF"), QColor("#DCEDC1"), QColor("#FFD3B6"), QColor("#FFAAA5"),  // Мятный, салатовый, персиковый, розовый
+            QColor("#D4A5A5"), QColor("#FFC8DD"), QColor("#B5EAD7"), QColor("#E2F0CB"),  // Пудровый, малиновый, аквамарин, лайм
+            QColor("#FFDAC1"), QColor("#C7CEEA"), QColor("#F8B195"), QColor("#F67280"),  // Карамельный, лавандовый, коралловый, арбузный
+            QColor("#6B5B95"), QColor("#88B04B"), QColor("#FF6F61"), QColor("#92A8D1")   // Фиолетовый, оливковый, красный, голубой
+        };
+        return palette[index % palette.size()];
+    }
+
+    QPen seriesPen(int index)
+    {
+        QPen pen(seriesColor(index));
+        pen.setWidthF(2.5); // Толщина линии
+        pen.setStyle(Qt::SolidLine); // Стиль линии
+        return pen;
+    }
+
+    QRect plotArea(const QRect& bounds)
+    {
+        return bounds.adjusted(marginLeft, marginTop, -marginRight, -marginBottom);
+    }
+
+    void drawAxes(QPainter& painter, const QRect& area, const Range& range,
+                  const QString& xTitle, const QString& yTitle)
+    {
+        const QFontMetrics metrics(painter.font());
+        painter.setRenderHint(QPainter::Antialiasing, false);
+
+        // Метки на круглых значениях внутри диапазона
+        const AxisScale xScale = niceScale(range.minX, range.maxX);
+        const AxisScale yScale = niceScale(range.minY, range.maxY);
+        for (int i = 0; i < xScale.ticks; ++i) {
+            const double x = xScale.min + xScale.step * i;
+            if (x < range.minX - xScale.step * 1e-9 || x > range.maxX + xScale.step * 1e-9) continue;
+            const double pixel = range.toPixel(QPointF(x, range.minY), area).x();
+
+            painter.setPen(QColor(230, 230, 230));
+            painter.drawLine(QPointF(pixel, area.top()), QPointF(pixel, area.bottom()));
+            painter.setPen(Qt::darkGray);
+            const QString label = QString::number(x, 'f', xScale.decimals);
+            painter.drawText(QPointF(pixel - metrics.horizontalAdvance(label) / 2.0,
+                                     area.bottom() + metrics.height()), label);
+        }
+        for (int i = 0; i < yScale.ticks; ++i) {
+            const double y = yScale.min + yScale.step * i;
+            if (y < range.minY - yScale.step * 1e-9 || y > range.maxY + yScale.step * 1e-9) continue;
+            const double pixel = range.toPixel(QPointF(range.minX, y), area).y();
+
+            painter.setPen(QColor(230, 230, 230));
+            painter.drawLine(QPointF(area.left(), pixel), QPointF(area.right(), pixel));
+            painter.setPen(Qt::darkGray);
+            const QString label = QString::number(y, 'f', yScale.decimals);
+            painter.drawText(QPointF(area.left() - metrics.horizontalAdvance(label) - 6,
+                                     pixel + metrics.ascent() / 2.0), label);
+        }
+
+        painter.setPen(Qt::gray);
+        painter.drawRect(area);
+
+        painter.setPen(Qt::black);
+        painter.drawText(QRect(area.left(), area.bottom() + metrics.height() + 4, area.width(), metrics.height()),
+                         Qt::AlignCenter, xTitle);
+        painter.save();
+        painter.translate(metrics.height(), area.center().y());
+        painter.rotate(-90);
+        painter.drawText(QRect(-area.height() / 2, -metrics.height(), area.height(), metrics.height()),
+                         Qt::AlignCenter, yTitle);
+        painter.restore();
+    }
+
+    void drawPolyline(QPainter& painter, const QPolygonF& polyline, QPen pen, int areaWidth)
+    {
+        if (polyline.isEmpty()) return;
+
+        // Плотная ломаная сливается в полосу: сглаживание и толстое перо там только тратят время
+        const bool dense = polyline.size() >= areaWidth;
+        pen.setCosmetic(true);
+        if (dense) pen.setWidthF(1.0);
+        painter.setRenderHint(QPainter::Antialiasing, !dense);
+        painter.setPen(pen);
+
+        if (polyline.size() == 1) {
+            painter.drawPoint(polyline.first());
+        } else {
+            painter.drawPolyline(polyline);
+        }
+    }
+
+    void drawMarker(QPainter& painter, const QPointF& center, bool isMax)
+    {
+        // Цвета совпадают с маркерами Draw::createMarker
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        painter.setPen(QPen(Qt::white, 1.5));
+        painter.setBrush(isMax ? QColor(255, 102, 102) : QColor(102, 255, 102));
+        painter.drawEllipse(center, markerRadius, markerRadius);
+        painter.setBrush(Qt::NoBrush);
+    }
+
+    void drawLegend(QPainter& painter, const QRect& area, const QList<QPair<QString, QColor>>& entries)
+    {
+        const QFontMetrics metrics(painter.font());
+        const int swatch = metrics.height() / 2 + 4;
+        const int baseline = area.top() - marginTop + (marginTop + metrics.ascent()) / 2;
+        int x = area.left();
+
+        for (const auto& [name, color] : entries) {
+            const int width = swatch + 4 + metrics.horizontalAdvance(name) + 12;
+            if (x + width > area.right()) {
+                painter.setPen(Qt::black);
+                painter.drawText(QPointF(x, baseline), "…");
+                return;
+            }
+
+            painter.fillRect(QRect(x, baseline - swatch + 2, swatch, swatch), color);
+            painter.setPen(Qt::black);
+            painter.drawText(QPointF(x + swatch + 4, baseline), name);
+            x += width;
+        }
+    }
+}
+
+PlotWidget::PlotWidget(QWidget* parent) : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumSize(200, 150);
+}
+
+void PlotWidget::setSource(const SeriesStore* store, StyleProvider style)
+{
+    m_store = store;
+    m_style = std::move(style);
+    invalidateAll();
+}
+
+void PlotWidget::setRange(double minX, double maxX, double minY, double maxY)
+{
+    if (minX == m_range.minX && maxX == m_range.maxX && minY == m_range.minY && maxY == m_range.maxY) return;
+
+    m_range = {minX, maxX, minY, maxY};
+    invalidateAll(); // Новый диапазон меняет пиксельные координаты всех рядов
+}
+
+void PlotWidget::setAxisTitles(const QString& xTitle, const QString& yTitle)
+{
+    m_xTitle = xTitle;
+    m_yTitle = yTitle;
+    update();
+}
+
+void PlotWidget::markDirty(const QList<int>& rows)
+{
+    for (int row : rows) {
+        if (row >= 0 && row < m_tiles.size()) m_tiles[row].valid = false;
+    }
+    update();
+}
+
+void PlotWidget::invalidateAll()
+{
+    m_tiles.clear();
+    m_layers.clear();
+    update();
+}
+
+void PlotWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    invalidateAll();
+}
+
+void PlotWidget::rebuildTile(int row, const QRect& area)
+{
+    Tile& tile = m_tiles[row];
+    tile.polyline.clear();
+
+    const SeriesStore::Series& series = m_store->series(row);
+    if (!series.isEmpty()) {
+        // Не больше двух точек на столбец пикселей, пики сохраняются
+        const QList<QPointF> points = Decimation::decimate(series.points, series.pyramid,
+                                                           m_range.minX, m_range.maxX, area.width());
+        const QRect local(QPoint(0, 0), area.size());
+        tile.polyline.reserve(points.size());
+        for (const QPointF& point : points) {
+            tile.polyline.append(m_range.toPixel(point, local));
+        }
+    }
+    tile.valid = true;
+}
+
+void PlotWidget::renderLayer(int layer, const QRect& area)
+{
+    QImage& image = m_layers[layer].image;
+    const qreal ratio = devicePixelRatioF();
+    const QSize size = area.size() * ratio;
+    if (image.size() != size) {
+        image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+    }
+    image.setDevicePixelRatio(ratio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setClipRect(QRect(QPoint(0, 0), area.size()));
+    const int first = layer * m_layerSeries;
+    const int last = qMin(first + m_layerSeries, static_cast<int>(m_tiles.size()));
+    for (int row = first; row < last; ++row) {
+        const QPen pen = m_style ? m_style(row).pen : QPen(Qt::black);
+        PlotPainter::drawPolyline(painter, m_tiles[row].polyline, pen, area.width());
+    }
+    m_layers[layer].valid = true;
+}
+
+void PlotWidget::drawMarkers(QPainter& painter, const QRect& area) const
+{
+    if (!m_store || !m_style) return;
+
+    for (int row = 0; row < m_store->size(); ++row) {
+        const SeriesStore::Series& series = m_store->series(row);
+        if (series.isEmpty()) continue;
+
+        const SeriesStyle style = m_style(row);
+        if (style.showMin) {
+            PlotPainter::drawMarker(painter, m_range.toPixel(QPointF(series.minColumn, series.minY), area), false);
+        }
+        if (style.showMax) {
+            PlotPainter::drawMarker(painter, m_range.toPixel(QPointF(series.maxColumn, series.maxY), area), true);
+        }
+    }
+}
+
+void PlotWidget::drawLegend(QPainter& painter, const QRect& area) const
+{
+    if (!m_store || !m_style) return;
+
+    QList<QPair<QString, QColor>> entries;
+    for (int row = 0; row < m_store->size(); ++row) {
+        if (m_store->series(row).isEmpty()) continue;
+        const SeriesStyle style = m_style(row);
+        entries.append({style.name, style.pen.color()});
+    }
+    PlotPainter::drawLegend(painter, area, entries);
+}
+
+void PlotWidget::paintEvent(QPaintEvent*)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+
+    const QRect area = PlotPainter::plotArea(rect());
+    if (area.width() <= 0 || area.height() <= 0) return;
+
+    if (m_store) {
+        const int count = m_store->size();
+        if (m_tiles.size() != count) {
+            m_tiles = QVector<Tile>(count);
+        }
+        const int layerSeries = qMax(1, (count + plotLayerCount - 1) / plotLayerCount);
+        const int layerCount = (count + layerSeries - 1) / layerSeries;
+        if (layerSeries != m_layerSeries || m_layers.size() != layerCount) {
+            m_layerSeries = layerSeries;
+            m_layers = QVector<Layer>(layerCount);
+        }
+        // Перестраиваются только ломаные изменённых рядов и слои, в которых они лежат
+        for (int row = 0; row < count; ++row) {
+            if (!m_tiles[row].valid) {
+                rebuildTile(row, area);
+                m_layers[row / m_layerSeries].valid = false;
+            }
+        }
+        for (int layer = 0; layer < m_layers.size(); ++layer) {
+            if (!m_layers[layer].valid) renderLayer(layer, area);
+        }
+    }
+
+    PlotPainter::drawAxes(painter, area, m_range, m_xTitle, m_yTitle);
+    for (const Layer& layer : m_layers) {
+        painter.drawImage(area.topLeft(), layer.image);
+    }
+    drawMarkers(painter, area);
+    drawLegend(painter, area);
+}
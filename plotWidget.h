@@ -0,0 +1,105 @@
+#ifndef PLOTWIDGET_H
+#define PLOTWIDGET_H
+
+#include <QWidget>
+#include <QImage>
+#include <QPolygonF>
+#include <QPen>
+#include <QVector>
+#include <QPainter>
+
+#include <functional>
+
+#include "seriesStore.h"
+
+// Рисование осей, ломаных и легенды на любом QPainter: общая часть PlotWidget и пакетного режима
+namespace PlotPainter
+{
+    struct Range {
+        double minX = 0.0;
+        double maxX = 10.0;
+        double minY = 0.0;
+        double maxY = 10.0;
+
+        QPointF toPixel(const QPointF& point, const QRectF& area) const;
+    };
+
+    // Границы оси, кратные «круглому» шагу 1, 2 или 5·10^k: метки не сдвигаются
+    // от небольших изменений данных и не требуют новой раскладки
+    struct AxisScale {
+        double min = 0.0;
+        double max = 10.0;
+        double step = 2.0;
+        int ticks = 6;     // Меток вместе с крайними
+        int decimals = 0;  // Знаков после запятой, достаточных для шага
+    };
+    AxisScale niceScale(double min, double max, int maxTicks = 6);
+
+    QColor seriesColor(int index);       // Цвет ряда по индексу с цикличностью
+    QPen seriesPen(int index);
+    QRect plotArea(const QRect& bounds); // Область графика внутри отступов под подписи
+    void drawAxes(QPainter& painter, const QRect& area, const Range& range,
+                  const QString& xTitle, const QString& yTitle);
+    void drawPolyline(QPainter& painter, const QPolygonF& polyline, QPen pen, int areaWidth);
+    void drawMarker(QPainter& painter, const QPointF& center, bool isMax);
+    void drawLegend(QPainter& painter, const QRect& area, const QList<QPair<QString, QColor>>& entries);
+}
+
+// Лёгкий график для большого числа длинных рядов: рисует прямо из SeriesStore через QPainter.
+// Для каждого ряда кэшируется ломаная в пикселях для текущего диапазона осей и размера,
+// а соседние ряды растеризуются группами в отдельные слои (не больше plotLayerCount).
+// Изменённый ряд перестраивает свою ломаную и перерисовывает только свой слой.
+class PlotWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    struct SeriesStyle {
+        QPen pen;
+        QString name;
+        bool showMin = false;
+        bool showMax = false;
+    };
+    using StyleProvider = std::function<SeriesStyle(int row)>;
+
+    explicit PlotWidget(QWidget* parent = nullptr);
+
+    void setSource(const SeriesStore* store, StyleProvider style);
+    void setRange(double minX, double maxX, double minY, double maxY);
+    void setAxisTitles(const QString& xTitle, const QString& yTitle);
+
+    void markDirty(const QList<int>& rows); // Точки рядов изменились
+    void invalidateAll();                   // Ряды добавлены, удалены или перечитаны
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    struct Tile {
+        QPolygonF polyline; // Прореженные точки ряда в координатах слоя
+        bool valid = false;
+    };
+
+    // Растр линий группы соседних рядов; слои накладываются по порядку рядов
+    struct Layer {
+        QImage image;
+        bool valid = false;
+    };
+
+    void rebuildTile(int row, const QRect& area);
+    void renderLayer(int layer, const QRect& area);
+    void drawMarkers(QPainter& painter, const QRect& area) const;
+    void drawLegend(QPainter& painter, const QRect& area) const;
+
+    const SeriesStore* m_store = nullptr;
+    StyleProvider m_style;
+    QVector<Tile> m_tiles;
+    QVector<Layer> m_layers;
+    int m_layerSeries = 1;   // Рядов в одном слое
+
+    PlotPainter::Range m_range;
+    QString m_xTitle;
+    QString m_yTitle;
+};
+
+#endif // PLOTWIDGET_H
@@ -0,0 +1,135 @@
+#include "seriesDelegate.h"
+
+namespace {
+    // Размеры те же, что были у виджетов строки: кнопки 40×24 с промежутком 4
+    constexpr int buttonWidth = 40;
+    constexpr int buttonHeight = 24;
+    constexpr int spacing = 4;
+    constexpr int rowHeight = 32;
+
+    struct ButtonColors {
+        QColor background;
+        QColor border;
+        QColor text;
+    };
+
+    // Цвета кнопок рядов из style.qss: обычная, включённая и заблокированная
+    ButtonColors buttonColors(bool checked, bool enabled)
+    {
+        if (!enabled) return {QColor("#303030"), QColor("#404040"), QColor("#707070")};
+        if (checked) return {QColor("#2a82da"), QColor("#3daee9"), QColor("#ffffff")};
+        return {QColor("#404040"), QColor("#505050"), QColor("#b0b0b0")};
+    }
+}
+
+QRect SeriesDelegate::buttonRect(const QStyleOptionViewItem& option, bool isMax)
+{
+    const QRect& rect = option.rect;
+    const int left = rect.left() + (isMax ? buttonWidth + spacing : 0);
+    return QRect(left, rect.top() + (rect.height() - buttonHeight) / 2, buttonWidth, buttonHeight);
+}
+
+QRect SeriesDelegate::labelRect(const QStyleOptionViewItem& option)
+{
+    const int left = buttonRect(option, true).right() + 1 + spacing;
+    const int width = option.fontMetrics.horizontalAdvance("График 00000:");
+    return QRect(left, option.rect.top(), width, option.rect.height());
+}
+
+QRect SeriesDelegate::nameRect(const QStyleOptionViewItem& option)
+{
+    const int left = labelRect(option).right() + 1 + spacing;
+    return QRect(left, option.rect.top() + 2, qMax(0, option.rect.right() - left), option.rect.height() - 4);
+}
+
+void SeriesDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    const bool hasData = index.data(SeriesListModel::HasDataRole).toBool();
+    const struct { bool isMax; const char* text; int role; } buttons[] = {
+        {false, "MIN", SeriesListModel::ShowMinRole},
+        {true, "MAX", SeriesListModel::ShowMaxRole}
+    };
+    for (const auto& button : buttons) {
+        const ButtonColors colors = buttonColors(index.data(button.role).toBool(), hasData);
+        const QRectF rect = QRectF(buttonRect(option, button.isMax)).adjusted(0.5, 0.5, -0.5, -0.5);
+        painter->setPen(colors.border);
+        painter->setBrush(colors.background);
+        painter->drawRoundedRect(rect, 4, 4);
+        painter->setPen(colors.text);
+        painter->drawText(rect, Qt::AlignCenter, button.text);
+    }
+
+    painter->setPen(QColor("#d0d0d0"));
+    painter->drawText(labelRect(option), Qt::AlignVCenter | Qt::AlignLeft, QString("График %1:").arg(index.row() + 1));
+
+    // Поле названия выглядит как QLineEdit панели, пока строка не редактируется
+    const QRectF field = QRectF(nameRect(option)).adjusted(0.5, 0.5, -0.5, -0.5);
+    painter->setPen(QColor("#606060"));
+    painter->setBrush(QColor("#505050"));
+    painter->drawRoundedRect(field, 3, 3);
+    painter->setPen(QColor("#ffffff"));
+    const QString name = option.fontMetrics.elidedText(index.data(SeriesListModel::NameRole).toString(),
+                                                       Qt::ElideRight, qMax(0, static_cast<int>(field.width()) - 8));
+    painter->drawText(field.adjusted(4, 0, -4, 0), Qt::AlignVCenter | Qt::AlignLeft, name);
+
+    painter->restore();
+}
+
+QSize SeriesDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex&) const
+{
+    return QSize(2 * buttonWidth + option.fontMetrics.horizontalAdvance("График 00000:") + 100, rowHeight);
+}
+
+QWidget* SeriesDelegate::createEditor(QWidget* parent, const QStyleOptionViewItem&, const QModelIndex&) const
+{
+    QLineEdit* editor = new QLineEdit(parent);
+    // Название на графике меняется по мере ввода, как было с постоянным полем
+    connect(editor, &QLineEdit::textEdited, this, [this, editor]() {
+        emit const_cast<SeriesDelegate*>(this)->commitData(editor);
+    });
+    return editor;
+}
+
+void SeriesDelegate::setEditorData(QWidget* editor, const QModelIndex& index) const
+{
+    if (QLineEdit* edit = qobject_cast<QLineEdit*>(editor)) {
+        if (!edit->isModified()) edit->setText(index.data(SeriesListModel::NameRole).toString());
+    }
+}
+
+void SeriesDelegate::setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const
+{
+    if (QLineEdit* edit = qobject_cast<QLineEdit*>(editor)) {
+        model->setData(index, edit->text(), SeriesListModel::NameRole);
+    }
+}
+
+void SeriesDelegate::updateEditorGeometry(QWidget* editor, const QStyleOptionViewItem& option, const QModelIndex&) const
+{
+    editor->setGeometry(nameRect(option));
+}
+
+bool SeriesDelegate::editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option,
+                                 const QModelIndex& index)
+{
+    const QEvent::Type type = event->type();
+    if (type != QEvent::MouseButtonPress && type != QEvent::MouseButtonRelease && type != QEvent::MouseButtonDblClick) {
+        return QStyledItemDelegate::editorEvent(event, model, option, index);
+    }
+
+    const QPoint pos = static_cast<QMouseEvent*>(event)->position().toPoint();
+    for (bool isMax : {false, true}) {
+        if (!buttonRect(option, isMax).contains(pos)) continue;
+
+        // Нажатие на кнопку не выделяет строку и не открывает редактор
+        if (type == QEvent::MouseButtonRelease && index.data(SeriesListModel::HasDataRole).toBool()) {
+            const int role = isMax ? SeriesListModel::ShowMaxRole : SeriesListModel::ShowMinRole;
+            model->setData(index, !index.data(role).toBool(), role);
+        }
+        return true;
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
@@ -0,0 +1,37 @@
+#ifndef SERIESDELEGATE_H
+#define SERIESDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QLineEdit>
+#include <QPainter>
+#include <QMouseEvent>
+
+#include "seriesListModel.h"
+
+// Строка панели настроек рядов: кнопки MIN/MAX, подпись и название. Кнопки рисуются,
+// а не создаются виджетами; поле ввода появляется только у редактируемой строки.
+class SeriesDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    explicit SeriesDelegate(QObject* parent = nullptr) : QStyledItemDelegate(parent) {}
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    void setEditorData(QWidget* editor, const QModelIndex& index) const override;
+    void setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const override;
+    void updateEditorGeometry(QWidget* editor, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+protected:
+    bool editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option,
+                     const QModelIndex& index) override;
+
+private:
+    static QRect buttonRect(const QStyleOptionViewItem& option, bool isMax);
+    static QRect labelRect(const QStyleOptionViewItem& option);
+    static QRect nameRect(const QStyleOptionViewItem& option);
+};
+
+#endif // SERIESDELEGATE_H
@@ -0,0 +1,105 @@
+#include "seriesListModel.h"
+
+int SeriesListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_entries.size());
+}
+
+QVariant SeriesListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size()) return QVariant();
+
+    const Entry& entry = m_entries[index.row()];
+    switch (role) {
+    case Qt::DisplayRole: return QString("Ряд %1").arg(index.row() + 1); // Подпись в выборе ряда для расчёта
+    case Qt::EditRole:
+    case NameRole: return entry.name;
+    case ShowMinRole: return entry.showMin;
+    case ShowMaxRole: return entry.showMax;
+    case HasDataRole: return entry.hasData;
+    default: return QVariant();
+    }
+}
+
+bool SeriesListModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (!index.isValid() || index.row() >= m_entries.size()) return false;
+
+    Entry& entry = m_entries[index.row()];
+    switch (role) {
+    case Qt::EditRole:
+    case NameRole:
+        if (entry.name == value.toString()) return true;
+        entry.name = value.toString();
+        emit dataChanged(index, index, {NameRole});
+        return true;
+    case ShowMinRole:
+    case ShowMaxRole: {
+        if (!entry.hasData) return false; // Кнопки пустого ряда заблокированы
+        bool& flag = role == ShowMinRole ? entry.showMin : entry.showMax;
+        if (flag == value.toBool()) return true;
+        flag = value.toBool();
+        emit dataChanged(index, index, {role});
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+Qt::ItemFlags SeriesListModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
+}
+
+void SeriesListModel::insertSeries(int first, int count)
+{
+    if (count <= 0) return;
+    first = qBound(0, first, rowCount());
+
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+    m_entries.insert(first, count, Entry{});
+    for (int row = first; row < first + count; ++row) {
+        m_entries[row].name = QString("График %1").arg(row + 1);
+    }
+    endInsertRows();
+}
+
+void SeriesListModel::removeSeries(int first, int count)
+{
+    if (first < 0 || first >= rowCount() || count <= 0) return;
+    count = qMin(count, rowCount() - first);
+
+    beginRemoveRows(QModelIndex(), first, first + count - 1);
+    m_entries.remove(first, count);
+    endRemoveRows();
+}
+
+QString SeriesListModel::name(int row) const
+{
+    return row >= 0 && row < m_entries.size() ? m_entries[row].name : QString();
+}
+
+void SeriesListModel::setNames(const QStringList& names)
+{
+    const int count = qMin(static_cast<int>(names.size()), rowCount());
+    if (count == 0) return;
+    for (int row = 0; row < count; ++row) {
+        m_entries[row].name = names[row];
+    }
+    emit dataChanged(index(0), index(count - 1), {NameRole});
+}
+
+bool SeriesListModel::showMarker(int row, bool isMax) const
+{
+    if (row < 0 || row >= m_entries.size()) return false;
+    return isMax ? m_entries[row].showMax : m_entries[row].showMin;
+}
+
+void SeriesListModel::setHasData(int row, bool hasData)
+{
+    if (row < 0 || row >= m_entries.size() || m_entries[row].hasData == hasData) return;
+    m_entries[row].hasData = hasData;
+    emit dataChanged(index(row), index(row), {HasDataRole});
+}
@@ -0,0 +1,47 @@
+#ifndef SERIESLISTMODEL_H
+#define SERIESLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QVector>
+
+// Настройки рядов таблицы: название и показ маркеров экстремумов. Одна модель питает
+// список в панели настроек и выбор ряда для расчёта, виджеты создаются только для видимых строк.
+class SeriesListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum Role {
+        NameRole = Qt::UserRole + 1, // Название ряда на графике
+        ShowMinRole,
+        ShowMaxRole,
+        HasDataRole                  // В ряду есть непустые ячейки: маркеры можно включить
+    };
+
+    explicit SeriesListModel(QObject* parent = nullptr) : QAbstractListModel(parent) {}
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    void insertSeries(int first, int count);
+    void removeSeries(int first, int count);
+
+    QString name(int row) const;
+    void setNames(const QStringList& names); // Первые names.size() рядов
+    bool showMarker(int row, bool isMax) const;
+    void setHasData(int row, bool hasData);  // Сигнал только при смене состояния
+
+private:
+    struct Entry {
+        QString name;
+        bool showMin = false;
+        bool showMax = false;
+        bool hasData = false;
+    };
+
+    QVector<Entry> m_entries;
+};
+
+#endif // SERIESLISTMODEL_H
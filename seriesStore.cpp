@@ -0,0 +1,153 @@
+#include "seriesStore.h"
+
+#include <algorithm>
+#include <limits>
+
+void SeriesStore::insertRows(int first, int count)
+{
+    if (count <= 0) return;
+    first = qBound(0, first, size());
+    m_series.insert(first, count, Series{});
+}
+
+void SeriesStore::removeRows(int first, int count)
+{
+    if (first < 0 || first >= size() || count <= 0) return;
+    m_series.remove(first, qMin(count, size() - first));
+}
+
+void SeriesStore::markDirty(int row)
+{
+    if (row >= 0 && row < size()) m_series[row].dirty = true;
+}
+
+void SeriesStore::markAllDirty()
+{
+    for (Series& series : m_series) series.dirty = true;
+}
+
+void SeriesStore::rescanExtremes(Series& series)
+{
+    series.minY = std::numeric_limits<double>::max();
+    series.maxY = std::numeric_limits<double>::lowest();
+    series.minColumn = -1;
+    series.maxColumn = -1;
+
+    // Строгое сравнение оставляет первый по порядку столбец среди равных значений
+    for (const QPointF& point : series.points) {
+        if (point.y() < series.minY) {
+            series.minY = point.y();
+            series.minColumn = static_cast<int>(point.x());
+        }
+        if (point.y() > series.maxY) {
+            series.maxY = point.y();
+            series.maxColumn = static_cast<int>(point.x());
+        }
+    }
+}
+
+void SeriesStore::parseRow(const QTableWidget* table, int row, Series& series)
+{
+    series.points.clear();
+    series.textColumns.clear();
+    for (int col = 0; col < table->columnCount(); ++col) {
+        if (const QTableWidgetItem* item = table->item(row, col)) {
+            const QString text = item->text();
+            bool ok;
+            const double value = text.toDouble(&ok);
+            if (ok) {
+                series.points.append(QPointF(col, value));
+            } else if (!text.isEmpty()) {
+                series.textColumns.insert(col);
+            }
+        }
+    }
+    rescanExtremes(series);
+    series.dirty = false;
+}
+
+void SeriesStore::setCell(int row, int column, const QString& text)
+{
+    if (row < 0 || row >= size()) return;
+    Series& series = m_series[row];
+    if (series.dirty) return; // Ряд всё равно будет перечитан целиком
+
+    bool ok;
+    const double value = text.toDouble(&ok);
+
+    if (ok || text.isEmpty()) {
+        series.textColumns.remove(column);
+    } else {
+        series.textColumns.insert(column);
+    }
+
+    auto it = std::lower_bound(series.points.begin(), series.points.end(), column,
+                               [](const QPointF& point, int col) { return point.x() < col; });
+    const bool existed = it != series.points.end() && static_cast<int>(it->x()) == column;
+    const double oldValue = existed ? it->y() : 0.0;
+
+    if (ok && existed) {
+        it->setY(value);
+    } else if (ok) {
+        series.points.insert(it, QPointF(column, value));
+    } else if (existed) {
+        series.points.erase(it);
+    }
+    series.changed = true;
+
+    // Экстремум ухудшился или исчез только если перезаписан сам экстремум: тогда нужен пересчёт
+    const bool minLost = existed && column == series.minColumn && (!ok || value > oldValue);
+    const bool maxLost = existed && column == series.maxColumn && (!ok || value < oldValue);
+    if (minLost || maxLost || series.points.isEmpty()) {
+        rescanExtremes(series);
+        return;
+    }
+    if (!ok) return;
+
+    if (value < series.minY || (value == series.minY && column < series.minColumn)) {
+        series.minY = value;
+        series.minColumn = column;
+    }
+    if (value > series.maxY || (value == series.maxY && column < series.maxColumn)) {
+        series.maxY = value;
+        series.maxColumn = column;
+    }
+}
+
+QList<int> SeriesStore::refresh(const QTableWidget* table)
+{
+    QList<int> changed;
+    const int rows = qMin(size(), table->rowCount());
+    for (int row = 0; row < rows; ++row) {
+        Series& series = m_series[row];
+        if (series.dirty) {
+            parseRow(table, row, series);
+        } else if (!series.changed) {
+            continue;
+        }
+        series.pyramid.build(series.points);
+        series.changed = false;
+        changed.append(row);
+    }
+    return changed;
+}
+
+bool SeriesStore::bounds(double& minX, double& maxX, double& minY, double& maxY) const
+{
+    minX = std::numeric_limits<double>::max();
+    maxX = std::numeric_limits<double>::lowest();
+    minY = std::numeric_limits<double>::max();
+    maxY = std::numeric_limits<double>::lowest();
+
+    bool found = false;
+    for (const Series& series : m_series) {
+        if (series.isEmpty()) continue;
+        // Точки упорядочены по столбцу: границы по X — первая и последняя точки
+        minX = std::min(minX, series.points.first().x());
+        maxX = std::max(maxX, series.points.last().x());
+        minY = std::min(minY, series.minY);
+        maxY = std::max(maxY, series.maxY);
+        found = true;
+    }
+    return found;
+}
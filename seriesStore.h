@@ -0,0 +1,57 @@
+#ifndef SERIESSTORE_H
+#define SERIESSTORE_H
+
+#include <QTableWidget>
+#include <QList>
+#include <QVector>
+#include <QPointF>
+#include <QSet>
+
+#include "decimation.h"
+
+// Числовые значения рядов таблицы. Ряд разбирается из ячеек только после изменения,
+// остальные ряды отдают уже готовые точки и границы без обращения к таблице.
+class SeriesStore
+{
+public:
+    struct Series {
+        QList<QPointF> points;  // (столбец, значение) числовых ячеек по возрастанию столбца
+        double minY = 0.0;
+        double maxY = 0.0;
+        int minColumn = -1;     // Первый столбец с минимумом, -1 для пустого ряда
+        int maxColumn = -1;
+        QSet<int> textColumns;  // Непустые ячейки, не разобранные как число
+        Decimation::MinMaxPyramid pyramid; // Для прореживания длинных рядов на графике
+        bool dirty = true;      // Ряд нужно перечитать из таблицы
+        bool changed = false;   // Точки обновлены по ячейке, но ещё не переданы графику
+
+        bool isEmpty() const { return points.isEmpty(); }
+        // Число непустых ячеек ряда без обращения к таблице
+        int occupiedCells() const { return static_cast<int>(points.size() + textColumns.size()); }
+    };
+
+    int size() const { return m_series.size(); }
+    const Series& series(int row) const { return m_series[row]; }
+
+    void insertRows(int first, int count);
+    void removeRows(int first, int count);
+    void markDirty(int row);
+    void markAllDirty();
+    // Одна изменённая ячейка: точка обновляется на месте, ряд перечитывается, только если
+    // перезаписан его текущий экстремум
+    void setCell(int row, int column, const QString& text);
+
+    // Перечитывает изменённые ряды из таблицы и возвращает номера всех рядов с новыми точками
+    QList<int> refresh(const QTableWidget* table);
+
+    // Границы по всем непустым рядам; false, если данных нет
+    bool bounds(double& minX, double& maxX, double& minY, double& maxY) const;
+
+private:
+    static void parseRow(const QTableWidget* table, int row, Series& series);
+    static void rescanExtremes(Series& series);
+
+    QVector<Series> m_series;
+};
+
+#endif // SERIESSTORE_H
@@ -0,0 +1,110 @@
+#include "startup.h"
+
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QList>
+#include <QPair>
+#include <QTextStream>
+#include <QTimer>
+#include <QWindow>
+
+#include <utility>
+
+namespace Startup
+{
+    namespace {
+        QElapsedTimer clock;
+        qint64 lastMark = 0;
+        qint64 firstFrame = 0; // Время от запуска до первого кадра, нс
+        bool profiling = false;
+        bool deferred = false;
+        QList<QPair<QString, qint64>> phases; // Название фазы и её длительность, нс
+        QList<std::function<void()>> pending; // Отложено до первого кадра
+
+        double toMs(qint64 nsecs) { return nsecs / 1e6; }
+
+        void report()
+        {
+            if (!profiling) return;
+            QTextStream err(stderr);
+            err << "Запуск" << (deferred ? " (отложенная инициализация)" : "") << ":" << Qt::endl;
+            for (const auto& [phase, nsecs] : phases) {
+                err << "  " << phase << ": " << QString::number(toMs(nsecs), 'f', 1) << " мс" << Qt::endl;
+            }
+            // Отложенная работа идёт после кадра и в это время не входит
+            err << "  Итого до первого кадра: " << QString::number(toMs(firstFrame), 'f', 1) << " мс" << Qt::endl;
+        }
+
+        // Первый Expose окна: кадр рисуется при его обработке, поэтому отметка ставится на следующем проходе цикла
+        class FirstFrameWatcher : public QObject
+        {
+        public:
+            using QObject::QObject;
+
+            bool eventFilter(QObject* watched, QEvent* event) override
+            {
+                if (event->type() == QEvent::Expose && !m_fired) {
+                    m_fired = true;
+                    QTimer::singleShot(0, this, [this]() {
+                        mark("Первый кадр");
+                        firstFrame = lastMark;
+                        const QList<std::function<void()>> callbacks = std::exchange(pending, {});
+                        for (const auto& callback : callbacks) {
+                            callback();
+                        }
+                        if (!callbacks.isEmpty()) mark("Отложенная инициализация");
+                        report();
+                        deleteLater();
+                    });
+                }
+                return QObject::eventFilter(watched, event);
+            }
+
+        private:
+            bool m_fired = false;
+        };
+    }
+
+    void start()
+    {
+        clock.start();
+        lastMark = 0;
+    }
+
+    void configure(const QStringList& arguments)
+    {
+        profiling = arguments.contains("--profile-startup");
+        deferred = arguments.contains("--deferred-init");
+        if (!clock.isValid()) start();
+        mark("QApplication");
+    }
+
+    bool isProfiling()
+    {
+        return profiling;
+    }
+
+    bool isDeferred()
+    {
+        return deferred;
+    }
+
+    void mark(const QString& phase)
+    {
+        if (!clock.isValid()) return;
+        const qint64 now = clock.nsecsElapsed();
+        phases.append({phase, now - lastMark});
+        lastMark = now;
+    }
+
+    void afterFirstFrame(std::function<void()> callback)
+    {
+        pending.append(std::move(callback));
+    }
+
+    void watchFirstFrame(QWidget* window)
+    {
+        if (!window || !window->windowHandle()) return;
+        window->windowHandle()->installEventFilter(new FirstFrameWatcher(window));
+    }
+}
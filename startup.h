@@ -0,0 +1,27 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <QStringList>
+#include <QWidget>
+
+#include <functional>
+
+// Запуск окна: замеры фаз до первого кадра и режим отложенной инициализации.
+// --profile-startup печатает длительности фаз в stderr после первой отрисовки окна;
+// --deferred-init строит график после первого кадра, а свёрнутые секции статистики — при раскрытии.
+namespace Startup
+{
+    void start();                                  // Первая строка main: отсчёт времени запуска
+    void configure(const QStringList& arguments);  // Сразу после создания QApplication
+    bool isProfiling();
+    bool isDeferred();
+
+    void mark(const QString& phase);               // Фаза закончилась: длительность с предыдущей отметки
+
+    // Работа, отложенная до первого кадра окна: выполняется по порядку после его отрисовки
+    void afterFirstFrame(std::function<void()> callback);
+    // После w.show(): ждёт первый кадр окна, выполняет отложенную работу и печатает сводку
+    void watchFirstFrame(QWidget* window);
+}
+
+#endif // STARTUP_H
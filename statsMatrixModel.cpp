@@ -0,0 +1,175 @@
+#include "statsMatrixModel.h"
+#include "metrics.h"
+#include "globals.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+int StatsMatrixModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_order.size());
+}
+
+int StatsMatrixModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : Metrics::count();
+}
+
+double StatsMatrixModel::value(int series, int column) const
+{
+    const std::vector<double>& values = m_entries[series].values;
+    return column < static_cast<int>(values.size()) ? values[column] : std::numeric_limits<double>::quiet_NaN();
+}
+
+QVariant StatsMatrixModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_order.size() || index.column() >= columnCount()) return QVariant();
+
+    const double v = value(m_order[index.row()], index.column());
+    switch (role) {
+    case Qt::DisplayRole: return std::isnan(v) ? na : Metrics::formatPanel(index.column(), v);
+    case Qt::TextAlignmentRole: return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+    case ValueRole: return v;
+    default: return QVariant();
+    }
+}
+
+QVariant StatsMatrixModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+    if (orientation == Qt::Horizontal) {
+        return section < columnCount() ? Metrics::registry()[section].title : QVariant();
+    }
+    // Номер ряда в таблице, а не строки после сортировки
+    return section < m_order.size() ? QString("Ряд %1").arg(m_order[section] + 1) : QVariant();
+}
+
+void StatsMatrixModel::sort(int column, Qt::SortOrder order)
+{
+    m_sortColumn = column < columnCount() ? column : -1;
+    m_sortOrder = order;
+    applyOrder();
+}
+
+void StatsMatrixModel::applyOrder()
+{
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    // Выделение в таблице остаётся на тех же рядах
+    const QModelIndexList from = persistentIndexList();
+    QVector<int> fromSeries;
+    for (const QModelIndex& index : from) {
+        fromSeries.append(m_order[index.row()]);
+    }
+
+    std::iota(m_order.begin(), m_order.end(), 0);
+    if (m_sortColumn >= 0) {
+        // Непосчитанные и неприменимые значения внизу при любом направлении
+        const bool ascending = m_sortOrder == Qt::AscendingOrder;
+        std::stable_sort(m_order.begin(), m_order.end(), [&](int lhs, int rhs) {
+            const double a = value(lhs, m_sortColumn);
+            const double b = value(rhs, m_sortColumn);
+            if (std::isnan(a) || std::isnan(b)) return !std::isnan(a) && std::isnan(b);
+            return ascending ? a < b : a > b;
+        });
+    }
+
+    QVector<int> rowOf(m_order.size());
+    for (int row = 0; row < m_order.size(); ++row) {
+        rowOf[m_order[row]] = row;
+    }
+    QModelIndexList to;
+    for (int i = 0; i < from.size(); ++i) {
+        to.append(index(rowOf[fromSeries[i]], from[i].column()));
+    }
+    changePersistentIndexList(from, to);
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void StatsMatrixModel::insertSeries(int first, int count)
+{
+    if (count <= 0) return;
+    first = qBound(0, first, static_cast<int>(m_entries.size()));
+
+    m_entries.insert(first, count, Entry{});
+    if (m_sortColumn < 0) {
+        beginInsertRows(QModelIndex(), first, first + count - 1);
+        m_order.resize(m_entries.size());
+        std::iota(m_order.begin(), m_order.end(), 0);
+        endInsertRows();
+    } else {
+        // Новые ряды ещё не посчитаны и при сортировке всё равно стоят внизу
+        for (int& series : m_order) {
+            if (series >= first) series += count;
+        }
+        beginInsertRows(QModelIndex(), rowCount(), rowCount() + count - 1);
+        for (int series = first; series < first + count; ++series) {
+            m_order.append(series);
+        }
+        endInsertRows();
+    }
+    if (rowCount() > count) emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
+}
+
+void StatsMatrixModel::removeSeries(int first, int count)
+{
+    if (first < 0 || first >= m_entries.size() || count <= 0) return;
+    count = qMin(count, static_cast<int>(m_entries.size()) - first);
+    const int last = first + count - 1;
+
+    // Снизу вверх: строки выше удаляемой не сдвигаются
+    for (int row = rowCount() - 1; row >= 0; --row) {
+        if (m_order[row] < first || m_order[row] > last) continue;
+        beginRemoveRows(QModelIndex(), row, row);
+        m_order.removeAt(row);
+        endRemoveRows();
+    }
+    m_entries.remove(first, count);
+    for (int& series : m_order) {
+        if (series > last) series -= count;
+    }
+    if (rowCount() > 0) {
+        emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
+        emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+    }
+}
+
+void StatsMatrixModel::markStale(const QList<int>& series)
+{
+    for (int s : series) {
+        if (s >= 0 && s < m_entries.size()) m_entries[s].stale = true;
+    }
+}
+
+QList<int> StatsMatrixModel::staleSeries() const
+{
+    QList<int> stale;
+    for (int s = 0; s < m_entries.size(); ++s) {
+        if (m_entries[s].stale) stale.append(s);
+    }
+    return stale;
+}
+
+void StatsMatrixModel::setValues(const QList<int>& series, std::vector<std::vector<double>>&& values)
+{
+    int firstRow = rowCount();
+    int lastRow = -1;
+    for (int i = 0; i < series.size() && i < static_cast<int>(values.size()); ++i) {
+        const int s = series[i];
+        if (s < 0 || s >= m_entries.size()) continue;
+        m_entries[s].values = std::move(values[i]);
+        m_entries[s].stale = false;
+        firstRow = qMin(firstRow, s);
+        lastRow = qMax(lastRow, s);
+    }
+    if (lastRow < 0) return;
+
+    if (m_sortColumn >= 0) {
+        applyOrder(); // Строки могли поменяться местами, вид перерисуется целиком
+    } else {
+        emit dataChanged(index(firstRow, 0), index(lastRow, columnCount() - 1));
+    }
+}
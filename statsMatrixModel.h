@@ -0,0 +1,53 @@
+#ifndef STATSMATRIXMODEL_H
+#define STATSMATRIXMODEL_H
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <QVector>
+
+#include <vector>
+
+// Метрики всех рядов таблицы сразу: строка — ряд, столбец — метрика реестра Metrics.
+// Значения хранятся числами по номеру ряда; сортировка переставляет только порядок строк,
+// а пересчитываются лишь ряды, отмеченные устаревшими.
+class StatsMatrixModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Role {
+        ValueRole = Qt::UserRole + 1 // Значение метрики числом, NaN — не посчитана или неприменима
+    };
+
+    explicit StatsMatrixModel(QObject* parent = nullptr) : QAbstractTableModel(parent) {}
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override; // column < 0 — порядок рядов таблицы
+
+    // Вслед за рядами SeriesStore; новые ряды устаревшие
+    void insertSeries(int first, int count);
+    void removeSeries(int first, int count);
+
+    void markStale(const QList<int>& series);
+    QList<int> staleSeries() const; // По возрастанию номера ряда
+    // Новые значения рядов: отметка снимается, порядок строк пересобирается по столбцу сортировки
+    void setValues(const QList<int>& series, std::vector<std::vector<double>>&& values);
+
+private:
+    struct Entry {
+        std::vector<double> values; // По индексу Metrics::registry(), пусто — ещё не посчитан
+        bool stale = true;
+    };
+
+    double value(int series, int column) const;
+    void applyOrder();
+
+    QVector<Entry> m_entries; // По номеру ряда
+    QVector<int> m_order;     // Строка модели -> номер ряда
+    int m_sortColumn = -1;
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
+};
+
+#endif // STATSMATRIXMODEL_H
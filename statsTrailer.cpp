@@ -0,0 +1,159 @@
+#include "statsTrailer.h"
+#include "calculate.h"
+#include "metrics.h"
+
+#include <algorithm>
+
+namespace StatsTrailer
+{
+    const QString sectionTitle = "# Статистика рядов";
+    const QString checksumTitle = "# Контрольная сумма";
+
+    SeriesRecord makeRecord(const std::vector<double>& values)
+    {
+        SeriesRecord record;
+        for (double v : values) {
+            record.moments.add(v);
+            record.sketch.add(v);
+        }
+        if (values.empty()) return record;
+
+        // Те же метрики и в том же порядке, что на панели; бросившая исключение сохраняется как NaN
+        record.metrics = Metrics::evaluate(values);
+        return record;
+    }
+
+    bool isSectionStart(const QString& line)
+    {
+        return line == QString("%1 %2").arg(sectionTitle).arg(formatVersion);
+    }
+
+    void writeInteger(BufferedWriter& out, qint64 value)
+    {
+        out.write(QByteArrayView(QByteArray::number(value)));
+    }
+
+    void writeSectionStart(BufferedWriter& out)
+    {
+        out.write(QString("%1 %2\n").arg(sectionTitle).arg(formatVersion));
+    }
+
+    void writeRecord(BufferedWriter& out, const SeriesRecord& record)
+    {
+        const Calculate::MomentAccumulator& m = record.moments;
+        writeInteger(out, record.row);
+        out.write(" | ", 3);
+
+        writeInteger(out, static_cast<qint64>(m.count));
+        for (double value : {m.mean, m.m2, m.m3, m.m4, m.sum, m.sumCompensation, m.logSum, m.reciprocalSum}) {
+            out.put(' ');
+            out.writeNumber(value);
+        }
+        out.write(m.allPositive ? " 1" : " 0", 2);
+        out.write(m.reciprocalSafe ? " 1" : " 0", 2);
+        for (double value : {m.min, m.max}) {
+            out.put(' ');
+            out.writeNumber(value);
+        }
+        out.write(" | ", 3);
+
+        for (size_t i = 0; i < record.metrics.size(); ++i) {
+            if (i > 0) out.put(' ');
+            out.writeNumber(record.metrics[i]);
+        }
+        out.write(" | ", 3);
+
+        // Скетч: число значений, ёмкость, число уровней, затем каждый уровень как <размер> <значения>
+        writeInteger(out, static_cast<qint64>(record.sketch.count()));
+        out.put(' ');
+        writeInteger(out, record.sketch.capacity());
+        out.put(' ');
+        writeInteger(out, static_cast<qint64>(record.sketch.levels().size()));
+        for (const std::vector<double>& level : record.sketch.levels()) {
+            out.put(' ');
+            writeInteger(out, static_cast<qint64>(level.size()));
+            for (double value : level) {
+                out.put(' ');
+                out.writeNumber(value);
+            }
+        }
+        out.put('\n');
+    }
+
+    void writeChecksum(BufferedWriter& out, quint64 checksum)
+    {
+        out.write(QString("%1 %2\n").arg(checksumTitle, QString::number(checksum, 16)));
+    }
+
+    bool parseRecord(const QString& line, SeriesRecord& record)
+    {
+        const QStringList parts = line.split(" | ");
+        if (parts.size() != 4) return false;
+
+        bool ok = false;
+        record.row = parts[0].toLongLong(&ok);
+        if (!ok) return false;
+
+        const QStringList moments = parts[1].split(' ', Qt::SkipEmptyParts);
+        if (moments.size() != 13) return false;
+        std::vector<double> numbers;
+        for (int i = 0; i < moments.size(); ++i) {
+            numbers.push_back(moments[i].toDouble(&ok));
+            if (!ok) return false;
+        }
+        Calculate::MomentAccumulator& m = record.moments;
+        m.count = static_cast<std::uint64_t>(numbers[0]);
+        m.mean = numbers[1];
+        m.m2 = numbers[2];
+        m.m3 = numbers[3];
+        m.m4 = numbers[4];
+        m.sum = numbers[5];
+        m.sumCompensation = numbers[6];
+        m.logSum = numbers[7];
+        m.reciprocalSum = numbers[8];
+        m.allPositive = numbers[9] != 0.0;
+        m.reciprocalSafe = numbers[10] != 0.0;
+        m.min = numbers[11];
+        m.max = numbers[12];
+
+        const QStringList metrics = parts[2].split(' ', Qt::SkipEmptyParts);
+        if (metrics.size() != metricCount) return false;
+        record.metrics.clear();
+        for (const QString& token : metrics) {
+            record.metrics.push_back(token.toDouble(&ok));
+            if (!ok) return false;
+        }
+
+        const QStringList sketch = parts[3].split(' ', Qt::SkipEmptyParts);
+        if (sketch.size() < 3) return false;
+        const std::uint64_t sketchCount = sketch[0].toULongLong(&ok);
+        if (!ok) return false;
+        const int capacity = sketch[1].toInt(&ok);
+        if (!ok || capacity <= 0) return false;
+        const int levelCount = sketch[2].toInt(&ok);
+        if (!ok || levelCount < 0) return false;
+
+        std::vector<std::vector<double>> levels(static_cast<size_t>(levelCount));
+        qsizetype position = 3;
+        for (std::vector<double>& level : levels) {
+            if (position >= sketch.size()) return false;
+            const qsizetype size = sketch[position++].toLongLong(&ok);
+            if (!ok || size < 0 || position + size > sketch.size()) return false;
+            for (qsizetype i = 0; i < size; ++i) {
+                level.push_back(sketch[position++].toDouble(&ok));
+                if (!ok) return false;
+            }
+        }
+        record.sketch = Calculate::QuantileSketch(capacity);
+        record.sketch.restore(sketchCount, std::move(levels));
+        return position == sketch.size();
+    }
+
+    bool parseChecksum(const QString& line, quint64& checksum)
+    {
+        if (!line.startsWith(checksumTitle)) return false;
+        bool ok = false;
+        checksum = line.mid(checksumTitle.size()).trimmed().toULongLong(&ok, 16);
+        return ok;
+    }
+}
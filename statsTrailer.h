@@ -0,0 +1,59 @@
+#ifndef STATSTRAILER_H
+#define STATSTRAILER_H
+
+#include <QString>
+#include <QList>
+
+#include <vector>
+
+#include "accumulators.h"
+#include "bufferedWriter.h"
+
+// Машиночитаемый трейлер экспорта: точные достаточные статистики каждого ряда
+// и контрольная сумма блока данных. Если сумма сходится, импорт берёт метрики отсюда.
+//
+//   # Статистика рядов 1
+//   <ряд> | <n mean m2 m3 m4 sum sumc logsum recsum pos safe min max> | <21 метрика> | <n k> | <уровень 0> | ...
+//   # Контрольная сумма <FNV-1a 64, hex>
+namespace StatsTrailer
+{
+    constexpr int formatVersion = 1;
+    constexpr int metricCount = 21; // Порядок и число совпадают с Metrics::registry()
+
+    // FNV-1a 64 по байтам блока данных; '\r' не учитывается, чтобы сумма не зависела от перевода строк
+    class Checksum
+    {
+    public:
+        void update(const char* data, qsizetype size)
+        {
+            for (qsizetype i = 0; i < size; ++i) {
+                if (data[i] == '\r') continue;
+                m_hash ^= static_cast<unsigned char>(data[i]);
+                m_hash *= 1099511628211ULL;
+            }
+        }
+        quint64 value() const { return m_hash; }
+
+    private:
+        quint64 m_hash = 14695981039346656037ULL;
+    };
+
+    struct SeriesRecord {
+        qint64 row = 0;                       // Номер ряда среди записанных строк данных
+        Calculate::MomentAccumulator moments;
+        Calculate::QuantileSketch sketch;
+        std::vector<double> metrics;          // Значения метрик панели полной точности
+    };
+
+    SeriesRecord makeRecord(const std::vector<double>& values);
+
+    bool isSectionStart(const QString& line);
+    // Раздел пишется по частям, чтобы записи не держать в памяти: заголовок, записи рядов, сумма
+    void writeSectionStart(BufferedWriter& out);
+    void writeRecord(BufferedWriter& out, const SeriesRecord& record);
+    void writeChecksum(BufferedWriter& out, quint64 checksum);
+    bool parseRecord(const QString& line, SeriesRecord& record);
+    bool parseChecksum(const QString& line, quint64& checksum); // false, если строка не контрольная сумма
+}
+
+#endif // STATSTRAILER_H
@@ -4,6 +4,6 @@
 #include <vector>
 #include <utility>
 
-using TableData = std::vector<std::vector<std::pair<int, int>>>;
+using TableData = std::vector<std::vector<std::pair<int, double>>>;
 
 #endif // STRUCTS_H
@@ -0,0 +1,158 @@
+#include "summary.h"
+#include "export.h"
+#include "compression.h"
+
+#include <vector>
+
+namespace Summary
+{
+    MetricList Result::joinedMetrics() const
+    {
+        MetricList joined;
+        if (seriesMetrics.isEmpty()) return joined;
+
+        for (int i = 0; i < seriesMetrics.first().size(); ++i) {
+            QStringList values;
+            for (const MetricList& metrics : seriesMetrics) {
+                values << metrics[i].second;
+            }
+            joined.append({seriesMetrics.first()[i].first, values.join(", ")});
+        }
+        return joined;
+    }
+
+    StreamParser::StreamParser(std::function<void(const Calculate::SeriesSummary&)> onSeries)
+        : m_onSeries(std::move(onSeries))
+    {
+    }
+
+    void StreamParser::feed(const char* data, qint64 size)
+    {
+        for (qint64 i = 0; i < size; ++i) {
+            const char c = data[i];
+
+            if (m_inTrailer) {
+                if (c == '\n') processTrailerLine();
+                else m_trailerLine.append(c);
+                continue;
+            }
+
+            if (c == '\n') {
+                endToken();
+                endLine();
+            } else if (FastParse::isSeparator(c)) {
+                endToken();
+                if (c == ',' || c == ';') m_lineHasContent = true;
+            } else {
+                m_lineHasContent = true;
+                if (m_tokenLength < maxTokenLength) m_token[m_tokenLength++] = c;
+                else m_tokenTooLong = true;
+            }
+        }
+    }
+
+    void StreamParser::finish()
+    {
+        if (m_inTrailer) {
+            if (!m_trailerLine.isEmpty()) processTrailerLine();
+        } else if (m_lineHasContent) {
+            endToken();
+            endLine();
+        }
+    }
+
+    void StreamParser::endToken()
+    {
+        if (m_tokenLength == 0) return;
+
+        const char* first = m_token;
+        const char* last = m_token + m_tokenLength;
+        m_tokenLength = 0;
+
+        for (const char* p = first; p != last; ++p) {
+            if (FastParse::isLetter(*p)) {
+                m_lineInvalid = true;
+                return;
+            }
+        }
+        const int column = m_column++;
+        if (FastParse::isGap(first, last)) return;
+
+        // Ячейка существует, даже если не является числом: так же, как в таблице
+        m_lineHasCells = true;
+        double value;
+        if (!m_tokenTooLong && FastParse::toDouble(first, last, value)) {
+            m_summary.add(value);
+            if (m_onValue) m_onValue(column, value);
+        }
+        m_tokenTooLong = false;
+    }
+
+    void StreamParser::endLine()
+    {
+        m_lineNumber++;
+
+        if (!m_lineHasContent) {
+            if (++m_emptyLineCounter >= stopLines) m_inTrailer = true;
+        } else {
+            m_emptyLineCounter = 0;
+            if (m_lineInvalid) {
+                m_invalidLines.append(m_lineNumber);
+            } else if (m_lineHasCells && m_invalidLines.isEmpty()) {
+                m_onSeries(m_summary);
+            }
+        }
+
+        m_summary.clear();
+        m_column = 0;
+        m_lineHasContent = false;
+        m_lineHasCells = false;
+        m_lineInvalid = false;
+    }
+
+    void StreamParser::processTrailerLine()
+    {
+        const QString line = QString::fromUtf8(m_trailerLine).trimmed();
+        m_trailerLine.clear();
+
+        if (m_expectHeaders) {
+            m_seriesHeaders = line.split(", ", Qt::SkipEmptyParts);
+            m_expectHeaders = false;
+        } else if (line.startsWith("# Заголовки рядов")) {
+            m_expectHeaders = true;
+        }
+    }
+
+    bool feedParser(QIODevice& input, StreamParser& parser,
+                    const std::function<bool()>& isCanceled,
+                    const std::function<void()>& onChunk)
+    {
+        std::vector<char> buffer(1 << 20);
+        while (!input.atEnd()) {
+            if (isCanceled && isCanceled()) return false;
+
+            const qint64 n = input.read(buffer.data(), static_cast<qint64>(buffer.size()));
+            if (n <= 0) break;
+            parser.feed(buffer.data(), n);
+            if (onChunk) onChunk();
+        }
+        // Оборванный или повреждённый файл не выдаётся за полный
+        if (Compression::hasReadError(input)) return false;
+        parser.finish();
+        return true;
+    }
+
+    bool summarize(QIODevice& input, Result& result,
+                   const std::function<bool()>& isCanceled,
+                   const std::function<void()>& onChunk)
+    {
+        StreamParser parser([&result](const Calculate::SeriesSummary& summary) {
+            result.seriesMetrics.append(Export::summaryMetrics(summary));
+        });
+        if (!feedParser(input, parser, isCanceled, onChunk)) return false;
+
+        result.seriesHeaders = parser.seriesHeaders();
+        result.invalidLines = parser.invalidLines();
+        return true;
+    }
+}
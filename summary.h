@@ -0,0 +1,87 @@
+#ifndef SUMMARY_H
+#define SUMMARY_H
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+
+#include <functional>
+
+#include "accumulators.h"
+#include "fastParse.h"
+
+// Сводка по файлу без загрузки таблицы: файл читается блоками, каждая строка (ряд)
+// сразу проходит через SeriesSummary, в памяти остаются только строки метрик.
+namespace Summary
+{
+    using MetricList = QList<QPair<QString, QString>>;
+
+    struct Result {
+        QList<MetricList> seriesMetrics; // По одному списку на ряд
+        QStringList seriesHeaders;
+        QList<int> invalidLines;
+
+        MetricList joinedMetrics() const; // В формате трейлера экспорта: "v1, v2, ..."
+    };
+
+    class StreamParser
+    {
+    public:
+        explicit StreamParser(std::function<void(const Calculate::SeriesSummary&)> onSeries);
+
+        // Необязательно: каждое число строки с номером его столбца, до вызова onSeries этой строки
+        void setValueCallback(std::function<void(int column, double value)> onValue) { m_onValue = std::move(onValue); }
+
+        void feed(const char* data, qint64 size);
+        void finish();
+
+        const QStringList& seriesHeaders() const { return m_seriesHeaders; }
+        const QList<int>& invalidLines() const { return m_invalidLines; }
+
+    private:
+        void endToken();
+        void endLine();
+        void processTrailerLine();
+
+        static constexpr int maxTokenLength = 64;
+        static constexpr int stopLines = 3; // Пустых строк до конца блока данных
+
+        std::function<void(const Calculate::SeriesSummary&)> m_onSeries;
+        std::function<void(int, double)> m_onValue;
+        Calculate::SeriesSummary m_summary;
+
+        char m_token[maxTokenLength];
+        int m_tokenLength = 0;
+        int m_column = 0; // Номер токена в строке, как столбец таблицы
+        bool m_tokenTooLong = false;
+
+        bool m_inTrailer = false;
+        bool m_expectHeaders = false;
+        QByteArray m_trailerLine;
+
+        int m_lineNumber = 0;
+        int m_emptyLineCounter = 0;
+        bool m_lineHasContent = false;
+        bool m_lineHasCells = false;
+        bool m_lineInvalid = false;
+
+        QStringList m_seriesHeaders;
+        QList<int> m_invalidLines;
+    };
+
+    // Прогоняет устройство через парсер блоками; false, если чтение прервано через isCanceled
+    // или ошибкой устройства (Compression::hasReadError)
+    bool feedParser(QIODevice& input, StreamParser& parser,
+                    const std::function<bool()>& isCanceled = {},
+                    const std::function<void()>& onChunk = {});
+
+    // false, если чтение прервано через isCanceled или ошибкой устройства
+    bool summarize(QIODevice& input, Result& result,
+                   const std::function<bool()>& isCanceled = {},
+                   const std::function<void()>& onChunk = {});
+}
+
+#endif // SUMMARY_H
@@ -0,0 +1,80 @@
+#include "tableWeights.h"
+
+#include <QtDebug>
+
+#include <cmath>
+
+namespace TableWeights
+{
+    std::vector<double> getWeights(const QTableWidget *table, int weightColumn)
+    {
+        std::vector<double> weights;
+        if (!table || weightColumn >= table->columnCount() || weightColumn < 0)
+            return weights;
+
+        for (int row = 0; row < table->rowCount(); ++row)
+        {
+            QTableWidgetItem *item = table->item(row, weightColumn);
+            if (item && !item->text().isEmpty())
+            {
+                bool ok;
+                double weight = item->text().toDouble(&ok);
+                if (ok && weight >= 0 && std::isfinite(weight))
+                {
+                    weights.push_back(weight);
+                }
+                else
+                {
+                    qWarning() << "Invalid weight found in row" << row << "column" << weightColumn;
+                    return std::vector<double>();
+                }
+            }
+            else
+            {
+                qWarning() << "Empty weight cell found in row" << row << "column" << weightColumn;
+                return std::vector<double>();
+            }
+        }
+        return weights;
+    }
+
+    std::vector<double> findWeights(const QTableWidget *table)
+    {
+        const int colCount = table->columnCount();
+
+        for (int col = 0; col < colCount; ++col)
+        {
+            std::vector<double> candidateWeights;
+            bool validColumn = true;
+
+            for (int row = 0; row < table->rowCount(); ++row)
+            {
+                QTableWidgetItem *item = table->item(row, col);
+                if (!item || item->text().isEmpty())
+                {
+                    validColumn = false;
+                    break;
+                }
+
+                bool ok;
+                const double value = item->text().toDouble(&ok);
+                if (!ok || value < 0)
+                {
+                    validColumn = false;
+                    break;
+                }
+
+                candidateWeights.push_back(value);
+            }
+
+            if (validColumn && !candidateWeights.empty())
+            {
+                qDebug() << "Found weights in column" << col;
+                return candidateWeights;
+            }
+        }
+
+        qDebug() << "No valid weights column found. Using uniform weights.";
+        return std::vector<double>(table->rowCount(), 1.0);
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef TABLEWEIGHTS_H
+#define TABLEWEIGHTS_H
+
+#include <QTableWidget>
+
+#include <vector>
+
+// Веса для Calculate::weightedMean из ячеек таблицы. Лежат отдельно от statcore:
+// библиотеке расчётов не нужны виджеты
+namespace TableWeights
+{
+    std::vector<double> getWeights(const QTableWidget* table, int weightColumn = 1);
+    std::vector<double> findWeights(const QTableWidget* table); // Автоматический поиск столбца с весами
+}
+
+#endif // TABLEWEIGHTS_H
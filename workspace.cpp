@@ -0,0 +1,299 @@
+#include "workspace.h"
+#include "mainwindow.h"
+
+#include <QSaveFile>
+#include <QDataStream>
+#include <QSignalBlocker>
+
+#include <cstring>
+#include <algorithm>
+
+namespace Workspace
+{
+    namespace
+    {
+        constexpr qint64 headerSize = 64;
+
+        qint64 alignTo8(qint64 value)
+        {
+            return (value + 7) & ~qint64(7);
+        }
+
+        void writePadding(QDataStream& out, qint64 written)
+        {
+            static const char zeros[8] = {};
+            out.writeRawData(zeros, static_cast<int>(alignTo8(written) - written));
+        }
+
+        QByteArray encodeStrings(const WorkspaceData& data)
+        {
+            QByteArray block;
+            QDataStream out(&block, QIODevice::WriteOnly);
+            out.setByteOrder(QDataStream::LittleEndian);
+
+            auto writeString = [&out](const QString& text) {
+                const QByteArray utf8 = text.toUtf8();
+                out << static_cast<quint32>(utf8.size());
+                out.writeRawData(utf8.constData(), utf8.size());
+            };
+
+            writeString(data.xAxisTitle);
+            writeString(data.yAxisTitle);
+            for (size_t i = 0; i < data.series.size(); ++i) {
+                writeString(i < static_cast<size_t>(data.seriesHeaders.size()) ? data.seriesHeaders[i] : QString());
+            }
+            return block;
+        }
+
+        double readDouble(const uchar* source)
+        {
+            const quint64 bits = qFromLittleEndian<quint64>(source);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        bool fail(QString* error, const QString& message)
+        {
+            if (error) *error = message;
+            return false;
+        }
+    }
+
+    bool isWorkspaceFile(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) return false;
+        return file.read(sizeof(magic)) == QByteArray(magic, sizeof(magic));
+    }
+
+    bool save(const QString& path, const WorkspaceData& data, QString* error)
+    {
+        const quint32 seriesCount = static_cast<quint32>(data.series.size());
+        const quint32 columnCount = static_cast<quint32>(qMax(0, data.columnCount));
+        const quint32 bitmapWords = (columnCount + 63) / 64;
+
+        const QByteArray strings = encodeStrings(data);
+        const qint64 valuesOffset = alignTo8(headerSize + strings.size());
+        const qint64 bitmapOffset = valuesOffset + qint64(seriesCount) * columnCount * sizeof(double);
+        const qint64 fileSize = bitmapOffset + qint64(seriesCount) * bitmapWords * sizeof(quint64);
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly))
+            return fail(error, "Не удалось открыть файл для записи.");
+
+        QDataStream out(&file);
+        out.setByteOrder(QDataStream::LittleEndian);
+        out.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+        // Заголовок
+        out.writeRawData(magic, sizeof(magic));
+        out << formatVersion
+            << quint32(0) // Флаги
+            << seriesCount << columnCount << bitmapWords
+            << quint64(headerSize) << quint64(valuesOffset) << quint64(bitmapOffset)
+            << quint64(0) // Смещение блока статистик
+            << quint64(fileSize);
+
+        out.writeRawData(strings.constData(), strings.size());
+        writePadding(out, headerSize + strings.size());
+
+        // Значения: ряды подряд, каждый ровно columnCount ячеек
+        std::vector<double> padded(columnCount);
+        for (const auto& series : data.series) {
+            std::fill(padded.begin(), padded.end(), std::numeric_limits<double>::quiet_NaN());
+            std::copy_n(series.begin(), std::min<size_t>(series.size(), columnCount), padded.begin());
+
+            if constexpr (Q_BYTE_ORDER == Q_LITTLE_ENDIAN) {
+                out.writeRawData(reinterpret_cast<const char*>(padded.data()),
+                                 static_cast<int>(padded.size() * sizeof(double)));
+            } else {
+                for (double v : padded) out << v;
+            }
+        }
+
+        // Маски заполненности
+        std::vector<quint64> bitmap(bitmapWords);
+        for (const auto& series : data.series) {
+            std::fill(bitmap.begin(), bitmap.end(), 0);
+            for (size_t col = 0; col < std::min<size_t>(series.size(), columnCount); ++col) {
+                if (!std::isnan(series[col])) bitmap[col / 64] |= quint64(1) << (col % 64);
+            }
+            for (quint64 word : bitmap) out << word;
+        }
+
+        if (out.status() != QDataStream::Ok || !file.commit())
+            return fail(error, "Ошибка записи файла!");
+        return true;
+    }
+
+    bool MappedWorkspace::open(const QString& path, QString* error)
+    {
+        close();
+        m_file = std::make_unique<QFile>(path);
+        if (!m_file->open(QIODevice::ReadOnly))
+            return fail(error, "Не удалось открыть файл.");
+
+        const qint64 size = m_file->size();
+        if (size < headerSize)
+            return fail(error, "Файл рабочего пространства повреждён.");
+
+        m_base = m_file->map(0, size);
+        if (!m_base)
+            return fail(error, "Не удалось отобразить файл в память.");
+
+        auto u32 = [this](qint64 offset) { return qFromLittleEndian<quint32>(m_base + offset); };
+        auto u64 = [this](qint64 offset) { return qFromLittleEndian<quint64>(m_base + offset); };
+
+        if (std::memcmp(m_base, magic, sizeof(magic)) != 0)
+            return fail(error, "Файл не является рабочим пространством.");
+        if (u32(4) > formatVersion)
+            return fail(error, "Файл создан более новой версией программы.");
+
+        m_seriesCount = u32(12);
+        m_columnCount = u32(16);
+        m_bitmapWords = u32(20);
+        const quint64 stringsOffset = u64(24);
+        m_valuesOffset = u64(32);
+        m_bitmapOffset = u64(40);
+
+        // Каждый блок проверяется по размеру файла до умножения, чтобы произведения не переполнялись
+        const quint64 fileSize = quint64(size);
+        const quint64 cells = quint64(m_seriesCount) * m_columnCount;
+        const bool consistent = u64(56) == fileSize
+            && m_bitmapWords == (m_columnCount + 63) / 64
+            && stringsOffset >= quint64(headerSize) && stringsOffset <= m_valuesOffset
+            && m_valuesOffset % 8 == 0 && m_valuesOffset <= fileSize
+            && cells <= (fileSize - m_valuesOffset) / sizeof(double)
+            && m_bitmapOffset == m_valuesOffset + cells * sizeof(double)
+            && quint64(m_seriesCount) * m_bitmapWords <= (fileSize - m_bitmapOffset) / sizeof(quint64);
+        if (!consistent)
+            return fail(error, "Файл рабочего пространства повреждён.");
+
+        // Строковый блок
+        quint64 offset = stringsOffset;
+        auto readString = [&](QString& target) {
+            if (offset + 4 > m_valuesOffset) return false;
+            const quint32 length = u32(offset);
+            offset += 4;
+            if (offset + length > m_valuesOffset) return false;
+            target = QString::fromUtf8(reinterpret_cast<const char*>(m_base + offset), length);
+            offset += length;
+            return true;
+        };
+
+        bool stringsOk = readString(m_xAxisTitle) && readString(m_yAxisTitle);
+        for (quint32 i = 0; stringsOk && i < m_seriesCount; ++i) {
+            QString header;
+            stringsOk = readString(header);
+            m_seriesHeaders << header;
+        }
+        if (!stringsOk)
+            return fail(error, "Файл рабочего пространства повреждён.");
+
+        if constexpr (Q_BYTE_ORDER != Q_LITTLE_ENDIAN) {
+            m_swapped.resize(cells);
+            for (quint64 i = 0; i < cells; ++i) {
+                m_swapped[i] = readDouble(m_base + m_valuesOffset + i * sizeof(double));
+            }
+        }
+        return true;
+    }
+
+    void MappedWorkspace::close()
+    {
+        if (m_file && m_base) m_file->unmap(const_cast<uchar*>(m_base));
+        m_file.reset();
+        m_base = nullptr;
+        m_swapped.clear();
+        m_seriesCount = m_columnCount = m_bitmapWords = 0;
+        m_seriesHeaders.clear();
+    }
+
+    const double* MappedWorkspace::values(int series) const
+    {
+        if (!m_swapped.empty())
+            return m_swapped.data() + quint64(series) * m_columnCount;
+        return reinterpret_cast<const double*>(m_base + m_valuesOffset) + quint64(series) * m_columnCount;
+    }
+
+    bool MappedWorkspace::isValid(int series, int column) const
+    {
+        const uchar* words = m_base + m_bitmapOffset + quint64(series) * m_bitmapWords * sizeof(quint64);
+        const quint64 word = qFromLittleEndian<quint64>(words + (column / 64) * sizeof(quint64));
+        return word & (quint64(1) << (column % 64));
+    }
+
+    std::vector<double> MappedWorkspace::seriesValues(int series) const
+    {
+        std::vector<double> result;
+        const double* row = values(series);
+        for (int col = 0; col < columnCount(); ++col) {
+            if (isValid(series, col)) result.push_back(row[col]);
+        }
+        return result;
+    }
+
+    WorkspaceData collectFromTable(const QTableWidget* table)
+    {
+        WorkspaceData data;
+        collectRows(table, 0, table->rowCount(), data);
+        collectTitles(table, data);
+        return data;
+    }
+
+    void collectRows(const QTableWidget* table, int firstRow, int lastRow, WorkspaceData& data)
+    {
+        for (int row = firstRow; row < qMin(lastRow, table->rowCount()); ++row) {
+            std::vector<double> values(table->columnCount(), std::numeric_limits<double>::quiet_NaN());
+            for (int col = 0; col < table->columnCount(); ++col) {
+                if (auto* item = table->item(row, col); item && !item->text().isEmpty()) {
+                    bool ok;
+                    const double value = item->text().toDouble(&ok);
+                    if (ok) {
+                        values[col] = value;
+                        data.columnCount = qMax(data.columnCount, col + 1);
+                    }
+                }
+            }
+            data.series.push_back(std::move(values));
+        }
+    }
+
+    void collectTitles(const QTableWidget* table, WorkspaceData& data)
+    {
+        if (const MainWindow* mainWindow = qobject_cast<const MainWindow*>(table->window())) {
+            data.seriesHeaders = mainWindow->getSeriesHeaders();
+            data.xAxisTitle = mainWindow->xAxisTitle();
+            data.yAxisTitle = mainWindow->yAxisTitle();
+        }
+    }
+
+    void loadIntoTable(QTableWidget* table, const MappedWorkspace& workspace)
+    {
+        table->clearContents();
+        table->setRowCount(qMax(workspace.seriesCount(), 1));
+        table->setColumnCount(qMax(workspace.columnCount(), 1));
+
+        {
+            // Ячейки заполняются без сигналов модели, статистика пересчитывается один раз после загрузки
+            const QSignalBlocker blocker(table->model());
+            for (int row = 0; row < workspace.seriesCount(); ++row) {
+                const double* values = workspace.values(row);
+                for (int col = 0; col < workspace.columnCount(); ++col) {
+                    if (workspace.isValid(row, col)) {
+                        // Без экспоненты: буква e в ячейке не дала бы импортировать экспорт таблицы
+                        const QString text = QString::number(values[col], 'f', QLocale::FloatingPointShortest);
+                        table->setItem(row, col, new QTableWidgetItem(text));
+                    }
+                }
+            }
+        }
+        table->viewport()->update();
+
+        if (MainWindow* mainWindow = qobject_cast<MainWindow*>(table->window())) {
+            mainWindow->setSeriesHeaders(workspace.seriesHeaders());
+            mainWindow->setAxisTitles(workspace.xAxisTitle(), workspace.yAxisTitle());
+        }
+    }
+}
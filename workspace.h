@@ -0,0 +1,80 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+#include <QTableWidget>
+
+#include <memory>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+// Двоичный формат рабочего пространства (.glws), все числа little-endian:
+//   Header                        — сигнатура, версия, размеры и смещения блоков
+//   строки (UTF-8, длина quint32) — названия осей и заголовки рядов
+//   значения                      — seriesCount * columnCount double, ряд за рядом (NaN = пусто)
+//   битовая маска                 — на каждый ряд bitmapWords quint64, бит = ячейка заполнена
+// Блоки выровнены по 8 байт, поэтому отображённый в память файл читается без копирования.
+// Флаги и смещение блока статистик в заголовке зарезервированы: блок статистик из ранних файлов
+// пропускается, метрики всегда считаются по самим значениям.
+namespace Workspace
+{
+    constexpr char fileSuffix[] = "glws";
+    constexpr char magic[4] = {'G', 'L', 'W', 'S'};
+    constexpr quint32 formatVersion = 1;
+
+    // Данные для сохранения; пустые ячейки хранятся как NaN
+    struct WorkspaceData {
+        QString xAxisTitle;
+        QString yAxisTitle;
+        QStringList seriesHeaders;
+        int columnCount = 0;
+        std::vector<std::vector<double>> series;
+    };
+
+    class MappedWorkspace
+    {
+    public:
+        bool open(const QString& path, QString* error = nullptr);
+        void close();
+
+        int seriesCount() const { return static_cast<int>(m_seriesCount); }
+        int columnCount() const { return static_cast<int>(m_columnCount); }
+        const double* values(int series) const;     // columnCount значений ряда прямо из отображения
+        bool isValid(int series, int column) const;
+        std::vector<double> seriesValues(int series) const; // Только заполненные ячейки
+
+        QString xAxisTitle() const { return m_xAxisTitle; }
+        QString yAxisTitle() const { return m_yAxisTitle; }
+        QStringList seriesHeaders() const { return m_seriesHeaders; }
+
+    private:
+        std::unique_ptr<QFile> m_file;
+        const uchar* m_base = nullptr;
+        std::vector<double> m_swapped; // Копия значений для big-endian платформ
+        quint32 m_seriesCount = 0;
+        quint32 m_columnCount = 0;
+        quint32 m_bitmapWords = 0;
+        quint64 m_valuesOffset = 0;
+        quint64 m_bitmapOffset = 0;
+        QString m_xAxisTitle;
+        QString m_yAxisTitle;
+        QStringList m_seriesHeaders;
+    };
+
+    bool isWorkspaceFile(const QString& path);
+    bool save(const QString& path, const WorkspaceData& data, QString* error = nullptr);
+    WorkspaceData collectFromTable(const QTableWidget* table);
+    // По частям, для снимка таблицы короткими порциями: заголовки и ряды [firstRow, lastRow)
+    void collectTitles(const QTableWidget* table, WorkspaceData& data);
+    void collectRows(const QTableWidget* table, int firstRow, int lastRow, WorkspaceData& data);
+    // Основная таблица хранит ячейки как элементы QTableWidget и заполняется целиком;
+    // без копирования рабочее пространство открывается через WorkspaceTableModel
+    void loadIntoTable(QTableWidget* table, const MappedWorkspace& workspace);
+}
+
+#endif // WORKSPACE_H
@@ -0,0 +1,63 @@
+#include "workspaceTableModel.h"
+
+#include <QLocale>
+
+bool WorkspaceTableModel::open(const QString& path, QString* error)
+{
+    beginResetModel();
+    const bool opened = m_workspace.open(path, error);
+    if (!opened) m_workspace.close();
+    m_path = opened ? path : QString();
+    endResetModel();
+    return opened;
+}
+
+int WorkspaceTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_workspace.seriesCount();
+}
+
+int WorkspaceTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_workspace.columnCount();
+}
+
+QVariant WorkspaceTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole)) return QVariant();
+    if (!m_workspace.isValid(index.row(), index.column())) return QVariant();
+
+    const double value = m_workspace.values(index.row())[index.column()];
+    return QString::number(value, 'f', QLocale::FloatingPointShortest); // Как ячейки loadIntoTable
+}
+
+QVariant WorkspaceTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+    return orientation == Qt::Vertical ? seriesName(section) : QString::number(section + 1);
+}
+
+QString WorkspaceTableModel::seriesName(int row) const
+{
+    const QStringList headers = m_workspace.seriesHeaders();
+    return row < headers.size() && !headers[row].isEmpty() ? headers[row] : QString("Ряд %1").arg(row + 1);
+}
+
+bool WorkspaceTableModel::summarizeRow(const QString& path, int row, Calculate::SeriesSummary& summary,
+                                       const std::function<bool(double)>& proceed)
+{
+    Workspace::MappedWorkspace workspace;
+    if (!workspace.open(path) || row < 0 || row >= workspace.seriesCount()) return false;
+
+    summary.clear();
+    const double* values = workspace.values(row);
+    const int columns = workspace.columnCount();
+    constexpr int step = 1 << 20;
+    for (int first = 0; first < columns; first += step) {
+        for (int col = first; col < qMin(columns, first + step); ++col) {
+            if (workspace.isValid(row, col)) summary.add(values[col]);
+        }
+        if (proceed && !proceed(static_cast<double>(qMin(columns, first + step)) / columns)) return false;
+    }
+    return true;
+}
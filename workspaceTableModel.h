@@ -0,0 +1,39 @@
+#ifndef WORKSPACETABLEMODEL_H
+#define WORKSPACETABLEMODEL_H
+
+#include <QAbstractTableModel>
+
+#include <functional>
+
+#include "workspace.h"
+#include "accumulators.h"
+
+// Модель таблицы прямо над отображённым в память рабочим пространством: ячейки не копируются
+// и не разбираются, текст числа строится только для видимых ячеек.
+class WorkspaceTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit WorkspaceTableModel(QObject* parent = nullptr) : QAbstractTableModel(parent) {}
+
+    bool open(const QString& path, QString* error = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    QString seriesName(int row) const;
+    QString path() const { return m_path; }
+
+    // Сводка ряда по собственному отображению файла: безопасна в любом потоке, модель не нужна.
+    // proceed(доля пройденного) вызывается по ходу, false прерывает расчёт
+    static bool summarizeRow(const QString& path, int row, Calculate::SeriesSummary& summary,
+                             const std::function<bool(double)>& proceed = {});
+
+private:
+    Workspace::MappedWorkspace m_workspace;
+    QString m_path;
+};
+
+#endif // WORKSPACETABLEMODEL_H